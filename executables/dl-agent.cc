@@ -87,6 +87,7 @@ int main( int argc, char** argv )
     the_main.add_config_multi_option< std::string >( "--values", "option_values", "Add ordered values" ); // stored in the config as "option-values" so they can be merged in later in the proper order
     the_main.add_config_option< unsigned >( "-t,--timeout", "timeout", "Set the timeout for waiting for a reply (seconds)" );
     the_main.add_config_option< std::string >( "-k,--lockout-key", "lockout_key", "Set the lockout key to send with the message (for sending requests only)" );
+    the_main.add_config_option< unsigned >( "--priority", "priority", "Set the priority of the message, 0-255 (for sending requests only)" );
     the_main.add_config_flag< bool >( "--suppress-output", "suppress_output", "Suppress the output of the returned reply" );
     the_main.add_config_flag< bool >( "--json-print", "json_print", "Output the returned reply in JSON; default is white-space suppressed (see --pretty-print)" );
     the_main.add_config_flag< bool >( "--pretty-print", "pretty_print", "Output the returned reply in nicely formatted JSON" );
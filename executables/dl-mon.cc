@@ -7,7 +7,7 @@
    @details
    Usage:
    ~~~~
-   $> dl-mon [options] [-r [request keys]] [-a [alert keys]]
+   $> dl-mon [options] [-r [request keys]] [-a [alert keys]] [--liveness]
    ~~~~
   
    Use `dl-mon -h` to get the full help information.
@@ -47,6 +47,10 @@ int main( int argc, char** argv )
         the_main.add_config_multi_option< std::string >( "-a,--alerts", "alert_keys", "Assign keys for binding to the alerts exchange" );
         the_main.add_config_flag< bool >( "--json-print", "json_print", "Output the returned reply in JSON; default is white-space suppressed (see --pretty-print)" );
         the_main.add_config_flag< bool >( "--pretty-print", "pretty_print", "Output the returned reply in nicely formatted JSON" );
+        the_main.add_config_flag< bool >( "--liveness", "liveness", "Keep track of the services on the mesh from their heartbeats, and print changes as they happen" );
+        the_main.add_config_option< unsigned >( "--liveness-interval-s", "liveness_interval_s", "Heartbeat interval (in s) assumed until a service has sent two heartbeats" );
+        the_main.add_config_option< unsigned >( "--liveness-down-after", "liveness_down_after", "Number of missed heartbeats after which a service is considered down" );
+        the_main.add_config_option< unsigned >( "--liveness-snapshot-s", "liveness_snapshot_s", "Print a snapshot of the services every N s; 0 (the default) prints snapshots only on SIGUSR1" );
     }
     catch( std::exception& e )
     {
@@ -72,9 +76,6 @@ int main( int argc, char** argv )
             scarab::signal_handler::cancel_all( RETURN_ERROR );
         }
 
-        // brief pause to ensure that the cancellation goes through
-        std::this_thread::sleep_for( std::chrono::milliseconds(100) );
-
         the_return = scarab::signal_handler::get_exited() ? 
                 scarab::signal_handler::get_return_code() : dl_success().rc_value() / 100;
     };
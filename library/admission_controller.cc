@@ -0,0 +1,93 @@
+/*
+ * admission_controller.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "admission_controller.hh"
+
+#include "logger.hh"
+#include "param.hh"
+
+#include <algorithm>
+
+namespace dripline
+{
+    LOGGER( dlog, "admission_controller" );
+
+    admission_controller::admission_controller( unsigned a_max_concurrent, double a_rate_limit, double a_burst ) :
+            f_max_concurrent( a_max_concurrent ),
+            f_rate_limit( std::max( a_rate_limit, 0. ) ),
+            f_burst( a_burst > 0. ? a_burst : std::max( f_rate_limit, 1. ) ),
+            f_slots( std::make_shared< slots >() ),
+            f_n_rejected( 0 ),
+            f_tokens( f_burst ),
+            f_last_refill( clock_t::now() )
+    {}
+
+    admission_controller::admission_controller( const scarab::param_node& a_config ) :
+            admission_controller( a_config.get_value( "max_concurrent", 0U ),
+                                  a_config.get_value( "rate_limit", 0. ),
+                                  a_config.get_value( "burst", 0. ) )
+    {}
+
+    admission_controller::permit admission_controller::try_admit( std::string& a_reason )
+    {
+        std::unique_lock< std::mutex > t_lock( f_slots->f_mutex );
+
+        if( f_max_concurrent > 0 && f_slots->f_in_flight >= f_max_concurrent )
+        {
+            ++f_n_rejected;
+            a_reason = "Too many requests in progress (limit: " + std::to_string( f_max_concurrent ) + "); retry later";
+            LDEBUG( dlog, a_reason );
+            return permit();
+        }
+
+        if( f_rate_limit > 0. )
+        {
+            clock_t::time_point t_now = clock_t::now();
+            double t_elapsed_s = std::chrono::duration< double >( t_now - f_last_refill ).count();
+            f_tokens = std::min( f_burst, f_tokens + t_elapsed_s * f_rate_limit );
+            f_last_refill = t_now;
+
+            if( f_tokens < 1. )
+            {
+                ++f_n_rejected;
+                a_reason = "Request rate limit exceeded (limit: " + std::to_string( f_rate_limit ) + " per s); retry later";
+                LDEBUG( dlog, a_reason );
+                return permit();
+            }
+            f_tokens -= 1.;
+        }
+
+        ++f_slots->f_in_flight;
+        return permit( f_slots );
+    }
+
+    unsigned admission_controller::in_flight() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_slots->f_mutex );
+        return f_slots->f_in_flight;
+    }
+
+    uint64_t admission_controller::n_rejected() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_slots->f_mutex );
+        return f_n_rejected;
+    }
+
+    void admission_controller::release( slots_ptr_t& a_slots )
+    {
+        if( ! a_slots ) return;
+        {
+            std::unique_lock< std::mutex > t_lock( a_slots->f_mutex );
+            if( a_slots->f_in_flight > 0 ) --a_slots->f_in_flight;
+        }
+        a_slots.reset();
+        return;
+    }
+
+} /* namespace dripline */
@@ -0,0 +1,137 @@
+/*
+ * admission_controller.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_ADMISSION_CONTROLLER_HH_
+#define DRIPLINE_ADMISSION_CONTROLLER_HH_
+
+#include "dripline_api.hh"
+
+#include "member_variables.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace scarab
+{
+    class param_node;
+}
+
+namespace dripline
+{
+
+    /*!
+     @class admission_controller
+     @author N.S. Oblath
+
+     @brief Limits the number of requests an endpoint handles at once and the rate at which it accepts them
+
+     @details
+     An endpoint with an admission_controller (see `endpoint::on_request_message()`) asks it for a @ref permit before
+     handling each request.  A request that is not admitted is answered right away with `dl_service_error_overloaded`,
+     so that the client can back off and retry, instead of waiting in the queue until it times out.
+     Control requests (see `endpoint::is_control_request()`) are always admitted.
+
+     Two limits can be used, separately or together:
+       * Concurrency: at most `max_concurrent` requests are in progress at once.  A request counts as in progress until
+         its permit is destroyed, which, for requests handled asynchronously, is when the reply is ready.  Permits share 
+         ownership of the count of requests in progress, so a permit can outlive the controller that issued it 
+         (e.g. if the endpoint's controller is replaced while asynchronous requests are still in progress).
+       * Rate: a token bucket that holds up to `burst` tokens and gains `rate_limit` tokens per second; each admitted
+         request uses one token.
+
+     A limit of 0 means that limit is not applied.  If `burst` is 0, it's set to the rate limit (and at least 1).
+
+     The configuration has the form:
+     ~~~
+     {
+         "max_concurrent": [n], // optional; default is 0
+         "rate_limit": [requests/s], // optional; default is 0
+         "burst": [n] // optional; default is 0
+     }
+     ~~~
+
+     All functions are thread-safe.
+    */
+    class DRIPLINE_API admission_controller
+    {
+        protected:
+            /// Count of requests in progress, shared with the permits
+            struct slots
+            {
+                std::mutex f_mutex;
+                unsigned f_in_flight = 0;
+            };
+            typedef std::shared_ptr< slots > slots_ptr_t;
+
+        public:
+            /// Holds a concurrency slot until it's destroyed; an empty permit means the request was not admitted
+            class permit
+            {
+                public:
+                    permit( slots_ptr_t a_slots = slots_ptr_t() ) : f_slots( std::move(a_slots) ) {}
+                    permit( const permit& ) = delete;
+                    permit( permit&& a_orig ) = default;
+                    ~permit() { admission_controller::release( f_slots ); }
+
+                    permit& operator=( const permit& ) = delete;
+                    permit& operator=( permit&& a_orig )
+                    {
+                        if( this != &a_orig )
+                        {
+                            admission_controller::release( f_slots );
+                            f_slots = std::move( a_orig.f_slots );
+                        }
+                        return *this;
+                    }
+
+                    explicit operator bool() const { return bool(f_slots); }
+
+                private:
+                    slots_ptr_t f_slots;
+            };
+
+        public:
+            admission_controller( unsigned a_max_concurrent = 0, double a_rate_limit = 0., double a_burst = 0. );
+            admission_controller( const scarab::param_node& a_config );
+            admission_controller( const admission_controller& ) = delete;
+            admission_controller( admission_controller&& ) = delete;
+            virtual ~admission_controller() = default;
+
+            admission_controller& operator=( const admission_controller& ) = delete;
+            admission_controller& operator=( admission_controller&& ) = delete;
+
+            /// Returns a permit if a request can be admitted now; otherwise returns an empty permit and gives the reason in a_reason
+            permit try_admit( std::string& a_reason );
+
+            /// Number of admitted requests whose permits still exist
+            unsigned in_flight() const;
+            /// Number of requests that have been rejected
+            uint64_t n_rejected() const;
+
+            mv_accessible_noset( unsigned, max_concurrent );
+            mv_accessible_noset( double, rate_limit );
+            mv_accessible_noset( double, burst );
+
+        protected:
+            /// Called by a permit when it's destroyed; releases the permit's slot, if it has one, and empties a_slots
+            static void release( slots_ptr_t& a_slots );
+
+            typedef std::chrono::steady_clock clock_t;
+
+            /// Also guards the rate-limit and rejection counters
+            slots_ptr_t f_slots;
+            uint64_t f_n_rejected;
+            double f_tokens;
+            clock_t::time_point f_last_refill;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_ADMISSION_CONTROLLER_HH_ */
@@ -45,6 +45,7 @@ namespace dripline
             f_routing_key(),
             f_specifier(),
             f_lockout_key( generate_nil_uuid() ),
+            f_priority( 0 ),
             f_return_code( dl_success().rc_value() ),
             f_return_message(),
             f_timeout( 0 ),
@@ -109,6 +110,9 @@ namespace dripline
             }
         }
 
+        f_agent->set_priority( t_config.get_value( "priority", f_agent->get_priority() ) );
+        t_config.erase( "priority" );
+
         if( t_config.has( "return" ) )
         {
             f_agent->set_return_code( t_config["return"].as_node().get_value( "code", dl_success().rc_value() ) );
@@ -173,6 +177,9 @@ namespace dripline
         // now all that remains in f_config should be values to pass to the server as arguments to the request
 
         t_request->lockout_key() = f_agent->lockout_key();
+        t_request->set_priority( f_agent->get_priority() );
+        // the request is of no use after the agent stops waiting for the reply
+        t_request->set_ttl_ms( f_agent->get_timeout() );
 
         LINFO( dlog, "Sending message w/ message_operation = " << t_request->get_message_operation() << " to " << t_request->routing_key() );
         LDEBUG( dlog, "Message headers:\n" << t_request->get_message_param( false ) );
@@ -57,6 +57,7 @@ namespace dripline
             }
          }
          "lockout_key" : "[uuid]",  // optional
+         "priority" : [0-255],  // optional; default is 0
          "save" : "[filename]"  // optional
          "load" : "[filename]"  // optional; only used for cmd
          "return" : { // used only for replies
@@ -216,6 +217,7 @@ namespace dripline
 
             // requests only
             mv_referrable( uuid_t, lockout_key );
+            mv_accessible( unsigned, priority );
 
             // alerts only
             mv_accessible( unsigned, return_code );
@@ -10,6 +10,7 @@
 #include "core.hh"
 
 #include "dripline_exceptions.hh"
+#include "local_delivery.hh"
 #include "message.hh"
 
 #include "authentication.hh"
@@ -18,7 +19,9 @@
 #include "param_codec.hh"
 #include "signal_handler.hh"
 
+#include <algorithm>
 #include <array>
+#include <thread>
 
 
 namespace dripline
@@ -48,6 +51,8 @@ namespace dripline
 
     bool core::s_offline = false;
 
+    const std::string core::s_wake_token_type( "dripline_wake" );
+
     core::core( const scarab::param_node& a_config, const scarab::authentication& a_auth, const bool a_make_connection ) :
             f_address(),
             f_port(),
@@ -58,7 +63,8 @@ namespace dripline
             f_heartbeat_routing_key(),
             f_max_payload_size(),
             f_make_connection(),
-            f_max_connection_attempts()
+            f_max_connection_attempts(),
+            f_local_delivery()
     {
         // Get the default values, and merge in the supplied a_config
         // a_config's default value is also dripline_config, but the user can supply an arbitrary node.
@@ -92,6 +98,7 @@ namespace dripline
         f_make_connection = t_config.get_value( "make_connection", a_make_connection );
         f_max_payload_size = t_config["max_payload_size"]().as_uint(); //.get_value("max_payload_size", DL_MAX_PAYLOAD_SIZE);
         f_max_connection_attempts = t_config["max_connection_attempts"]().as_uint(); //.get_value("max_connection_attempts", 10);
+        f_local_delivery = t_config.get_value( "local_delivery", false );
 
         f_username = a_auth.get("dripline", "username", "guest");
         f_password = a_auth.get("dripline", "password", "guest");
@@ -152,17 +159,45 @@ namespace dripline
     sent_msg_pkg_ptr core::send( request_ptr_t a_request, amqp_channel_ptr a_channel ) const
     {
         LDEBUG( dlog, "Sending request with routing key <" << a_request->routing_key() << ">" );
+        // in-process delivery doesn't need the broker
+        if( f_local_delivery )
+        {
+            a_request->stamp_deadline();
+            sent_msg_pkg_ptr t_local_pkg = local_delivery::get_instance()->deliver_request( a_request );
+            if( t_local_pkg ) return t_local_pkg;
+        }
         if ( ! f_make_connection || core::s_offline )
         {
             throw a_request;
             //throw dripline_error() << "cannot send reply when make_connection is false";
         }
+        a_request->stamp_deadline();
         return do_send( std::static_pointer_cast< message >( a_request ), f_requests_exchange, true, a_channel );
     }
 
+    std::vector< sent_msg_pkg_ptr > core::send_requests( const std::vector< request_ptr_t >& a_requests ) const
+    {
+        std::vector< sent_msg_pkg_ptr > t_sent_pkgs;
+        t_sent_pkgs.reserve( a_requests.size() );
+        amqp_channel_ptr t_channel;
+        for( const request_ptr_t& t_request : a_requests )
+        {
+            // the first send opens the channel, and the rest use it
+            t_sent_pkgs.push_back( send( t_request, t_channel ) );
+            if( ! t_channel ) t_channel = t_sent_pkgs.back()->f_channel;
+        }
+        return t_sent_pkgs;
+    }
+
     sent_msg_pkg_ptr core::send( reply_ptr_t a_reply, amqp_channel_ptr a_channel ) const
     {
         LDEBUG( dlog, "Sending reply with routing key <" << a_reply->routing_key() << ">" );
+        if( local_delivery::get_instance()->deliver_reply( a_reply ) )
+        {
+            sent_msg_pkg_ptr t_local_pkg = std::make_shared< sent_msg_pkg >();
+            t_local_pkg->f_successful_send = true;
+            return t_local_pkg;
+        }
         if ( ! f_make_connection || core::s_offline )
         {
             throw a_reply;
@@ -174,6 +209,8 @@ namespace dripline
     sent_msg_pkg_ptr core::send( alert_ptr_t a_alert, amqp_channel_ptr a_channel ) const
     {
         LDEBUG( dlog, "Sending alert with routing key <" << a_alert->routing_key() << ">" );
+        // alerts still go through the broker, for subscribers in other processes; local subscribers drop that copy
+        if( f_local_delivery ) local_delivery::get_instance()->deliver_alert( a_alert );
         if ( ! f_make_connection || core::s_offline )
         {
             throw a_alert;
@@ -226,6 +263,18 @@ namespace dripline
             LDEBUG( dlog, "Consumer tag for reply: " << t_receive_reply->f_consumer_tag );
         }
 
+        t_receive_reply->f_successful_send = publish_message( a_message, a_exchange, t_channel, t_receive_reply->f_send_error_message );
+
+        return t_receive_reply;
+    }
+
+    bool core::publish_message( message_ptr_t a_message, const std::string& a_exchange, amqp_channel_ptr a_channel, std::string& a_error_message ) const
+    {
+        // lambda to create a string with the basic information about the send attempt
+        auto t_diagnostic_string_maker = [a_message, this]() -> std::string {
+            return std::string("Broker: ") + f_address +"\nPort: " + std::to_string(f_port) + "\nRouting Key: " + a_message->routing_key();
+        };
+
         // convert the dripline::message object to an AMQP message
         amqp_split_message_ptrs t_amqp_messages = a_message->create_amqp_messages( f_max_payload_size );
         if( t_amqp_messages.empty() )
@@ -241,11 +290,11 @@ namespace dripline
                 // send the message
                 // the first boolean argument is whether it's mandatory that the message be delivered to a queue.
                 // this is only the case for requests, where we expect something to be listening.
-                t_channel->BasicPublish( a_exchange, a_message->routing_key(), t_amqp_message, a_message->is_request(), false );
+                a_channel->BasicPublish( a_exchange, a_message->routing_key(), t_amqp_message, a_message->is_request(), false );
             }
             LDEBUG( dlog, "Message sent in " << t_amqp_messages.size() << " chunks" );
-            t_receive_reply->f_successful_send = true;
-            t_receive_reply->f_send_error_message.clear();
+            a_error_message.clear();
+            return true;
         }
         catch( AmqpClient::ConnectionClosedException& e )
         {
@@ -255,23 +304,19 @@ namespace dripline
         catch( AmqpClient::AmqpLibraryException& e )
         {
             LERROR( dlog, "AMQP error while sending message: " << e.what() );
-            t_receive_reply->f_successful_send = false;
-            t_receive_reply->f_send_error_message = std::string("AMQP error while sending message: ") + std::string(e.what()) + '\n' + t_diagnostic_string_maker();
+            a_error_message = std::string("AMQP error while sending message: ") + std::string(e.what()) + '\n' + t_diagnostic_string_maker();
         }
         catch( AmqpClient::MessageReturnedException& e )
         {
             LERROR( dlog, "Message was returned: " << e.what() );
-            t_receive_reply->f_successful_send = false;
-            t_receive_reply->f_send_error_message = std::string("Message was returned: ") + std::string(e.what()) + '\n' + t_diagnostic_string_maker();
+            a_error_message = std::string("Message was returned: ") + std::string(e.what()) + '\n' + t_diagnostic_string_maker();
         }
         catch( std::exception& e )
         {
             LERROR( dlog, "Error while sending message: " << e.what() );
-            t_receive_reply->f_successful_send = false;
-            t_receive_reply->f_send_error_message = std::string("Error while sending message: ") + std::string(e.what()) + '\n' + t_diagnostic_string_maker();
+            a_error_message = std::string("Error while sending message: ") + std::string(e.what()) + '\n' + t_diagnostic_string_maker();
         }
-
-        return t_receive_reply;
+        return false;
     }
 
     amqp_channel_ptr core::open_channel() const
@@ -357,6 +402,48 @@ namespace dripline
         return t_ret_ptr;
     }
 
+    bool core::wake_queues( const std::vector< std::string >& a_queue_names ) const
+    {
+        if( ! f_make_connection || core::s_offline || a_queue_names.empty() ) return false;
+
+        // this is used while shutting down, so there are no retries as in open_channel()
+        struct AmqpClient::Channel::OpenOpts opts;
+        opts.host = f_address;
+        opts.port = f_port;
+        opts.auth = AmqpClient::Channel::OpenOpts::BasicAuth(f_username, f_password);
+
+        // connecting can take as long as the OS's TCP timeout if the broker is unreachable (which is often why things are being canceled),
+        // so the tokens are sent from a thread of their own that doesn't refer to this object
+        std::thread t_wake_thread( [opts, a_queue_names](){
+            try
+            {
+                amqp_channel_ptr t_channel = AmqpClient::Channel::Open( opts );
+                if( ! t_channel ) return;
+
+                for( const std::string& t_queue_name : a_queue_names )
+                {
+                    LDEBUG( dlog, "Waking listeners on queue <" << t_queue_name << ">" );
+                    amqp_message_ptr t_token = AmqpClient::BasicMessage::Create();
+                    t_token->Type( s_wake_token_type );
+                    // the default exchange delivers messages to the queue named by the routing key
+                    t_channel->BasicPublish( "", t_queue_name, t_token, false, false );
+                }
+            }
+            catch( std::exception& e )
+            {
+                LDEBUG( dlog, "Unable to send wake tokens: " << e.what() );
+            }
+        } );
+        t_wake_thread.detach();
+        return true;
+    }
+
+    bool core::is_wake_token( const amqp_envelope_ptr& a_envelope )
+    {
+        if( ! a_envelope || ! a_envelope->Message() ) return false;
+        return a_envelope->Message()->TypeIsSet() && a_envelope->Message()->Type() == s_wake_token_type;
+    }
+
     bool core::setup_exchange( amqp_channel_ptr a_channel, const std::string& a_exchange )
     {
         if( s_offline || ! a_channel )
@@ -382,7 +469,7 @@ namespace dripline
         }
     }
 
-    bool core::setup_queue( amqp_channel_ptr a_channel, const std::string& a_queue_name )
+    bool core::setup_queue( amqp_channel_ptr a_channel, const std::string& a_queue_name, unsigned a_max_priority )
     {
         if( s_offline || ! a_channel )
         {
@@ -391,8 +478,19 @@ namespace dripline
 
         try
         {
-            LDEBUG( dlog, "Declaring queue <" << a_queue_name << ">" );
-            a_channel->DeclareQueue( a_queue_name, false, false, true, true );
+            if( a_max_priority == 0 )
+            {
+                LDEBUG( dlog, "Declaring queue <" << a_queue_name << ">" );
+                a_channel->DeclareQueue( a_queue_name, false, false, true, true );
+                return true;
+            }
+
+            // RabbitMQ supports priorities from 1 to 255
+            a_max_priority = std::min( a_max_priority, 255U );
+            LDEBUG( dlog, "Declaring queue <" << a_queue_name << "> with maximum priority " << a_max_priority );
+            AmqpClient::Table t_arguments;
+            t_arguments.insert( AmqpClient::TableEntry( "x-max-priority", AmqpClient::TableValue( static_cast< int32_t >( a_max_priority ) ) ) );
+            a_channel->DeclareQueue( a_queue_name, false, false, true, true, t_arguments );
             return true;
         }
         catch( amqp_exception& e )
@@ -526,6 +624,12 @@ namespace dripline
     }
 
     void core::listen_for_message( amqp_envelope_ptr& a_envelope, core::post_listen_status& a_status, amqp_channel_ptr a_channel, const std::string& a_consumer_tag, int a_timeout_ms, bool a_do_ack )
+    {
+        listen_for_message( a_envelope, a_status, a_channel, std::vector< std::string >{ a_consumer_tag }, a_timeout_ms, a_do_ack );
+        return;
+    }
+
+    void core::listen_for_message( amqp_envelope_ptr& a_envelope, core::post_listen_status& a_status, amqp_channel_ptr a_channel, const std::vector< std::string >& a_consumer_tags, int a_timeout_ms, bool a_do_ack )
     {
         if( s_offline || ! a_channel )
         {
@@ -539,11 +643,11 @@ namespace dripline
             {
                 if( a_timeout_ms > 0 )
                 {
-                    a_channel->BasicConsumeMessage( a_consumer_tag, a_envelope, a_timeout_ms );
+                    a_channel->BasicConsumeMessage( a_consumer_tags, a_envelope, a_timeout_ms );
                 }
                 else
                 {
-                    a_envelope = a_channel->BasicConsumeMessage( a_consumer_tag );
+                    a_envelope = a_channel->BasicConsumeMessage( a_consumer_tags );
                 }
                 if( a_envelope )
                 {
@@ -12,8 +12,10 @@
 #include "message.hh"
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace scarab
 {
@@ -23,6 +25,8 @@ namespace scarab
 
 namespace dripline
 {
+    struct local_reply_box;
+
     /*!
      @class sent_msg_pkg
      @author N.S. Oblath
@@ -35,6 +39,8 @@ namespace dripline
      The result of act of sending the message is given by `f_successful_send` and `f_send_error_message`.
 
      Replies can be waited for and retried by passing the `sent_msg_pkg` to `receiver::wait_for_reply()`.
+
+     If the request was delivered in-process (see @ref local_delivery), there's no channel, and its replies arrive in `f_local_replies` instead.
     */
     struct DRIPLINE_API sent_msg_pkg
     {
@@ -43,6 +49,7 @@ namespace dripline
         std::string f_consumer_tag;
         bool f_successful_send;
         std::string f_send_error_message;
+        std::shared_ptr< local_reply_box > f_local_replies;
         ~sent_msg_pkg();
     };
 
@@ -76,6 +83,9 @@ namespace dripline
         public:
             static bool s_offline;
 
+            /// AMQP message type used for wake tokens
+            static const std::string s_wake_token_type;
+
             enum class post_listen_status
             {
                 unknown, ///< Initialized or unknown status
@@ -97,6 +107,7 @@ namespace dripline
                  - `make_connection` (bool; default: true) -- Flag for performing a dry run -- no connection to a broker is made; this parameter overrides the parameter in the constructor and is the preferred flag to use.
                  - `max_payload_size` (int; default: DL_MAX_PAYLOAD_SIZE) -- Maximum size of payloads, in bytes
                  - `max_connection_attempts` (int; default: 10) -- Maximum number of attempts that will be made to connect to the broker
+                 - `local_delivery` (bool; default: false) -- Flag for delivering requests to services in the same process directly, and alerts to local subscribers as well as the broker (see @ref local_delivery)
                  - `return_codes` (string or array of nodes; default: not present) -- Optional specification of additional return codes in the form of an array of nodes: `[{name: "<name>", value: <ret code>} <, ...>]`. 
                         If this is a string, it's treated as a file can be interpreted by the param system (e.g. YAML or JSON) using the previously-mentioned format
                @param a_auth Authentication object (type scarab::authentication); authentication specification should be processed, and the authentication data should include:
@@ -114,16 +125,24 @@ namespace dripline
             /// Sends a request message and returns a channel on which to listen for a reply.
             /// Default exchange is "requests"
             /// Caller can supply a channel; if one is not supplied, a new channel will be established
+            /// If the request has a TTL, its deadline is set (unless it was already set)
+            /// If `local_delivery` is enabled and the target service is in this process, the request is handed to it directly, and no channel is used
             virtual sent_msg_pkg_ptr send( request_ptr_t a_request, amqp_channel_ptr a_channel = amqp_channel_ptr() ) const;
 
+            /// Sends a set of request messages on a single channel, and returns the sent-message packages in the same order.
+            /// The replies can be waited for together with `receiver::wait_for_any()` or `receiver::wait_for_all()`.
+            std::vector< sent_msg_pkg_ptr > send_requests( const std::vector< request_ptr_t >& a_requests ) const;
+
             /// Sends a reply message
             /// Default exchange is "requests"
             /// Caller can supply a channel; if one is not supplied, a new channel will be established
+            /// Replies to requests that were delivered in-process are handed back directly
             virtual sent_msg_pkg_ptr send( reply_ptr_t a_reply, amqp_channel_ptr a_channel = amqp_channel_ptr() ) const;
 
             /// Sends an alert message
             /// Default exchange is "alerts"
             /// Caller can supply a channel; if one is not supplied, a new channel will be established
+            /// If `local_delivery` is enabled, the alert is also given to the local subscribers
             virtual sent_msg_pkg_ptr send( alert_ptr_t a_alert, amqp_channel_ptr a_channel = amqp_channel_ptr() ) const;
 
             mv_referrable( std::string, address );
@@ -141,11 +160,19 @@ namespace dripline
             mv_accessible( bool, make_connection );
             mv_accessible( unsigned, max_connection_attempts );
 
+            /// Flag for delivering messages in-process when possible (see @ref local_delivery)
+            mv_accessible( bool, local_delivery );
+
         protected:
             friend class receiver;
+            friend class reply_publisher;
 
             sent_msg_pkg_ptr do_send( message_ptr_t a_message, const std::string& a_exchange, bool a_expect_reply, amqp_channel_ptr a_channel = amqp_channel_ptr() ) const;
 
+            /// Converts a message to AMQP messages and publishes them on a channel on which the exchange has already been set up.
+            /// Returns false, with the reason in a_error_message, if publishing failed; throws connection_error if the connection is closed
+            bool publish_message( message_ptr_t a_message, const std::string& a_exchange, amqp_channel_ptr a_channel, std::string& a_error_message ) const;
+
             amqp_channel_ptr send_withreply( message_ptr_t a_message, std::string& a_reply_consumer_tag, const std::string& a_exchange ) const;
 
             bool send_noreply( message_ptr_t a_message, const std::string& a_exchange ) const;
@@ -154,7 +181,8 @@ namespace dripline
 
             static bool setup_exchange( amqp_channel_ptr a_channel, const std::string& a_exchange );
 
-            static bool setup_queue( amqp_channel_ptr a_channel, const std::string& a_queue_name );
+            /// Declares a queue; if a_max_priority is non-zero, the queue is declared with `x-max-priority` so that the broker delivers higher-priority messages first
+            static bool setup_queue( amqp_channel_ptr a_channel, const std::string& a_queue_name, unsigned a_max_priority = 0 );
 
             static bool bind_key( amqp_channel_ptr a_channel, const std::string& a_exchange, const std::string& a_queue_name, const std::string& a_routing_key );
 
@@ -164,9 +192,20 @@ namespace dripline
 
             static bool remove_queue( amqp_channel_ptr a_channel, const std::string& a_queue_name );
 
+            /// Publishes a wake token directly to each queue, so that listeners waiting on those queues return right away (e.g. once they've been canceled).
+            /// The tokens are sent from a detached thread, so this returns right away even if the broker can't be reached; only one attempt is made to connect.
+            /// Returns false if no tokens will be sent (e.g. there's no broker connection), in which case listeners return at their next timeout.
+            bool wake_queues( const std::vector< std::string >& a_queue_names ) const;
+
         public:
+            /// Returns true if the AMQP message is a wake token (see `wake_queues()`), which listeners should ignore
+            static bool is_wake_token( const amqp_envelope_ptr& a_envelope );
+
+
             /// listen for a single AMQP message
             static void listen_for_message( amqp_envelope_ptr& a_envelope, post_listen_status& a_status, amqp_channel_ptr a_channel, const std::string& a_consumer_tag, int a_timeout_ms = 0, bool a_do_ack = true );
+            /// listen for a single AMQP message from any of several consumers on the same channel
+            static void listen_for_message( amqp_envelope_ptr& a_envelope, post_listen_status& a_status, amqp_channel_ptr a_channel, const std::vector< std::string >& a_consumer_tags, int a_timeout_ms = 0, bool a_do_ack = true );
     };
 
 } /* namespace dripline */
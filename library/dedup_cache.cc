@@ -0,0 +1,94 @@
+/*
+ * dedup_cache.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "dedup_cache.hh"
+
+#include "message.hh"
+
+#include "logger.hh"
+
+namespace dripline
+{
+    LOGGER( dlog, "dedup_cache" );
+
+    dedup_cache::dedup_cache( unsigned a_window_ms, unsigned a_max_entries ) :
+            f_window_ms( a_window_ms ),
+            f_max_entries( a_max_entries ),
+            f_mutex(),
+            f_entries(),
+            f_order()
+    {}
+
+    reply_ptr_t dedup_cache::find( const std::string& a_message_id )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        auto t_entry_it = f_entries.find( a_message_id );
+        if( t_entry_it == f_entries.end() ) return reply_ptr_t();
+
+        if( t_entry_it->second.f_expiration < clock_t::now() )
+        {
+            // its item in the order list is left behind, and is discarded when it's pruned
+            f_entries.erase( t_entry_it );
+            return reply_ptr_t();
+        }
+        return t_entry_it->second.f_reply;
+    }
+
+    void dedup_cache::store( const std::string& a_message_id, reply_ptr_t a_reply )
+    {
+        if( a_message_id.empty() || ! a_reply || f_max_entries == 0 ) return;
+
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        clock_t::time_point t_now = clock_t::now();
+        clock_t::time_point t_expiration = t_now + std::chrono::milliseconds( f_window_ms );
+        // if the ID was already stored, its earlier item in the order list no longer matches the entry
+        f_entries.insert_or_assign( a_message_id, entry{ a_reply, t_expiration } );
+        f_order.push_back( order_entry{ a_message_id, t_expiration } );
+        prune( t_now );
+        return;
+    }
+
+    void dedup_cache::clear()
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        f_entries.clear();
+        f_order.clear();
+        return;
+    }
+
+    unsigned dedup_cache::size() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_entries.size();
+    }
+
+    void dedup_cache::prune( clock_t::time_point a_now )
+    {
+        // entries are stored in time order, so expired entries are at the front of the order list
+        while( ! f_order.empty() )
+        {
+            const order_entry& t_oldest = f_order.front();
+            auto t_entry_it = f_entries.find( t_oldest.f_message_id );
+            // a stale item (its entry was removed, or was stored again later) is discarded without touching the entry
+            bool t_is_current = t_entry_it != f_entries.end() && t_entry_it->second.f_expiration == t_oldest.f_expiration;
+            if( t_is_current && t_oldest.f_expiration >= a_now && f_entries.size() <= f_max_entries )
+            {
+                break;
+            }
+            if( t_is_current )
+            {
+                LTRACE( dlog, "Removing message <" << t_oldest.f_message_id << "> from the deduplication cache" );
+                f_entries.erase( t_entry_it );
+            }
+            f_order.pop_front();
+        }
+        return;
+    }
+
+} /* namespace dripline */
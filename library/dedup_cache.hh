@@ -0,0 +1,97 @@
+/*
+ * dedup_cache.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_DEDUP_CACHE_HH_
+#define DRIPLINE_DEDUP_CACHE_HH_
+
+#include "dripline_api.hh"
+#include "dripline_fwd.hh"
+
+#include "member_variables.hh"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace dripline
+{
+
+    /*!
+     @class dedup_cache
+     @author N.S. Oblath
+
+     @brief Stores the replies to recently-handled requests, keyed by message ID, so that duplicate requests are not handled twice
+
+     @details
+     A request can be delivered more than once: the broker redelivers unacknowledged messages after a reconnect, and
+     clients can resend a request after waiting for a reply times out.  Resending the same request object keeps its message ID.
+
+     An endpoint with a dedup_cache (see `endpoint::on_request_message()`) stores the reply to each `OP_SET` and `OP_CMD` request it handles.
+     When a request arrives with a message ID that's in the cache, the stored reply is returned instead of handling the request again.
+
+     Entries are kept for `window_ms`, and the cache holds at most `max_entries` replies; when it's full, the oldest entry is removed.
+
+     Note that a duplicate that arrives while the original request is still being handled will not be recognized.
+
+     All functions are thread-safe, so a single cache can be shared by a service and its children.
+    */
+    class DRIPLINE_API dedup_cache
+    {
+        public:
+            dedup_cache( unsigned a_window_ms = 60000, unsigned a_max_entries = 1000 );
+            dedup_cache( const dedup_cache& ) = delete;
+            dedup_cache( dedup_cache&& ) = delete;
+            virtual ~dedup_cache() = default;
+
+            dedup_cache& operator=( const dedup_cache& ) = delete;
+            dedup_cache& operator=( dedup_cache&& ) = delete;
+
+            /// Returns the stored reply for the given message ID; returns an empty pointer if there is none
+            reply_ptr_t find( const std::string& a_message_id );
+
+            /// Stores a reply for the given message ID
+            void store( const std::string& a_message_id, reply_ptr_t a_reply );
+
+            /// Removes all entries
+            void clear();
+
+            /// Current number of entries (including any that have expired but have not yet been removed)
+            unsigned size() const;
+
+            mv_accessible( unsigned, window_ms );
+            mv_accessible( unsigned, max_entries );
+
+        protected:
+            typedef std::chrono::steady_clock clock_t;
+
+            struct entry
+            {
+                reply_ptr_t f_reply;
+                clock_t::time_point f_expiration;
+            };
+
+            /// Removes expired entries and, if necessary, the oldest entries to get below max_entries; the mutex must be locked
+            void prune( clock_t::time_point a_now );
+
+            mutable std::mutex f_mutex;
+            std::unordered_map< std::string, entry > f_entries;
+            struct order_entry
+            {
+                std::string f_message_id;
+                /// Expiration time of the entry when it was stored; if the entry's expiration differs, the entry was removed or stored again since
+                clock_t::time_point f_expiration;
+            };
+
+            /// Message IDs in the order they were stored
+            std::deque< order_entry > f_order;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_DEDUP_CACHE_HH_ */
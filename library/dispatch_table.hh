@@ -0,0 +1,149 @@
+/*
+ * dispatch_table.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_DISPATCH_TABLE_HH_
+#define DRIPLINE_DISPATCH_TABLE_HH_
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dripline
+{
+
+    /*!
+     @class dispatch_table
+     @author N.S. Oblath
+
+     @brief Maps string keys to handlers, with lookup by `std::string_view`
+
+     @details
+     Entries are kept in a vector sorted by key, which is rebuilt when an entry is added or removed. That happens 
+     when handlers are registered, not while messages are handled.  `find()` is a binary search that takes a 
+     `std::string_view` (e.g. a specifier token), so a lookup does not allocate, and a missing key returns a null pointer 
+     instead of throwing.
+
+     Used by @ref hub for its request handlers.
+    */
+    template< typename T >
+    class dispatch_table
+    {
+        public:
+            typedef std::pair< std::string, T > entry_t;
+            typedef typename std::vector< entry_t >::const_iterator const_iterator;
+
+        public:
+            dispatch_table() = default;
+            dispatch_table( const dispatch_table& ) = default;
+            dispatch_table( dispatch_table&& ) = default;
+            ~dispatch_table() = default;
+
+            dispatch_table& operator=( const dispatch_table& ) = default;
+            dispatch_table& operator=( dispatch_table&& ) = default;
+
+            /// Adds an entry, or replaces the value if the key is already present; returns true if a new entry was added
+            bool insert_or_assign( const std::string& a_key, T a_value );
+            /// Removes an entry; returns false if the key was not present
+            bool erase( std::string_view a_key );
+            void clear();
+
+            /// Returns a pointer to the value for the key, or nullptr if the key is not present
+            const T* find( std::string_view a_key ) const;
+            T* find( std::string_view a_key );
+
+            unsigned size() const;
+            bool empty() const;
+
+            const_iterator begin() const;
+            const_iterator end() const;
+
+        private:
+            typedef typename std::vector< entry_t >::iterator iterator;
+            iterator lower_bound( std::string_view a_key );
+
+            std::vector< entry_t > f_entries;
+    };
+
+    template< typename T >
+    bool dispatch_table< T >::insert_or_assign( const std::string& a_key, T a_value )
+    {
+        iterator t_it = lower_bound( a_key );
+        if( t_it != f_entries.end() && t_it->first == a_key )
+        {
+            t_it->second = std::move(a_value);
+            return false;
+        }
+        f_entries.emplace( t_it, a_key, std::move(a_value) );
+        return true;
+    }
+
+    template< typename T >
+    bool dispatch_table< T >::erase( std::string_view a_key )
+    {
+        iterator t_it = lower_bound( a_key );
+        if( t_it == f_entries.end() || t_it->first != a_key ) return false;
+        f_entries.erase( t_it );
+        return true;
+    }
+
+    template< typename T >
+    void dispatch_table< T >::clear()
+    {
+        f_entries.clear();
+        return;
+    }
+
+    template< typename T >
+    const T* dispatch_table< T >::find( std::string_view a_key ) const
+    {
+        return const_cast< dispatch_table< T >* >( this )->find( a_key );
+    }
+
+    template< typename T >
+    T* dispatch_table< T >::find( std::string_view a_key )
+    {
+        iterator t_it = lower_bound( a_key );
+        if( t_it == f_entries.end() || t_it->first != a_key ) return nullptr;
+        return &t_it->second;
+    }
+
+    template< typename T >
+    unsigned dispatch_table< T >::size() const
+    {
+        return f_entries.size();
+    }
+
+    template< typename T >
+    bool dispatch_table< T >::empty() const
+    {
+        return f_entries.empty();
+    }
+
+    template< typename T >
+    typename dispatch_table< T >::const_iterator dispatch_table< T >::begin() const
+    {
+        return f_entries.begin();
+    }
+
+    template< typename T >
+    typename dispatch_table< T >::const_iterator dispatch_table< T >::end() const
+    {
+        return f_entries.end();
+    }
+
+    template< typename T >
+    typename dispatch_table< T >::iterator dispatch_table< T >::lower_bound( std::string_view a_key )
+    {
+        return std::lower_bound( f_entries.begin(), f_entries.end(), a_key,
+                []( const entry_t& a_entry, std::string_view a_key ){ return std::string_view( a_entry.first ) < a_key; } );
+    }
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_DISPATCH_TABLE_HH_ */
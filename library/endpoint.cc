@@ -9,7 +9,13 @@
 
 #include "endpoint.hh"
 
+#include "admission_controller.hh"
+#include "dedup_cache.hh"
 #include "dripline_exceptions.hh"
+#include "get_cache.hh"
+#include "get_coalescer.hh"
+#include "request_stats.hh"
+#include "reply_result.hh"
 #include "service.hh"
 #include "throw_reply.hh"
 
@@ -30,6 +36,12 @@ namespace dripline
     endpoint::endpoint( const std::string& a_name ) :
             f_name( a_name ),
             f_service( nullptr ),
+            f_expired_request_count( 0 ),
+            f_dedup_cache(),
+            f_get_cache(),
+            f_get_coalescer(),
+            f_admission_controller(),
+            f_request_stats(),
             f_lockout_tag(),
             f_lockout_key( generate_nil_uuid() )
     {
@@ -64,23 +76,62 @@ namespace dripline
 
     reply_ptr_t endpoint::on_request_message( const request_ptr_t a_request )
     {
+        // nobody is waiting for the reply to an expired request, so it's dropped without being handled
+        if( a_request->is_expired() )
+        {
+            ++f_expired_request_count;
+            LWARN( dlog, "Dropping expired request to <" << a_request->routing_key() << "> (specifier: <" << a_request->parsed_specifier().unparsed() << ">); "
+                    << f_expired_request_count << " expired request(s) dropped so far" );
+            return a_request->reply( dl_service_error_timeout(), "Request expired before it was handled" );
+        }
+
         // reply object to store whatever reply we end up with
         reply_ptr_t t_reply;
 
+        // future for the reply from the request handlers, which may complete after this function returns
+        reply_future t_future;
+
         // lambda to send the reply.  this local function is defined so we can send from within the catch block if needed before rethrowing.
         auto t_replier = [&t_reply, &a_request, this](){
-            // send the reply if the request had a reply-to
-            if( a_request->reply_to().empty() )
+            send_reply_or_log( a_request, t_reply );
+        };
+
+        // set and cmd requests are not necessarily idempotent, so duplicates get the stored reply instead of being handled again
+        bool t_use_dedup_cache = f_dedup_cache && ! a_request->message_id().empty() &&
+                ( a_request->get_message_operation() == op_t::set || a_request->get_message_operation() == op_t::cmd );
+        if( t_use_dedup_cache )
+        {
+            reply_ptr_t t_stored_reply = f_dedup_cache->find( a_request->message_id() );
+            if( t_stored_reply )
             {
-                LWARN( dlog, "Not sending reply (reply-to empty)\n" <<
-                            "    Return code: " << t_reply->get_return_code() << '\n' <<
-                            "    Return message: " << t_reply->return_message() << '\n' <<
-                            "    Payload:\n" << t_reply->payload() );
+                LINFO( dlog, "Request <" << a_request->message_id() << "> has already been handled; sending the stored reply" );
+                // the reply is recreated so that it goes to the reply-to of this copy of the request
+                t_reply = a_request->reply( t_stored_reply->get_return_code(), t_stored_reply->return_message(), t_stored_reply->get_payload_ptr()->clone() );
+                t_replier();
+                return t_reply;
             }
-            else
+        }
+
+        // requests over the endpoint's limits are turned away right away so that the client can back off; control requests are always admitted.
+        // the permit is shared so that, for a request handled asynchronously, it can be held until the reply is ready.
+        std::shared_ptr< admission_controller::permit > t_permit;
+        if( f_admission_controller && ! is_control_request( *a_request ) )
+        {
+            std::string t_reason;
+            t_permit = std::make_shared< admission_controller::permit >( f_admission_controller->try_admit( t_reason ) );
+            if( ! *t_permit )
             {
-                send_reply( t_reply );
+                LWARN( dlog, "Rejecting request to <" << a_request->routing_key() << ">: " << t_reason );
+                t_reply = a_request->reply( dl_service_error_overloaded(), t_reason );
+                t_replier();
+                return t_reply;
             }
+        }
+
+        // replies for requests that can't be handled are made directly rather than by throwing a throw_reply
+        auto t_error_reply = [&a_request]( reply_result&& a_result ){
+            LWARN( dlog, "Replying with: " << a_result.return_message() );
+            return a_request->reply( std::move(a_result) );
         };
 
         try
@@ -94,39 +145,44 @@ namespace dripline
                     const scarab::param_node& t_payload = a_request->payload().as_node();
                     if( t_payload.has("error") ) t_message += "; " + t_payload["error"]().as_string();
                 }
-                throw throw_reply( dl_service_error_decoding_fail{}, a_request->get_payload_ptr()->clone() ) << "Request message was not valid";
+                t_reply = t_error_reply( reply_result( dl_service_error_decoding_fail{}, t_message, a_request->get_payload_ptr()->clone() ) );
             }
-
             // the lockout key must be valid
-            if( ! a_request->get_lockout_key_valid() )
+            else if( ! a_request->get_lockout_key_valid() )
             {
-                throw throw_reply( dl_service_error_invalid_key{} ) << "Lockout key could not be parsed";
+                t_reply = t_error_reply( reply_result( dl_service_error_invalid_key{}, "Lockout key could not be parsed" ) );
             }
-
-            switch( a_request->get_message_operation() )
+            else switch( a_request->get_message_operation() )
             {
                 case op_t::get:
                 {
-                    t_reply =  __do_get_request( a_request );
+                    t_future =  __do_get_request( a_request );
                     break;
                 } // end "get" operation
                 case op_t::set:
                 {
-                    t_reply =  __do_set_request( a_request );
+                    t_future =  __do_set_request( a_request );
                     break;
                 } // end "set" operation
                 case op_t::cmd:
                 {
-                    t_reply =  __do_cmd_request( a_request );
+                    t_future =  __do_cmd_request( a_request );
                     break;
                 }
                 default:
-                    throw throw_reply( dl_service_error_invalid_method() ) << "Unrecognized message operation: <" << a_request->get_message_operation() << ">";
+                {
+                    std::stringstream t_message;
+                    t_message << "Unrecognized message operation: <" << a_request->get_message_operation() << ">";
+                    t_reply = t_error_reply( reply_result( dl_service_error_invalid_method(), t_message.str() ) );
                     break;
+                }
             } // end switch on message type
+
+            // if the handler has already finished, get the reply (or its exception) here
+            if( t_future.valid() && t_future.is_ready() ) t_reply = t_future.get();
             // reply to be sent outside the try block
         }
-        catch( const throw_reply& e )
+        catch( throw_reply& e )
         {
             if( e.ret_code().rc_value() == dl_success::s_value )
             {
@@ -136,8 +192,8 @@ namespace dripline
             {
                 LWARN( dlog, "Replying with: " << e.return_message() );
             }
-            t_reply = a_request->reply( e.ret_code(), e.return_message() );
-            t_reply->set_payload( e.get_payload_ptr()->clone() );
+            // the throw_reply isn't used again, so its payload can be moved into the reply
+            t_reply = a_request->reply( e.ret_code(), e.return_message(), e.take_payload() );
             // don't rethrow a throw_reply
             // reply to be sent outside the catch block
         }
@@ -179,13 +235,78 @@ namespace dripline
             t_replier(); // send the reply before rethrowing
             throw; // unhandled exceptions should rethrow because they're by definition unhandled
         }
-        
+
+        if( t_future.valid() && ! t_reply )
+        {
+            // the handler is still working; the reply will be sent when it's done
+            LDEBUG( dlog, "Request is being handled asynchronously" );
+            t_future.then( [this, a_request, t_use_dedup_cache, t_permit]( reply_future& a_done ){
+                complete_request( a_request, a_done, t_use_dedup_cache );
+                return reply_ptr_t();
+            } );
+            return reply_ptr_t();
+        }
+
+        if( t_use_dedup_cache ) f_dedup_cache->store( a_request->message_id(), t_reply );
+        if( f_request_stats ) f_request_stats->record( std::chrono::steady_clock::now() - a_request->get_receive_time() );
+
         // send the reply
         t_replier();
 
         return t_reply;
     }
 
+    void endpoint::complete_request( const request_ptr_t a_request, reply_future& a_future, bool a_use_dedup_cache )
+    {
+        reply_ptr_t t_reply;
+        try
+        {
+            t_reply = a_future.get();
+            if( ! t_reply ) throw dripline_error() << "Asynchronous request handler finished without a reply";
+        }
+        catch( throw_reply& e )
+        {
+            if( e.ret_code().rc_value() == dl_success::s_value )
+            {
+                LINFO( dlog, "Replying with: " << e.return_message() );
+            }
+            else
+            {
+                LWARN( dlog, "Replying with: " << e.return_message() );
+            }
+            t_reply = a_request->reply( e.ret_code(), e.return_message(), e.take_payload() );
+        }
+        catch( const std::exception& e )
+        {
+            // there's nobody to rethrow to from here, so the error is only reported
+            LERROR( dlog, "Caught exception from asynchronous request handler: " << e.what() );
+            t_reply = a_request->reply( dl_unhandled_exception(), e.what() );
+        }
+
+        if( a_use_dedup_cache ) f_dedup_cache->store( a_request->message_id(), t_reply );
+        if( f_request_stats ) f_request_stats->record( std::chrono::steady_clock::now() - a_request->get_receive_time() );
+
+        send_reply_or_log( a_request, t_reply );
+        return;
+    }
+
+    void endpoint::send_reply_or_log( const request_ptr_t a_request, const reply_ptr_t a_reply ) const
+    {
+        // send the reply if the request had a reply-to
+        if( a_request->reply_to().empty() )
+        {
+            LWARN( dlog, "Not sending reply (reply-to empty)\n" <<
+                        "    Return code: " << a_reply->get_return_code() << '\n' <<
+                        "    Return message: " << a_reply->return_message() << '\n' <<
+                        "    Payload:\n" << a_reply->payload() );
+        }
+        else
+        {
+            send_reply( a_reply );
+        }
+        return;
+    }
+
     void endpoint::sort_message( message_ptr_t a_message )
     {
         if( a_message->is_request() )
@@ -206,6 +327,22 @@ namespace dripline
         }
     }
 
+    bool endpoint::is_control_request( const msg_request& a_request )
+    {
+        if( a_request.parsed_specifier().empty() ) return false;
+
+        std::string_view t_instruction = a_request.parsed_specifier().front();
+        switch( a_request.get_message_operation() )
+        {
+            case op_t::get:
+                return t_instruction == "is-locked";
+            case op_t::cmd:
+                return t_instruction == "lock" || t_instruction == "unlock" || t_instruction == "ping" || t_instruction == "set_condition";
+            default:
+                return false;
+        }
+    }
+
     void endpoint::send_reply( reply_ptr_t a_reply ) const
     {
         if( ! f_service )
@@ -275,26 +412,58 @@ namespace dripline
         return do_run_request( a_request );
     }
 
-    reply_ptr_t endpoint::__do_get_request( request_ptr_t a_request )
+    reply_future endpoint::__do_get_request( request_ptr_t a_request )
     {
         LDEBUG( dlog, "Get operation request received" );
 
-        std::string t_query_type;
-        if( ! a_request->parsed_specifier().empty() )
-        {
-            t_query_type = a_request->parsed_specifier().front();
-        }
+        // the token remains valid after pop_front()
+        std::string_view t_query_type = a_request->parsed_specifier().front();
 
         if( t_query_type == "is-locked" )
         {
             a_request->parsed_specifier().pop_front();
-            return handle_is_locked_request( a_request );
+            return reply_future::make_ready( handle_is_locked_request( a_request ) );
         }
 
-        return do_get_request( a_request );
+        // requests with values in the payload might not read the same thing, so they aren't cached or coalesced
+        bool t_empty_payload = a_request->payload().is_null() || ( a_request->payload().is_node() && a_request->payload().as_node().empty() );
+        if( ! t_empty_payload || ( ! f_get_cache && ! f_get_coalescer ) ) return do_get_request_async( a_request );
+
+        const std::string t_specifier = a_request->parsed_specifier().unparsed();
+        // the reply is only stored if the cache isn't invalidated while the value is being read
+        uint64_t t_cache_generation = f_get_cache ? f_get_cache->generation() : 0;
+        if( f_get_cache )
+        {
+            reply_ptr_t t_cached_reply = f_get_cache->find( t_specifier );
+            if( t_cached_reply )
+            {
+                LDEBUG( dlog, "Replying with the cached value for <" << t_specifier << ">" );
+                return reply_future::make_ready( a_request->reply( t_cached_reply->get_return_code(), t_cached_reply->return_message(), t_cached_reply->get_payload_ptr()->clone() ) );
+            }
+        }
+
+        // the reply is cached when the handler finishes
+        auto t_cache_reply = [this, t_specifier, t_cache_generation]( reply_future& a_done ){
+            reply_ptr_t t_reply = a_done.get();
+            if( f_get_cache && t_reply && t_reply->get_return_code() == dl_success::s_value ) f_get_cache->store( t_specifier, t_reply, t_cache_generation );
+            return t_reply;
+        };
+
+        if( ! f_get_coalescer ) return do_get_request_async( a_request ).then( t_cache_reply );
+
+        bool t_shared = false;
+        reply_future t_flight = f_get_coalescer->execute( f_name + ":" + t_specifier, a_request->get_receive_time(), [this, a_request](){ return do_get_request_async( a_request ); }, t_shared );
+        if( ! t_shared ) return t_flight.then( t_cache_reply );
+
+        // each request that shares a flight gets its own reply, addressed using its own reply-to and correlation ID
+        return t_flight.then( [a_request]( reply_future& a_done ){
+            reply_ptr_t t_reply = a_done.get();
+            if( ! t_reply ) return t_reply;
+            return a_request->reply( t_reply->get_return_code(), t_reply->return_message(), t_reply->get_payload_ptr()->clone() );
+        } );
     }
 
-    reply_ptr_t endpoint::__do_set_request( const request_ptr_t a_request )
+    reply_future endpoint::__do_set_request( const request_ptr_t a_request )
     {
         LDEBUG( dlog, "Set request received" );
 
@@ -304,21 +473,19 @@ namespace dripline
             t_conv << a_request->lockout_key();
             std::string t_message( "Request denied due to lockout (key used: " + t_conv.str() + ")" );
             LINFO( dlog, t_message );
-            return a_request->reply( dl_service_error_access_denied(), t_message );
+            return reply_future::make_ready( a_request->reply( dl_service_error_access_denied(), t_message ) );
         }
 
-        return do_set_request( a_request );
+        // a set may change what would be read
+        invalidate_reads();
+        return invalidate_reads_when_done( do_set_request_async( a_request ) );
     }
 
-    reply_ptr_t endpoint::__do_cmd_request( const request_ptr_t a_request )
+    reply_future endpoint::__do_cmd_request( const request_ptr_t a_request )
     {
         LDEBUG( dlog, "Cmd request received" );
 
-        std::string t_instruction;
-        if( ! a_request->parsed_specifier().empty() )
-        {
-            t_instruction = a_request->parsed_specifier().front();
-        }
+        std::string_view t_instruction = a_request->parsed_specifier().front();
 
         //LWARN( mtlog, "uuid string: " << a_request->get_payload().get_value( "key", "") << ", uuid: " << uuid_from_string( a_request->get_payload().get_value( "key", "") ) );
         // this condition includes the exception for the unlock instruction that allows us to force the unlock regardless of the key.
@@ -329,31 +496,53 @@ namespace dripline
             t_conv << a_request->lockout_key();
             std::string t_message( "Request denied due to lockout (key used: " + t_conv.str() + ")" );
             LINFO( dlog, t_message );
-            return a_request->reply( dl_service_error_access_denied(), t_message );
+            return reply_future::make_ready( a_request->reply( dl_service_error_access_denied(), t_message ) );
         }
 
         if( t_instruction == "lock" )
         {
             a_request->parsed_specifier().pop_front();
-            return handle_lock_request( a_request );
+            return reply_future::make_ready( handle_lock_request( a_request ) );
         }
         else if( t_instruction == "unlock" )
         {
             a_request->parsed_specifier().pop_front();
-            return handle_unlock_request( a_request );
+            return reply_future::make_ready( handle_unlock_request( a_request ) );
         }
         else if( t_instruction == "ping" )
         {
             a_request->parsed_specifier().pop_front();
-            return handle_ping_request( a_request );
+            return reply_future::make_ready( handle_ping_request( a_request ) );
         }
-        else if( t_instruction == "set_condition" )
+
+        // any other cmd may change what would be read
+        invalidate_reads();
+        if( t_instruction == "set_condition" )
         {
             a_request->parsed_specifier().pop_front();
-            return handle_set_condition_request( a_request );
+            return invalidate_reads_when_done( reply_future::make_ready( handle_set_condition_request( a_request ) ) );
         }
 
-        return do_cmd_request( a_request );
+        return invalidate_reads_when_done( do_cmd_request_async( a_request ) );
+    }
+
+    void endpoint::invalidate_reads()
+    {
+        if( f_get_cache ) f_get_cache->invalidate();
+        if( f_get_coalescer ) f_get_coalescer->invalidate();
+        return;
+    }
+
+    reply_future endpoint::invalidate_reads_when_done( reply_future a_handler_future )
+    {
+        if( ! f_get_cache && ! f_get_coalescer ) return a_handler_future;
+        // gets that ran alongside the handler may have read what was there before it took effect,
+        // so their results must not be stored or shared with the requests that come after it
+        return a_handler_future.then( [t_cache = f_get_cache, t_coalescer = f_get_coalescer]( reply_future& a_done ){
+            if( t_cache ) t_cache->invalidate();
+            if( t_coalescer ) t_coalescer->invalidate();
+            return a_done.get();
+        } );
     }
 
     uuid_t endpoint::enable_lockout( const scarab::param_node& a_tag, uuid_t a_key )
@@ -9,10 +9,16 @@
 #define DRIPLINE_ENDPOINT_HH_
 
 #include "message.hh"
+#include "reply_future.hh"
 #include "return_codes.hh"
 
 namespace dripline
 {
+    class admission_controller;
+    class dedup_cache;
+    class get_cache;
+    class get_coalescer;
+    class request_stats;
     class service;
 
     /*!
@@ -45,28 +51,50 @@ namespace dripline
      Basic request handling is performed by the `on_request_message()` function.  This can be overridden, but in most 
      cases should not need to be.  This function performs the following tasks:
 
-     1. Checks that the request message and the lockout key it contains are valid (does not authenticate the lockout key).
-     2. Passes the reqest to the `__do_[OP]_request()` function according to the request's operation type.
-     3. Receives a reply object from the `__do_[OP]_request()` function
-     4. If a valid reply was received (i.e. it has a reply-to address), sends the reply. Otherwise prints a message to the terminal with the results.
+     1. Checks that the request has not expired (see `msg_request::is_expired()`); expired requests are counted 
+        (`expired_request_count`) and dropped without being handled or replied to.
+        If the endpoint has a @ref dedup_cache, `OP_SET` and `OP_CMD` requests that have already been handled are answered 
+        with the stored reply.
+        If the endpoint has an @ref admission_controller, requests that are over its limits are answered right away with 
+        `dl_service_error_overloaded`; control requests (see below) are always admitted.
+     2. Checks that the request message and the lockout key it contains are valid (does not authenticate the lockout key).
+     3. Passes the reqest to the `__do_[OP]_request()` function according to the request's operation type.
+     4. Receives a reply object from the `__do_[OP]_request()` function; if the endpoint has a @ref request_stats, 
+        records the time since the request was received
+     5. If a valid reply was received (i.e. it has a reply-to address), sends the reply. Otherwise prints a message to the terminal with the results.
 
      Each message operation is handled in two functions: `__do_[OP]_request()` and `do_[OP]_request()`.  The former takes care 
      of built-in Dripline-standard behavior and should not be overridden.  Endpoint-specific behavior should be implemented by 
      overriding the latter.
 
+     ## Asynchronous handlers
+
+     The get, set, and cmd requests actually reach the endpoint-specific handlers through `do_[OP]_request_async()`, which 
+     return a @ref reply_future.  By default these call `do_[OP]_request()` and return the reply as a completed future.
+
+     An endpoint that waits on slow hardware can override `do_[OP]_request_async()` instead, start the operation, and return 
+     the future from a @ref reply_promise that it completes when the operation finishes (e.g. from an I/O thread).  
+     `on_request_message()` then returns an empty pointer right away, so the receiver thread can go on to other requests, and 
+     the reply is checked and sent (step 5 above) by the thread that completes the promise.  Exceptions given to the promise 
+     are turned into replies as they would be if thrown by a synchronous handler, but they're not rethrown.  The endpoint must 
+     outlive any requests it has not yet completed.
+
+     A get request that shares the result of another request through a @ref get_coalescer is completed the same way, when that 
+     request's handler finishes; the receiver thread doesn't wait for it.
+
      ### OP_GET
 
-     * `__do_get_request()`: handles get-is-locked if relevant; otherwise calls `do_get_request().
+     * `__do_get_request()`: handles get-is-locked if relevant; otherwise, if the endpoint has a @ref get_cache, replies with a cached value if there is one; otherwise calls `do_get_request()` (through the @ref get_coalescer, if the endpoint has one).
      * `do_get_request()`: override this to add get-handling behavior.  Default sends an error reply.
 
      ### OP_SET
 
-     * `__do_set_request()`: authenticates the lockout key, then calls `do_set_request().
+     * `__do_set_request()`: authenticates the lockout key, invalidates the get cache and coalescer (if any), then calls `do_set_request()`; the get cache and coalescer are invalidated again once the handler finishes.
      * `do_set_request()`: override this to add set-handling behavior.  Default sends an error reply.
 
      ### OP_CMD
 
-     * `__do_cmd_request()`: authenticates the lockout key.  If relevant, handles cmd-lock, cmd-unlock, cmd-set-condition, and cmd-ping; otherwise calls `do_cmd_request()`. 
+     * `__do_cmd_request()`: authenticates the lockout key.  If relevant, handles cmd-lock, cmd-unlock, and cmd-ping.  Otherwise it invalidates the get cache and coalescer (if any) and handles cmd-set-condition or calls `do_cmd_request()`; the get cache and coalescer are invalidated again once the handler finishes. 
      * `do_cmd_request()`: override this to add get-handling behavior.  Default sends an error reply.
 
      ## Alerts
@@ -92,6 +120,9 @@ namespace dripline
      * Type: `OP_CMD`; Specifier: `set-condition` -- set a particular "condition" for the endpoint.  The default behavior is to do nothing, which can be overridden with the function `__do_handle_set_condition_request()`.
      * Type: `OP_CMD`; Specifier: `ping` -- send a simple acknowledgement of receipt of the request
 
+     `is_control_request()` identifies these requests; it's used by @ref concurrent_receiver to let them skip ahead of 
+     other requests that are waiting to be handled.
+
     */
     class DRIPLINE_API endpoint
     {
@@ -112,12 +143,30 @@ namespace dripline
             service& parent();
             const service& parent() const;
 
+            /// Number of requests that were dropped because they had expired
+            mv_accessible( unsigned, expired_request_count );
+
+            /// Cache of replies used to recognize duplicate requests; if empty, duplicates are not recognized
+            mv_accessible( std::shared_ptr< dedup_cache >, dedup_cache );
+
+            /// Cache of replies to get requests; if empty, get replies are not cached
+            mv_accessible( std::shared_ptr< get_cache >, get_cache );
+
+            /// Lets identical get requests share one call to `do_get_request()`; if empty, get requests are not coalesced
+            mv_accessible( std::shared_ptr< get_coalescer >, get_coalescer );
+
+            /// Limits on the requests the endpoint accepts; if empty, all requests are accepted
+            mv_accessible( std::shared_ptr< admission_controller >, admission_controller );
+
+            /// Counts the requests the endpoint handles and how long they take; if empty, they aren't counted
+            mv_accessible( std::shared_ptr< request_stats >, request_stats );
+
         public:
             //**************************
             // Direct message submission
             //**************************
 
-            /// Directly submit a request message to this endpoint
+            /// Directly submit a request message to this endpoint; returns an empty pointer if the request is being handled asynchronously
             reply_ptr_t submit_request_message( const request_ptr_t a_request );
 
             /// Directly submit a reply message to this endpoint
@@ -154,12 +203,21 @@ namespace dripline
             virtual reply_ptr_t do_set_request( const request_ptr_t a_request );
             virtual reply_ptr_t do_cmd_request( const request_ptr_t a_request );
 
+            // Override these instead to complete requests asynchronously; by default they call the synchronous handlers
+
+            virtual reply_future do_get_request_async( const request_ptr_t a_request );
+            virtual reply_future do_set_request_async( const request_ptr_t a_request );
+            virtual reply_future do_cmd_request_async( const request_ptr_t a_request );
+
             /// Calls the appropriate request handler on a message object.
             /// Message type is explicitly checked within this function.
             /// Note that you cannot get the reply_ptr_t using this method if you submit a request.
             /// This is really intended for use when handling messages received by a parent object.
             void sort_message( const message_ptr_t a_request );
 
+            /// Returns true if the request will be handled by one of the built-in request handlers (lock, unlock, is-locked, set_condition, and ping)
+            static bool is_control_request( const msg_request& a_request );
+
         private:
             //**************************
             // Initial request functions
@@ -169,9 +227,19 @@ namespace dripline
             // Authentication is checked as necessary, and then request handlers are called
 
             reply_ptr_t __do_run_request( const request_ptr_t a_request );
-            reply_ptr_t __do_get_request( const request_ptr_t a_request );
-            reply_ptr_t __do_set_request( const request_ptr_t a_request );
-            reply_ptr_t __do_cmd_request( const request_ptr_t a_request );
+            reply_future __do_get_request( const request_ptr_t a_request );
+            reply_future __do_set_request( const request_ptr_t a_request );
+            reply_future __do_cmd_request( const request_ptr_t a_request );
+
+            /// Invalidates the get cache and coalescer (if any) before a handler that may change what would be read
+            void invalidate_reads();
+            /// Invalidates the get cache and coalescer (if any) again once that handler has finished, since gets may have run alongside it
+            reply_future invalidate_reads_when_done( reply_future a_handler_future );
+
+            /// Sends the reply to a request whose handler completed asynchronously
+            void complete_request( const request_ptr_t a_request, reply_future& a_future, bool a_use_dedup_cache );
+            /// Sends the reply if the request has a reply-to; otherwise logs the reply
+            void send_reply_or_log( const request_ptr_t a_request, const reply_ptr_t a_reply ) const;
 
         protected:
             virtual void send_reply( reply_ptr_t a_reply ) const;
@@ -232,6 +300,21 @@ namespace dripline
         return a_request->reply( dl_resource_error(), "Unhandled request type: OP_CMD" );
     }
 
+    inline reply_future endpoint::do_get_request_async( const request_ptr_t a_request )
+    {
+        return reply_future::make_ready( do_get_request( a_request ) );
+    }
+
+    inline reply_future endpoint::do_set_request_async( const request_ptr_t a_request )
+    {
+        return reply_future::make_ready( do_set_request( a_request ) );
+    }
+
+    inline reply_future endpoint::do_cmd_request_async( const request_ptr_t a_request )
+    {
+        return reply_future::make_ready( do_cmd_request( a_request ) );
+    }
+
     inline uuid_t endpoint::enable_lockout( const scarab::param_node& a_tag )
     {
         return enable_lockout( a_tag, generate_random_uuid() );
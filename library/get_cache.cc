@@ -0,0 +1,126 @@
+/*
+ * get_cache.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "get_cache.hh"
+
+#include "message.hh"
+
+#include "logger.hh"
+#include "param.hh"
+
+namespace dripline
+{
+    LOGGER( dlog, "get_cache" );
+
+    get_cache::get_cache( unsigned a_default_ttl_ms ) :
+            f_default_ttl_ms( a_default_ttl_ms ),
+            f_mutex(),
+            f_ttls_ms(),
+            f_entries(),
+            f_generation( 0 )
+    {}
+
+    get_cache::get_cache( const scarab::param_node& a_config ) :
+            get_cache( a_config.get_value( "default_ttl_ms", 0U ) )
+    {
+        if( a_config.has( "ttl_ms" ) )
+        {
+            const scarab::param_node& t_ttls = a_config["ttl_ms"].as_node();
+            for( auto i_ttl = t_ttls.begin(); i_ttl != t_ttls.end(); ++i_ttl )
+            {
+                f_ttls_ms[i_ttl.name()] = (*i_ttl)().as_uint();
+            }
+        }
+    }
+
+    void get_cache::set_ttl_ms( const std::string& a_specifier, unsigned a_ttl_ms )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        f_ttls_ms[a_specifier] = a_ttl_ms;
+        f_entries.erase( a_specifier );
+        return;
+    }
+
+    unsigned get_cache::get_ttl_ms( const std::string& a_specifier ) const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        auto t_ttl_it = f_ttls_ms.find( a_specifier );
+        return t_ttl_it == f_ttls_ms.end() ? f_default_ttl_ms : t_ttl_it->second;
+    }
+
+    std::shared_ptr< get_cache > get_cache::create_empty_copy() const
+    {
+        std::shared_ptr< get_cache > t_copy = std::make_shared< get_cache >( f_default_ttl_ms );
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        t_copy->f_ttls_ms = f_ttls_ms;
+        return t_copy;
+    }
+
+    reply_ptr_t get_cache::find( const std::string& a_specifier )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        auto t_entry_it = f_entries.find( a_specifier );
+        if( t_entry_it == f_entries.end() ) return reply_ptr_t();
+
+        if( t_entry_it->second.f_expiration < clock_t::now() )
+        {
+            f_entries.erase( t_entry_it );
+            return reply_ptr_t();
+        }
+        return t_entry_it->second.f_reply;
+    }
+
+    void get_cache::store( const std::string& a_specifier, reply_ptr_t a_reply )
+    {
+        if( ! a_reply ) return;
+
+        unsigned t_ttl_ms = get_ttl_ms( a_specifier );
+        if( t_ttl_ms == 0 ) return;
+
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        f_entries[a_specifier] = entry{ a_reply, clock_t::now() + std::chrono::milliseconds( t_ttl_ms ) };
+        return;
+    }
+
+    void get_cache::store( const std::string& a_specifier, reply_ptr_t a_reply, uint64_t a_generation )
+    {
+        if( ! a_reply ) return;
+
+        unsigned t_ttl_ms = get_ttl_ms( a_specifier );
+        if( t_ttl_ms == 0 ) return;
+
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        if( a_generation != f_generation )
+        {
+            LDEBUG( dlog, "Not storing the reply for <" << a_specifier << "> because the cache was invalidated while it was being read" );
+            return;
+        }
+        f_entries[a_specifier] = entry{ a_reply, clock_t::now() + std::chrono::milliseconds( t_ttl_ms ) };
+        return;
+    }
+
+    void get_cache::invalidate()
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        ++f_generation;
+        if( ! f_entries.empty() )
+        {
+            LDEBUG( dlog, "Invalidating " << f_entries.size() << " cached get replies" );
+            f_entries.clear();
+        }
+        return;
+    }
+
+    uint64_t get_cache::generation() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_generation;
+    }
+
+} /* namespace dripline */
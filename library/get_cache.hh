@@ -0,0 +1,118 @@
+/*
+ * get_cache.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_GET_CACHE_HH_
+#define DRIPLINE_GET_CACHE_HH_
+
+#include "dripline_api.hh"
+#include "dripline_fwd.hh"
+
+#include "member_variables.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace scarab
+{
+    class param_node;
+}
+
+namespace dripline
+{
+
+    /*!
+     @class get_cache
+     @author N.S. Oblath
+
+     @brief Stores the replies to `OP_GET` requests for a limited time so that repeated reads don't reach the hardware
+
+     @details
+     An endpoint with a get_cache (see `endpoint::__do_get_request()`) answers a get request from the cache if a reply 
+     to a get request with the same specifier was stored less than the specifier's TTL ago.  Otherwise the request is 
+     handled normally, and a successful reply is stored.  Get requests with a non-empty payload are not cached.
+
+     Each specifier can have its own TTL; specifiers without their own TTL use the default TTL.  A TTL of 0 means 
+     replies are not cached.
+
+     The cache is invalidated when the endpoint starts handling an `OP_SET` request or an `OP_CMD` request (other than 
+     `lock`, `unlock`, and `ping`), since those may change the values that would be read, and again when the handler 
+     finishes.  Each invalidation starts a new generation; a get request notes the generation before it's handled, and 
+     its reply is only stored if the cache hasn't been invalidated since, so a get that runs alongside a set can't put 
+     the old value back in the cache.
+
+     The configuration has the form:
+     ~~~
+     {
+         "default_ttl_ms": [ms], // optional; default is 0
+         "ttl_ms": { // optional
+             "[specifier]": [ms],
+             ...
+         }
+     }
+     ~~~
+
+     All functions are thread-safe.
+    */
+    class DRIPLINE_API get_cache
+    {
+        public:
+            get_cache( unsigned a_default_ttl_ms = 0 );
+            get_cache( const scarab::param_node& a_config );
+            get_cache( const get_cache& ) = delete;
+            get_cache( get_cache&& ) = delete;
+            virtual ~get_cache() = default;
+
+            get_cache& operator=( const get_cache& ) = delete;
+            get_cache& operator=( get_cache&& ) = delete;
+
+            /// Sets the TTL used for a particular specifier
+            void set_ttl_ms( const std::string& a_specifier, unsigned a_ttl_ms );
+            /// Returns the TTL used for a particular specifier
+            unsigned get_ttl_ms( const std::string& a_specifier ) const;
+
+            /// Creates an empty cache with the same TTLs as this one (e.g. for the children of a service)
+            std::shared_ptr< get_cache > create_empty_copy() const;
+
+            /// Returns the stored reply for the specifier if it's still valid; returns an empty pointer otherwise
+            reply_ptr_t find( const std::string& a_specifier );
+
+            /// Stores a reply for the specifier if the specifier's TTL is non-zero
+            void store( const std::string& a_specifier, reply_ptr_t a_reply );
+            /// Stores a reply for the specifier if the specifier's TTL is non-zero and the cache is still in generation a_generation
+            void store( const std::string& a_specifier, reply_ptr_t a_reply, uint64_t a_generation );
+
+            /// Removes all stored replies, and starts a new generation
+            void invalidate();
+
+            /// Current generation; it changes each time the cache is invalidated
+            uint64_t generation() const;
+
+            /// Default TTL for specifiers without their own TTL
+            mv_accessible( unsigned, default_ttl_ms );
+
+        protected:
+            typedef std::chrono::steady_clock clock_t;
+
+            struct entry
+            {
+                reply_ptr_t f_reply;
+                clock_t::time_point f_expiration;
+            };
+
+            mutable std::mutex f_mutex;
+            std::map< std::string, unsigned > f_ttls_ms;
+            std::map< std::string, entry > f_entries;
+            uint64_t f_generation;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_GET_CACHE_HH_ */
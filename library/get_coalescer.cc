@@ -0,0 +1,102 @@
+/*
+ * get_coalescer.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "get_coalescer.hh"
+
+#include "logger.hh"
+
+namespace dripline
+{
+    LOGGER( dlog, "get_coalescer" );
+
+    get_coalescer::get_coalescer() :
+            f_mutex(),
+            f_flights()
+    {}
+
+    reply_future get_coalescer::execute( const std::string& a_key, clock_t::time_point a_receive_time, handler_t a_handler, bool& a_shared )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+
+        auto t_flight_it = f_flights.find( a_key );
+        if( t_flight_it != f_flights.end() )
+        {
+            // join a running flight
+            if( ! t_flight_it->second.f_future.is_ready() )
+            {
+                LDEBUG( dlog, "Sharing the result of the running request for <" << a_key << ">" );
+                a_shared = true;
+                return t_flight_it->second.f_future;
+            }
+
+            // use a flight that started after this request was received
+            if( t_flight_it->second.f_start_time >= a_receive_time )
+            {
+                LDEBUG( dlog, "Using the result of a request for <" << a_key << "> that started after this request was received" );
+                a_shared = true;
+                return t_flight_it->second.f_future;
+            }
+        }
+
+        // start a new flight; requests that arrive while the handler is being called share the promised result
+        prune( a_receive_time );
+        reply_promise t_promise;
+        flight& t_flight = f_flights[a_key];
+        t_flight.f_start_time = clock_t::now();
+        t_flight.f_future = t_promise.get_future();
+        t_lock.unlock();
+
+        try
+        {
+            a_handler().then( [t_promise]( reply_future& a_done ) mutable {
+                try
+                {
+                    t_promise.set_reply( a_done.get() );
+                }
+                catch( ... )
+                {
+                    t_promise.set_exception( std::current_exception() );
+                }
+                return reply_ptr_t();
+            } );
+        }
+        catch( ... )
+        {
+            t_promise.set_exception( std::current_exception() );
+        }
+
+        a_shared = false;
+        return t_promise.get_future();
+    }
+
+    void get_coalescer::invalidate()
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        // requests already sharing running flights still get those results
+        f_flights.clear();
+        return;
+    }
+
+    unsigned get_coalescer::size() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_flights.size();
+    }
+
+    void get_coalescer::prune( clock_t::time_point a_time )
+    {
+        for( auto t_flight_it = f_flights.begin(); t_flight_it != f_flights.end(); )
+        {
+            if( t_flight_it->second.f_start_time < a_time && t_flight_it->second.f_future.is_ready() ) t_flight_it = f_flights.erase( t_flight_it );
+            else ++t_flight_it;
+        }
+        return;
+    }
+
+} /* namespace dripline */
@@ -0,0 +1,97 @@
+/*
+ * get_coalescer.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_GET_COALESCER_HH_
+#define DRIPLINE_GET_COALESCER_HH_
+
+#include "dripline_api.hh"
+#include "dripline_fwd.hh"
+#include "reply_future.hh"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dripline
+{
+
+    /*!
+     @class get_coalescer
+     @author N.S. Oblath
+
+     @brief Lets identical get requests share a single call to the handler
+
+     @details
+     An endpoint with a get_coalescer (see `endpoint::__do_get_request()`) passes each get request through `execute()`, 
+     keyed by the endpoint name and the specifier.  For each key, only one handler call (a "flight") runs at a time:
+     * If a flight is running when a request arrives at `execute()`, the request shares that flight's result.
+     * If the most recent flight started after the request was received, the request uses that flight's result, since 
+       it's at least as fresh as a new read would have been.  This covers identical requests that were queued 
+       together behind a slow request.
+     * Otherwise a new flight is started.
+
+     Flights are @ref reply_future "reply_futures", so a request that shares a running flight doesn't wait for it:
+     `execute()` returns the flight's future, and the endpoint attaches a continuation that makes the request's own 
+     reply (with its own correlation ID) once the flight finishes.  Exceptions thrown by the handler (including 
+     `throw_reply`) complete the flight's future, and so reach every request that shares it.
+
+     `invalidate()` is called when the endpoint starts handling a set or cmd request, and again when the handler finishes: 
+     flights that are running are no longer joined by new requests, and completed results are forgotten.  A flight that 
+     started before the handler finished may have read the old value, so requests that arrive afterwards don't share it.
+
+     Completed flights are only useful to requests received before they started.  Requests generally arrive at `execute()` 
+     in the order they were received, so when a new flight is started, the completed flights that started before the 
+     request that needed it was received are forgotten.  That keeps the number of stored flights from growing with the 
+     number of distinct keys.
+
+     All functions are thread-safe, so one coalescer can be shared by a service and its children.
+    */
+    class DRIPLINE_API get_coalescer
+    {
+        public:
+            typedef std::chrono::steady_clock clock_t;
+            typedef std::function< reply_future () > handler_t;
+
+        public:
+            get_coalescer();
+            get_coalescer( const get_coalescer& ) = delete;
+            get_coalescer( get_coalescer&& ) = delete;
+            virtual ~get_coalescer() = default;
+
+            get_coalescer& operator=( const get_coalescer& ) = delete;
+            get_coalescer& operator=( get_coalescer&& ) = delete;
+
+            /// Returns the future result of a flight for the key, calling a_handler if a new flight is needed.
+            /// a_shared is set to true if the result comes from another request's flight.
+            reply_future execute( const std::string& a_key, clock_t::time_point a_receive_time, handler_t a_handler, bool& a_shared );
+
+            /// Number of flights stored, running or completed
+            unsigned size() const;
+
+            /// Forgets completed flights, and stops new requests from joining running flights
+            void invalidate();
+
+        protected:
+            struct flight
+            {
+                clock_t::time_point f_start_time;
+                reply_future f_future;
+            };
+
+            /// Forgets completed flights that started before a_time
+            void prune( clock_t::time_point a_time );
+
+            mutable std::mutex f_mutex;
+            std::map< std::string, flight > f_flights;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_GET_COALESCER_HH_ */
@@ -11,11 +11,14 @@
 
 #include "message.hh"
 #include "service.hh"
+#include "timer_service.hh"
 
 #include "logger.hh"
 #include "param_node.hh"
 
+#include <fstream>
 #include <iomanip>
+#include <sstream>
 
 LOGGER( dlog, "heartbeater" );
 
@@ -26,22 +29,45 @@ namespace dripline
             cancelable(),
             f_heartbeat_interval_s( 60 ),
             f_check_timeout_ms( 1000 ),
+            f_include_stats( false ),
             f_service( a_service ),
-//            f_stop( false ),
-            f_heartbeat_thread()
+            f_heartbeat_alert(),
+            f_heartbeat_timer_id( -1 ),
+            f_execute_mutex(),
+            f_execute_condition()
     {}
 
+    heartbeater::heartbeater( heartbeater&& a_orig ) :
+            cancelable( std::move(a_orig) ),
+            f_heartbeat_interval_s( a_orig.f_heartbeat_interval_s ),
+            f_check_timeout_ms( a_orig.f_check_timeout_ms ),
+            f_include_stats( a_orig.f_include_stats ),
+            f_service( a_orig.f_service ),
+            f_heartbeat_alert(),
+            f_heartbeat_timer_id( -1 ),
+            f_execute_mutex(),
+            f_execute_condition()
+    {
+        // the heartbeat timer refers to the original heartbeater, so it's stopped before anything is moved
+        a_orig.stop_heartbeat();
+        f_heartbeat_alert = std::move( a_orig.f_heartbeat_alert );
+    }
+
     heartbeater& heartbeater::operator=( heartbeater&& a_orig )
     {
+        // the heartbeat timers refer to their heartbeaters, so both are stopped before anything is moved
+        stop_heartbeat();
+        a_orig.stop_heartbeat();
         cancelable::operator=( std::move(a_orig) );
         f_heartbeat_interval_s = a_orig.f_heartbeat_interval_s;
         f_check_timeout_ms = a_orig.f_check_timeout_ms;
+        f_include_stats = a_orig.f_include_stats;
         f_service = std::move( a_orig.f_service );
-        f_heartbeat_thread = std::move( a_orig.f_heartbeat_thread );
+        f_heartbeat_alert = std::move( a_orig.f_heartbeat_alert );
         return *this;
     }
 
-    void heartbeater::execute( const std::string& a_name, uuid_t a_id, const std::string& a_routing_key )
+    void heartbeater::start_heartbeat( const std::string& a_name, uuid_t a_id, const std::string& a_routing_key )
     {
         if( ! f_service )
         {
@@ -54,6 +80,12 @@ namespace dripline
             return;
         }
 
+        if( is_heartbeating() )
+        {
+            LWARN( dlog, "Heartbeat is already running" );
+            return;
+        }
+
         scarab::param_ptr_t t_payload_ptr( new scarab::param_node() );
         scarab::param_node& t_payload = t_payload_ptr->as_node();
         t_payload.add( "name", a_name );
@@ -63,50 +95,109 @@ namespace dripline
         t_key.push_back( a_routing_key );
         t_key.push_back( a_name );
 
-        alert_ptr_t t_alert_ptr = msg_alert::create( std::move(t_payload_ptr), t_key.to_string() );
+        f_heartbeat_alert = msg_alert::create( std::move(t_payload_ptr), t_key.to_string() );
+
+        LINFO( dlog, "Starting heartbeat" );
+
+        std::chrono::seconds t_interval( f_heartbeat_interval_s );
+        f_heartbeat_timer_id = timer_service::get_instance()->schedule( [this](){ send_heartbeat(); }, t_interval,
+                timer_service::clock_t::now() + t_interval, missed_tick_policy::coalesce );
+        return;
+    }
 
-        LINFO( dlog, "Starting heartbeat loop" );
+    void heartbeater::stop_heartbeat()
+    {
+        if( ! is_heartbeating() ) return;
 
-        auto t_next_heartbeat_at = std::chrono::steady_clock().now() + std::chrono::seconds( f_heartbeat_interval_s );
+        LINFO( dlog, "Stopping heartbeat" );
+        timer_service::get_instance()->cancel_timer( f_heartbeat_timer_id );
+        f_heartbeat_timer_id = -1;
+        return;
+    }
+
+    bool heartbeater::is_heartbeating() const
+    {
+        return f_heartbeat_timer_id >= 0;
+    }
+
+    void heartbeater::execute( const std::string& a_name, uuid_t a_id, const std::string& a_routing_key )
+    {
+        start_heartbeat( a_name, a_id, a_routing_key );
+        if( ! is_heartbeating() ) return;
+
+        std::unique_lock< std::mutex > t_lock( f_execute_mutex );
         while( ! f_canceled.load() )
         {
-            // wait the interval
-            std::this_thread::sleep_for( std::chrono::milliseconds( f_check_timeout_ms ) );
+            f_execute_condition.wait_for( t_lock, std::chrono::milliseconds( f_check_timeout_ms ) );
+        }
+        t_lock.unlock();
 
-            // send the message
-            if( std::chrono::steady_clock().now() >= t_next_heartbeat_at && ! f_canceled.load() )
+        stop_heartbeat();
+        return;
+    }
+
+    void heartbeater::do_cancellation( int )
+    {
+        // locking makes sure execute() is either waiting or will see the cancellation before it waits
+        std::unique_lock< std::mutex > t_lock( f_execute_mutex );
+        f_execute_condition.notify_all();
+        return;
+    }
+
+    void heartbeater::send_heartbeat()
+    {
+        if( f_canceled.load() ) return;
+
+        LDEBUG( dlog, "Sending heartbeat" );
+        // reset message ID so it's different for each heartbeat
+        f_heartbeat_alert->message_id() = string_from_uuid( generate_random_uuid() );
+
+        if( f_include_stats )
+        {
+            scarab::param_node t_stats;
+            add_heartbeat_stats( t_stats );
+            f_heartbeat_alert->payload().as_node().replace( "stats", t_stats );
+        }
+
+        sent_msg_pkg_ptr t_receive_reply;
+        try
+        {
+            t_receive_reply = f_service->send( f_heartbeat_alert );
+
+            if( ! t_receive_reply->f_successful_send )
             {
-                LDEBUG( dlog, "Sending heartbeat" );
-                // reset message ID so it's different for each heartbeat
-                t_alert_ptr->message_id() = string_from_uuid( generate_random_uuid() );
-
-                sent_msg_pkg_ptr t_receive_reply;
-                try
-                {
-                    t_receive_reply = f_service->send( t_alert_ptr );
-                    
-                    if( ! t_receive_reply->f_successful_send )
-                    {
-                        LERROR( dlog, "Failed to send reply:\n" + t_receive_reply->f_send_error_message );
-                    }
-                }
-                catch( message_ptr_t )
-                {
-                    LWARN( dlog, "Operating in offline mode; message not sent" );
-                }
-                catch( connection_error& e )
-                {
-                    LERROR( dlog, "Unable to connect to the broker:\n" << e.what() );
-                }
-                catch( dripline_error& e )
-                {
-                    LERROR( dlog, "Dripline error while sending reply:\n" << e.what() );
-                }
-
-                t_next_heartbeat_at = std::chrono::steady_clock().now() + std::chrono::seconds( f_heartbeat_interval_s );
+                LERROR( dlog, "Failed to send reply:\n" + t_receive_reply->f_send_error_message );
             }
         }
+        catch( message_ptr_t )
+        {
+            LWARN( dlog, "Operating in offline mode; message not sent" );
+        }
+        catch( connection_error& e )
+        {
+            LERROR( dlog, "Unable to connect to the broker:\n" << e.what() );
+        }
+        catch( dripline_error& e )
+        {
+            LERROR( dlog, "Dripline error while sending reply:\n" << e.what() );
+        }
+        return;
+    }
 
+    void heartbeater::add_heartbeat_stats( scarab::param_node& a_stats )
+    {
+        // the kernel reports the thread count and resident memory in /proc/self/status; elsewhere they're left out
+        std::ifstream t_status( "/proc/self/status" );
+        std::string t_line;
+        while( std::getline( t_status, t_line ) )
+        {
+            std::istringstream t_fields( t_line );
+            std::string t_key;
+            uint64_t t_value = 0;
+            if( ! ( t_fields >> t_key >> t_value ) ) continue;
+            if( t_key == "Threads:" ) a_stats.add( "threads", t_value );
+            else if( t_key == "VmRSS:" ) a_stats.add( "rss_kb", t_value );
+        }
         return;
     }
 
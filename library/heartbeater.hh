@@ -14,8 +14,11 @@
 
 #include "cancelable.hh"
 #include "member_variables.hh"
+#include "param_node.hh"
 
-#include <thread>
+#include <condition_variable>
+#include <mutex>
+#include <string>
 
 namespace dripline
 {
@@ -31,12 +34,21 @@ namespace dripline
      by inheriting from it.  See @ref service as an example of its use.
 
      The heartbeat is an alert sent to a pre-determined routing key, which is given as a parameter to the 
-     `execute()` function.  The interval for sending the heartbeats is `f_heartbeat_interval_s`, 
+     `start_heartbeat()` function.  The interval for sending the heartbeats is `f_heartbeat_interval_s`, 
      which is in seconds.  The default interval is 60 s.
 
      If the heartbeat interval is 0, the sending of heartbeats is disabled.
 
-     The parameters provided upon execution are the name (`a_name`, e.g. the service name), a UUID (`a_id`), and 
+     The heartbeats are sent by a repeating timer in the process's @ref timer_service, so the heartbeater doesn't 
+     need a thread of its own; they're sent from the timer_service's worker threads, not the timer thread.  
+     `start_heartbeat()` registers the timer and returns right away; `stop_heartbeat()` removes it.  If the 
+     heartbeats are held up for more than an interval, one heartbeat is sent rather than one for each missed 
+     interval.  `execute()` does the same, but blocks until the heartbeater is canceled.
+
+     Moving a heartbeater stops its heartbeats (and, for assignment, those of the heartbeater assigned to), 
+     since the timer refers to the original object; call `start_heartbeat()` again to restart them.
+
+     The parameters provided upon starting are the name (`a_name`, e.g. the service name), a UUID (`a_id`), and 
      the routing key (`a_routing_key`).
 
      The payload of each heartbeat message will be:
@@ -48,6 +60,10 @@ namespace dripline
      ~~~
 
      The routing key to which the message will be sent is `a_routing_key.a_name`.
+
+     If `include_stats` is true, each heartbeat also includes a `stats` node, filled in by `add_heartbeat_stats()`.  
+     By default that has the number of threads in the process (`threads`) and its resident memory (`rss_kb`), 
+     where the operating system makes them available (currently Linux).  @ref service adds its own load statistics.
     */
     class DRIPLINE_API heartbeater : public virtual scarab::cancelable
     {
@@ -55,15 +71,29 @@ namespace dripline
             ///Primary constructor.  A service pointer is required to be able to send messages.
             heartbeater( service* a_service );
             heartbeater( const heartbeater& ) = delete;
-            heartbeater( heartbeater&& a_orig ) = default;
+            heartbeater( heartbeater&& a_orig );
             virtual ~heartbeater() = default;
 
             heartbeater& operator=( const heartbeater& ) = delete;
             heartbeater& operator=( heartbeater&& a_orig ); // we have to explicitly define this because of the virtual inheritance of scarab::cancelable
 
             /*!
-             Starts the heartbeat process.  Heartbeat alerts are emitted every `heartbeat_interval_s` seconds.
-             If the interval is 0, then heartbeats are disabled.
+             Starts the heartbeats and returns.  Heartbeat alerts are emitted every `heartbeat_interval_s` seconds 
+             until `stop_heartbeat()` is called.  If the interval is 0, then heartbeats are disabled.
+             @param a_name The name for the heartbeater (e.g. the service)
+             @param a_id UUID for the heartbeater
+             @param a_routing_key The base of the routing key for heartbeat alerts; will be postpended with \ref a_name
+            */
+            void start_heartbeat( const std::string& a_name, uuid_t a_id, const std::string& a_routing_key );
+
+            /// Stops the heartbeats; if a heartbeat is being sent, waits for it to finish
+            void stop_heartbeat();
+
+            /// True if heartbeats have been started and not stopped
+            bool is_heartbeating() const;
+
+            /*!
+             Starts the heartbeats, waits until the heartbeater is canceled, and stops them.
              @param a_name The name for the heartbeater (e.g. the service)
              @param a_id UUID for the heartbeater
              @param a_routing_key The base of the routing key for heartbeat alerts; will be postpended with \ref a_name
@@ -72,15 +102,29 @@ namespace dripline
 
             /// Interval between heartbeat alerts (default: 60 s)
             mv_accessible( unsigned, heartbeat_interval_s );
-            /// Timing interval for the internal loop (default: 1000 ms)
+            /// Longest time `execute()` waits before checking whether it's been canceled (default: 1000 ms); cancellation wakes it right away
             mv_accessible( unsigned, check_timeout_ms );
+            /// Flag for including statistics in the heartbeats (default: false)
+            mv_accessible( bool, include_stats );
 
             mv_accessible( service*, service );
 
-            //mv_atomic( bool, stop );
-
         protected:
-            std::thread f_heartbeat_thread;
+            /// Sends one heartbeat alert; called by the heartbeat timer
+            void send_heartbeat();
+
+            /// Fills in the statistics included in each heartbeat when `include_stats` is true; called from a timer_service worker thread
+            virtual void add_heartbeat_stats( scarab::param_node& a_stats );
+
+            alert_ptr_t f_heartbeat_alert;
+            /// ID of the heartbeat timer in the timer_service; negative if there isn't one
+            int f_heartbeat_timer_id;
+
+            /// Wakes up `execute()`
+            virtual void do_cancellation( int a_code );
+
+            std::mutex f_execute_mutex;
+            std::condition_variable f_execute_condition;
 
     };
 
@@ -50,28 +50,51 @@ namespace dripline
 
     void hub::register_get_handler( const std::string& a_key, const handler_func_t& a_func )
     {
-        f_get_handlers[ a_key ] = a_func;
+        f_get_handlers.insert_or_assign( a_key, a_func );
         LDEBUG( dlog, "Set GET handler for <" << a_key << ">" );
         return;
     }
 
     void hub::register_set_handler( const std::string& a_key, const handler_func_t& a_func )
     {
-        f_set_handlers[ a_key ] = a_func;
+        f_set_handlers.insert_or_assign( a_key, a_func );
         LDEBUG( dlog, "Set SET handler for <" << a_key << ">" );
         return;
     }
 
     void hub::register_cmd_handler( const std::string& a_key, const handler_func_t& a_func )
     {
-        f_cmd_handlers[ a_key ] = a_func;
+        f_cmd_handlers.insert_or_assign( a_key, a_func );
         LDEBUG( dlog, "Set CMD handler for <" << a_key << ">" );
         return;
     }
 
+    void hub::register_get_handler( const std::string& a_key, const result_handler_func_t& a_func )
+    {
+        register_get_handler( a_key, wrap_result_handler( a_func ) );
+        return;
+    }
+
+    void hub::register_set_handler( const std::string& a_key, const result_handler_func_t& a_func )
+    {
+        register_set_handler( a_key, wrap_result_handler( a_func ) );
+        return;
+    }
+
+    void hub::register_cmd_handler( const std::string& a_key, const result_handler_func_t& a_func )
+    {
+        register_cmd_handler( a_key, wrap_result_handler( a_func ) );
+        return;
+    }
+
+    hub::handler_func_t hub::wrap_result_handler( const result_handler_func_t& a_func )
+    {
+        return [a_func]( const request_ptr_t a_request ){ return a_request->reply( a_func( a_request ) ); };
+    }
+
     void hub::remove_get_handler( const std::string& a_key )
     {
-        if( f_get_handlers.erase( a_key ) == 0 )
+        if( ! f_get_handlers.erase( a_key ) )
         {
             LWARN( dlog, "GET handler <" << a_key << "> was not present; nothing was removed" );
         }
@@ -84,7 +107,7 @@ namespace dripline
 
     void hub::remove_set_handler( const std::string& a_key )
     {
-        if( f_set_handlers.erase( a_key ) == 0 )
+        if( ! f_set_handlers.erase( a_key ) )
         {
             LWARN( dlog, "SET handler <" << a_key << "> was not present; nothing was removed" );
         }
@@ -97,7 +120,7 @@ namespace dripline
 
     void hub::remove_cmd_handler( const std::string& a_key )
     {
-        if( f_cmd_handlers.erase( a_key ) == 0 )
+        if( ! f_cmd_handlers.erase( a_key ) )
         {
             LWARN( dlog, "CMD handler <" << a_key << "> was not present; nothing was removed" );
         }
@@ -115,52 +138,46 @@ namespace dripline
 
     reply_ptr_t hub::do_get_request( const request_ptr_t a_request )
     {
-        std::string t_query_type = a_request->parsed_specifier().front();
+        std::string_view t_query_type = a_request->parsed_specifier().front();
         a_request->parsed_specifier().pop_front();
 
-        try
-        {
-            return f_get_handlers.at( t_query_type )( a_request );
-        }
-        catch( std::out_of_range& e )
+        const handler_func_t* t_handler = f_get_handlers.find( t_query_type );
+        if( ! t_handler )
         {
-            LWARN( dlog, "GET query type <" << t_query_type << "> was not understood (" << e.what() << ")" );
-            return a_request->reply( dl_service_error_bad_payload(), "Unrecognized query type or no query type provided: <" + t_query_type + ">" );;
+            LWARN( dlog, "GET query type <" << t_query_type << "> was not understood" );
+            return a_request->reply( dl_service_error_bad_payload(), "Unrecognized query type or no query type provided: <" + std::string( t_query_type ) + ">" );
         }
+        return (*t_handler)( a_request );
     }
 
     reply_ptr_t hub::do_set_request( const request_ptr_t a_request )
     {
-        std::string t_set_type = a_request->parsed_specifier().front();
+        std::string_view t_set_type = a_request->parsed_specifier().front();
         a_request->parsed_specifier().pop_front();
 
-        try
-        {
-            return f_set_handlers.at( t_set_type )( a_request );
-        }
-        catch( std::out_of_range& e )
+        const handler_func_t* t_handler = f_set_handlers.find( t_set_type );
+        if( ! t_handler )
         {
-            LWARN( dlog, "SET request <" << t_set_type << "> not understood (" << e.what() << ")" );
-            return a_request->reply( dl_service_error_bad_payload(), "Unrecognized set request type or no set request type provided: <" + t_set_type + ">" );
+            LWARN( dlog, "SET request <" << t_set_type << "> not understood" );
+            return a_request->reply( dl_service_error_bad_payload(), "Unrecognized set request type or no set request type provided: <" + std::string( t_set_type ) + ">" );
         }
+        return (*t_handler)( a_request );
     }
 
     reply_ptr_t hub::do_cmd_request( const request_ptr_t a_request )
     {
         // get the instruction before checking the lockout key authentication because we need to have the exception for
         // the unlock instruction that allows us to force the unlock.
-        std::string t_instruction = a_request->parsed_specifier().front();
+        std::string_view t_instruction = a_request->parsed_specifier().front();
         a_request->parsed_specifier().pop_front();
 
-        try
-        {
-            return f_cmd_handlers.at( t_instruction )( a_request );
-        }
-        catch( std::out_of_range& e )
+        const handler_func_t* t_handler = f_cmd_handlers.find( t_instruction );
+        if( ! t_handler )
         {
-            LWARN( dlog, "CMD instruction <" << t_instruction << "> not understood (" << e.what() << ")" );
-            return a_request->reply( dl_service_error_bad_payload(), "Instruction <" + t_instruction + "> not understood" );;
+            LWARN( dlog, "CMD instruction <" << t_instruction << "> not understood" );
+            return a_request->reply( dl_service_error_bad_payload(), "Instruction <" + std::string( t_instruction ) + "> not understood" );
         }
+        return (*t_handler)( a_request );
     }
 
 } /* namespace dripline */
@@ -10,9 +10,11 @@
 
 #include "service.hh"
 
+#include "dispatch_table.hh"
 #include "dripline_exceptions.hh"
+#include "reply_result.hh"
 
-#include <unordered_map>
+#include <functional>
 
 namespace dripline
 {
@@ -27,7 +29,7 @@ namespace dripline
      Hub is a tool to a Dripline API onto existing codebase.  Message-handler functions 
      in the codebase are mapped to Dripline run, command, get, and set requests.
 
-     The handler functions need to have the signature `reply_ptr_t( const request_ptr_t )`.  
+     The handler functions need to have the signature `reply_ptr_t( const request_ptr_t )` or `reply_result( const request_ptr_t )`.  
      Typically those handler functions will wrap another function in the codebase and provide the 
      tranlation between dripline message and the input/output of the function.
 
@@ -71,6 +73,7 @@ namespace dripline
     {
         private:
             typedef std::function< reply_ptr_t( const dripline::request_ptr_t ) > handler_func_t;
+            typedef std::function< reply_result( const dripline::request_ptr_t ) > result_handler_func_t;
 
         public:
             /* 
@@ -114,6 +117,13 @@ namespace dripline
             /// Sets a command request handler function
             void register_cmd_handler( const std::string& a_key, const handler_func_t& a_func );
 
+            /// Sets a get request handler function that returns a reply_result
+            void register_get_handler( const std::string& a_key, const result_handler_func_t& a_func );
+            /// Sets a set request handler function that returns a reply_result
+            void register_set_handler( const std::string& a_key, const result_handler_func_t& a_func );
+            /// Sets a command request handler function that returns a reply_result
+            void register_cmd_handler( const std::string& a_key, const result_handler_func_t& a_func );
+
             /// Removes a get request handler function
             void remove_get_handler( const std::string& a_key );
             /// Removes a set request handler function
@@ -131,9 +141,12 @@ namespace dripline
             virtual reply_ptr_t do_set_request( const request_ptr_t a_request );
             virtual reply_ptr_t do_cmd_request( const request_ptr_t a_request );
 
+            /// Makes a handler that turns the result of a_func into a reply
+            static handler_func_t wrap_result_handler( const result_handler_func_t& a_func );
+
             handler_func_t f_run_handler;
 
-            typedef std::unordered_map< std::string, handler_func_t > handler_funcs_t;
+            typedef dispatch_table< handler_func_t > handler_funcs_t;
             handler_funcs_t f_get_handlers;
             handler_funcs_t f_set_handlers;
             handler_funcs_t f_cmd_handlers;
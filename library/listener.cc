@@ -25,7 +25,21 @@ namespace dripline
             f_channel(),
             f_consumer_tag(),
             f_listen_timeout_ms( 1000 ),
-            f_listener_thread()
+            f_listener_thread(),
+            f_listening_mutex(),
+            f_listening_condition(),
+            f_listening( false )
+    {}
+
+    listener::listener( listener&& a_orig ) :
+            cancelable( std::move(a_orig) ),
+            f_channel( std::move(a_orig.f_channel) ),
+            f_consumer_tag( std::move(a_orig.f_consumer_tag) ),
+            f_listen_timeout_ms( a_orig.f_listen_timeout_ms ),
+            f_listener_thread( std::move(a_orig.f_listener_thread) ),
+            f_listening_mutex(),
+            f_listening_condition(),
+            f_listening( false )
     {}
 
     listener& listener::operator=( listener&& a_orig )
@@ -38,6 +52,22 @@ namespace dripline
         return *this;
     }
 
+    bool listener::wait_until_not_listening( unsigned a_timeout_ms )
+    {
+        std::unique_lock< std::mutex > t_lock( f_listening_mutex );
+        return f_listening_condition.wait_for( t_lock, std::chrono::milliseconds( a_timeout_ms ), [this](){ return ! f_listening; } );
+    }
+
+    void listener::set_listening( bool a_listening )
+    {
+        {
+            std::unique_lock< std::mutex > t_lock( f_listening_mutex );
+            f_listening = a_listening;
+        }
+        f_listening_condition.notify_all();
+        return;
+    }
+
     endpoint_listener_receiver::endpoint_listener_receiver( endpoint_ptr_t a_endpoint_ptr ) :
             scarab::cancelable(),
             listener_receiver(),
@@ -83,6 +113,12 @@ namespace dripline
                 continue;
             }
 
+            if( core::is_wake_token( t_envelope ) )
+            {
+                // left over from a cancellation that's been reset
+                continue;
+            }
+
             if( t_post_listen_status == core::post_listen_status::soft_error )
             {
                 LWARN( dlog, "A soft error ocurred while listening for messages for <" << f_endpoint->name() << ">.  The channel is still valid" );
@@ -15,6 +15,8 @@
 #include "cancelable.hh"
 #include "member_variables.hh"
 
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 namespace dripline
@@ -43,13 +45,17 @@ namespace dripline
      * A consumer tag
      * A timeout (in ms)
      * The thread object for listening
+
+     A class that listens (e.g. @ref service or @ref monitor) marks the start and end of listening with `set_listening()`, 
+     so that anything that has to wait for it to finish (e.g. its destructor) can use `wait_until_not_listening()` 
+     instead of waiting for a fixed time.
     */
     class DRIPLINE_API listener : public virtual scarab::cancelable
     {
         public:
             listener();
             listener( const listener& ) = delete;
-            listener( listener&& a_orig ) = default;
+            listener( listener&& a_orig );
             virtual ~listener() = default;
 
             listener& operator=( const listener& ) = delete;
@@ -65,6 +71,17 @@ namespace dripline
             mv_accessible( unsigned, listen_timeout_ms );
 
             mv_referrable( std::thread, listener_thread );
+
+            /// Waits until listening has ended (see `set_listening()`), for up to a_timeout_ms; returns true if it's not listening
+            bool wait_until_not_listening( unsigned a_timeout_ms );
+
+        protected:
+            /// Marks the start or end of listening, and wakes anything waiting for the end
+            void set_listening( bool a_listening );
+
+            std::mutex f_listening_mutex;
+            std::condition_variable f_listening_condition;
+            bool f_listening;
     };
 
     /*!
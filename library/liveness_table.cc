@@ -0,0 +1,177 @@
+/*
+ * liveness_table.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "liveness_table.hh"
+
+namespace dripline
+{
+
+    liveness_table::liveness_table( clock_t::duration a_default_interval, unsigned a_down_after ) :
+            f_default_interval( a_default_interval ),
+            f_down_after( a_down_after > 0 ? a_down_after : 1 ),
+            f_mutex(),
+            f_entries()
+    {}
+
+    bool liveness_table::record( const std::string& a_id, const std::string& a_name, const scarab::param_node& a_stats, change& a_change, clock_t::time_point a_now )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+
+        auto t_it = f_entries.find( a_id );
+        if( t_it == f_entries.end() )
+        {
+            entry t_entry;
+            t_entry.f_name = a_name;
+            t_entry.f_first_seen = a_now;
+            t_entry.f_last_seen = a_now;
+            t_entry.f_n_beats = 1;
+            t_entry.f_interval = f_default_interval;
+            t_entry.f_stats = a_stats;
+            f_entries.emplace( a_id, std::move(t_entry) );
+
+            a_change = change{ a_id, a_name, event::joined, 0, clock_t::duration::zero() };
+            return true;
+        }
+
+        entry& t_entry = t_it->second;
+        clock_t::duration t_gap = a_now - t_entry.f_last_seen;
+        bool t_recovered = t_entry.f_state != state::alive;
+        unsigned t_n_missed = t_entry.f_n_missed;
+
+        // the interval is learned only from heartbeats that arrive on time;
+        // it follows the first measured gap, and then moves a quarter of the way toward each new one
+        if( ! t_recovered && t_gap > clock_t::duration::zero() )
+        {
+            if( t_entry.f_n_beats == 1 ) t_entry.f_interval = t_gap;
+            else t_entry.f_interval += ( t_gap - t_entry.f_interval ) / 4;
+        }
+
+        t_entry.f_name = a_name;
+        t_entry.f_state = state::alive;
+        t_entry.f_last_seen = a_now;
+        ++t_entry.f_n_beats;
+        t_entry.f_n_missed = 0;
+        t_entry.f_stats = a_stats;
+
+        if( ! t_recovered ) return false;
+
+        a_change = change{ a_id, a_name, event::recovered, t_n_missed, t_gap };
+        return true;
+    }
+
+    std::vector< liveness_table::change > liveness_table::check( clock_t::time_point a_now )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+
+        std::vector< change > t_changes;
+        for( auto& t_id_entry : f_entries )
+        {
+            entry& t_entry = t_id_entry.second;
+            if( t_entry.f_interval <= clock_t::duration::zero() ) continue;
+
+            // heartbeat n+1 is missed when it hasn't arrived by half an interval after it was due
+            while( t_entry.f_state != state::down &&
+                   a_now > t_entry.f_last_seen + t_entry.f_interval * ( t_entry.f_n_missed + 1 ) + t_entry.f_interval / 2 )
+            {
+                ++t_entry.f_n_missed;
+                event t_event = event::missed;
+                if( t_entry.f_n_missed >= f_down_after )
+                {
+                    t_entry.f_state = state::down;
+                    t_event = event::down;
+                }
+                else
+                {
+                    t_entry.f_state = state::late;
+                }
+                t_changes.push_back( change{ t_id_entry.first, t_entry.f_name, t_event, t_entry.f_n_missed, a_now - t_entry.f_last_seen } );
+            }
+        }
+        return t_changes;
+    }
+
+    scarab::param_node liveness_table::snapshot( clock_t::time_point a_now ) const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+
+        scarab::param_node t_snapshot;
+        for( const auto& t_id_entry : f_entries )
+        {
+            const entry& t_entry = t_id_entry.second;
+            scarab::param_node t_service;
+            t_service.add( "name", t_entry.f_name );
+            t_service.add( "state", to_string( t_entry.f_state ) );
+            t_service.add( "last_seen_s", std::chrono::duration< double >( a_now - t_entry.f_last_seen ).count() );
+            t_service.add( "up_s", std::chrono::duration< double >( a_now - t_entry.f_first_seen ).count() );
+            t_service.add( "heartbeats", t_entry.f_n_beats );
+            t_service.add( "missed", t_entry.f_n_missed );
+            t_service.add( "interval_s", std::chrono::duration< double >( t_entry.f_interval ).count() );
+            if( ! t_entry.f_stats.empty() ) t_service.add( "stats", t_entry.f_stats );
+            t_snapshot.add( t_id_entry.first, std::move(t_service) );
+        }
+        return t_snapshot;
+    }
+
+    bool liveness_table::get_entry( const std::string& a_id, entry& an_entry ) const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        auto t_it = f_entries.find( a_id );
+        if( t_it == f_entries.end() ) return false;
+        an_entry = t_it->second;
+        return true;
+    }
+
+    unsigned liveness_table::size() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_entries.size();
+    }
+
+    unsigned liveness_table::count( state a_state ) const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        unsigned t_count = 0;
+        for( const auto& t_id_entry : f_entries )
+        {
+            if( t_id_entry.second.f_state == a_state ) ++t_count;
+        }
+        return t_count;
+    }
+
+    void liveness_table::clear()
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        f_entries.clear();
+        return;
+    }
+
+    std::string to_string( liveness_table::state a_state )
+    {
+        switch( a_state )
+        {
+            case liveness_table::state::alive: return "alive";
+            case liveness_table::state::late: return "late";
+            case liveness_table::state::down: return "down";
+        }
+        return "unknown";
+    }
+
+    std::string to_string( liveness_table::event an_event )
+    {
+        switch( an_event )
+        {
+            case liveness_table::event::joined: return "joined";
+            case liveness_table::event::recovered: return "recovered";
+            case liveness_table::event::missed: return "missed";
+            case liveness_table::event::down: return "down";
+        }
+        return "unknown";
+    }
+
+} /* namespace dripline */
@@ -0,0 +1,142 @@
+/*
+ * liveness_table.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_LIVENESS_TABLE_HH_
+#define DRIPLINE_LIVENESS_TABLE_HH_
+
+#include "dripline_api.hh"
+
+#include "member_variables.hh"
+#include "param_node.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dripline
+{
+
+    /*!
+     @class liveness_table
+     @author N.S. Oblath
+
+     @brief Keeps track of which services are alive from the heartbeats they send
+
+     @details
+     Each heartbeat (see @ref heartbeater) is recorded with `record()`, keyed by the heartbeat's `id`.  The table keeps the
+     service's name, when it was first and last seen, how many heartbeats it has sent, and the statistics from its most
+     recent heartbeat (the `stats` node, if the service includes one).
+
+     The interval between a service's heartbeats is learned from the heartbeats themselves; until a service has sent two,
+     it's assumed to be `default_interval`.  `check()` should be called regularly (e.g. from a timer); a service misses a
+     heartbeat when none arrives within one and a half intervals of the previous one, and again for each interval after that.
+     After `down_after` missed heartbeats it's considered down.  A heartbeat from a service that is late or down brings it back.
+
+     `record()` and `check()` report the changes (a service joining, missing a heartbeat, going down, or recovering), so that
+     they can be printed as they happen, and `snapshot()` gives the whole table.  All functions are thread-safe.
+    */
+    class DRIPLINE_API liveness_table
+    {
+        public:
+            typedef std::chrono::steady_clock clock_t;
+
+            enum class state
+            {
+                alive,
+                late, ///< Has missed at least one heartbeat
+                down ///< Has missed `down_after` heartbeats
+            };
+
+            enum class event
+            {
+                joined, ///< First heartbeat from a service
+                recovered, ///< Heartbeat from a service that was late or down
+                missed, ///< A service missed a heartbeat
+                down ///< A service missed `down_after` heartbeats
+            };
+
+            struct entry
+            {
+                std::string f_name;
+                state f_state = state::alive;
+                clock_t::time_point f_first_seen;
+                clock_t::time_point f_last_seen;
+                uint64_t f_n_beats = 0;
+                /// Number of heartbeats missed since the last one was received
+                unsigned f_n_missed = 0;
+                /// Expected time between heartbeats
+                clock_t::duration f_interval = clock_t::duration::zero();
+                scarab::param_node f_stats;
+            };
+
+            struct change
+            {
+                std::string f_id;
+                std::string f_name;
+                event f_event;
+                unsigned f_n_missed;
+                /// Time since the service's previous heartbeat
+                clock_t::duration f_since_last_seen;
+            };
+
+        public:
+            liveness_table( clock_t::duration a_default_interval = std::chrono::seconds(60), unsigned a_down_after = 3 );
+            liveness_table( const liveness_table& ) = delete;
+            liveness_table( liveness_table&& ) = delete;
+            virtual ~liveness_table() = default;
+
+            liveness_table& operator=( const liveness_table& ) = delete;
+            liveness_table& operator=( liveness_table&& ) = delete;
+
+            /// Records a heartbeat; returns true if it's a change (the service joined or recovered), which is put in a_change
+            bool record( const std::string& a_id, const std::string& a_name, const scarab::param_node& a_stats, change& a_change, clock_t::time_point a_now = clock_t::now() );
+
+            /// Finds the services that have missed heartbeats since the last check, and returns the changes
+            std::vector< change > check( clock_t::time_point a_now = clock_t::now() );
+
+            /*!
+             Returns the whole table, keyed by ID.  Each service has:
+               - `name`
+               - `state` -- `alive`, `late`, or `down`
+               - `last_seen_s` -- seconds since the last heartbeat
+               - `up_s` -- seconds since the first heartbeat
+               - `heartbeats` -- number of heartbeats received
+               - `missed` -- number of heartbeats missed since the last one received
+               - `interval_s` -- expected time between heartbeats
+               - `stats` -- statistics from the last heartbeat, if there were any
+            */
+            scarab::param_node snapshot( clock_t::time_point a_now = clock_t::now() ) const;
+
+            /// Gets the entry for a service; returns false if there isn't one
+            bool get_entry( const std::string& a_id, entry& an_entry ) const;
+
+            /// Number of services in the table
+            unsigned size() const;
+
+            /// Number of services in a particular state
+            unsigned count( state a_state ) const;
+
+            /// Removes all of the services
+            void clear();
+
+            mv_accessible( clock_t::duration, default_interval );
+            mv_accessible( unsigned, down_after );
+
+        protected:
+            mutable std::mutex f_mutex;
+            std::map< std::string, entry > f_entries;
+    };
+
+    DRIPLINE_API std::string to_string( liveness_table::state a_state );
+    DRIPLINE_API std::string to_string( liveness_table::event an_event );
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_LIVENESS_TABLE_HH_ */
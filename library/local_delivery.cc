@@ -0,0 +1,232 @@
+/*
+ * local_delivery.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "local_delivery.hh"
+
+#include "core.hh"
+#include "message.hh"
+#include "receiver.hh"
+#include "uuid.hh"
+
+#include "logger.hh"
+
+#include <algorithm>
+#include <chrono>
+
+LOGGER( dlog, "local_delivery" );
+
+namespace dripline
+{
+
+    namespace
+    {
+        std::vector< std::string > split_words( const std::string& a_key )
+        {
+            std::vector< std::string > t_words;
+            std::string::size_type t_start = 0;
+            while( true )
+            {
+                std::string::size_type t_dot = a_key.find( '.', t_start );
+                t_words.push_back( a_key.substr( t_start, t_dot - t_start ) );
+                if( t_dot == std::string::npos ) break;
+                t_start = t_dot + 1;
+            }
+            return t_words;
+        }
+
+        bool words_match( const std::vector< std::string >& a_binding, unsigned a_i_binding, const std::vector< std::string >& a_key, unsigned a_i_key )
+        {
+            if( a_i_binding == a_binding.size() ) return a_i_key == a_key.size();
+            if( a_binding[a_i_binding] == "#" )
+            {
+                // '#' can take any number of words, including none
+                for( unsigned i_next = a_i_key; i_next <= a_key.size(); ++i_next )
+                {
+                    if( words_match( a_binding, a_i_binding + 1, a_key, i_next ) ) return true;
+                }
+                return false;
+            }
+            if( a_i_key == a_key.size() ) return false;
+            if( a_binding[a_i_binding] != "*" && a_binding[a_i_binding] != a_key[a_i_key] ) return false;
+            return words_match( a_binding, a_i_binding + 1, a_key, a_i_key + 1 );
+        }
+    }
+
+    local_reply_box::~local_reply_box()
+    {
+        local_delivery* t_registry = local_delivery::get_instance();
+        std::unique_lock< std::mutex > t_lock( t_registry->f_mutex );
+        t_registry->f_reply_boxes.erase( f_reply_key );
+    }
+
+    const std::string local_delivery::s_reply_prefix( "dl_local_reply." );
+
+    local_delivery::local_delivery() :
+            f_mutex(),
+            f_targets(),
+            f_alert_subscribers(),
+            f_reply_boxes(),
+            f_reply_condition(),
+            f_next_reply_id( 0 ),
+            f_process_id( string_from_uuid( generate_random_uuid() ) )
+    {}
+
+    bool local_delivery::add_target( const std::string& a_name, concurrent_receiver* a_target )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        auto t_inserted = f_targets.insert( std::make_pair( a_name, a_target ) );
+        if( ! t_inserted.second && t_inserted.first->second != a_target )
+        {
+            LWARN( dlog, "A local target is already registered for <" << a_name << ">; requests to it will go to the first one" );
+            return false;
+        }
+        LDEBUG( dlog, "Registered local target <" << a_name << ">" );
+        return true;
+    }
+
+    void local_delivery::remove_target( const std::string& a_name, concurrent_receiver* a_target )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        auto t_target_it = f_targets.find( a_name );
+        if( t_target_it != f_targets.end() && t_target_it->second == a_target ) f_targets.erase( t_target_it );
+        return;
+    }
+
+    bool local_delivery::has_target( const std::string& a_name ) const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_targets.count( a_name ) != 0;
+    }
+
+    void local_delivery::add_alert_subscriber( const std::string& a_binding_key, concurrent_receiver* a_subscriber )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        f_alert_subscribers.push_back( std::make_pair( a_binding_key, a_subscriber ) );
+        return;
+    }
+
+    void local_delivery::remove_alert_subscriber( const std::string& a_binding_key, concurrent_receiver* a_subscriber )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        auto t_subscription = std::make_pair( a_binding_key, a_subscriber );
+        f_alert_subscribers.erase( std::remove( f_alert_subscribers.begin(), f_alert_subscribers.end(), t_subscription ), f_alert_subscribers.end() );
+        return;
+    }
+
+    sent_msg_pkg_ptr local_delivery::deliver_request( request_ptr_t a_request )
+    {
+        // the target's queue is named for the first word of the routing key
+        const std::string& t_routing_key = a_request->routing_key();
+        std::string t_target_name = t_routing_key.substr( 0, t_routing_key.find( '.' ) );
+
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        auto t_target_it = f_targets.find( t_target_name );
+        if( t_target_it == f_targets.end() ) return sent_msg_pkg_ptr();
+
+        // the handler modifies the request (e.g. it pops the specifier), so it gets a copy, and the sender's request is left as it was
+        request_ptr_t t_request = a_request->clone();
+        t_request->reply_to() = s_reply_prefix + std::to_string( f_next_reply_id++ );
+        LDEBUG( dlog, "Delivering request with routing key <" << t_routing_key << "> in-process" );
+        t_target_it->second->process_message( t_request );
+
+        // the box is only made once the target has the request, since its destructor takes the lock;
+        // a reply can't be delivered before the box is registered, because that also takes the lock
+        sent_msg_pkg_ptr t_sent_pkg = std::make_shared< sent_msg_pkg >();
+        t_sent_pkg->f_local_replies = std::make_shared< local_reply_box >();
+        t_sent_pkg->f_local_replies->f_reply_key = t_request->reply_to();
+        f_reply_boxes[ t_sent_pkg->f_local_replies->f_reply_key ] = t_sent_pkg->f_local_replies.get();
+
+        t_sent_pkg->f_successful_send = true;
+        return t_sent_pkg;
+    }
+
+    bool local_delivery::deliver_reply( reply_ptr_t a_reply )
+    {
+        if( ! is_local_reply_key( a_reply->routing_key() ) ) return false;
+
+        {
+            std::unique_lock< std::mutex > t_lock( f_mutex );
+            auto t_box_it = f_reply_boxes.find( a_reply->routing_key() );
+            if( t_box_it == f_reply_boxes.end() )
+            {
+                LDEBUG( dlog, "Nothing is waiting for the reply to <" << a_reply->routing_key() << "> any more; it will be dropped" );
+                return true;
+            }
+            t_box_it->second->f_replies.push_back( a_reply );
+        }
+        f_reply_condition.notify_all();
+        return true;
+    }
+
+    unsigned local_delivery::deliver_alert( alert_ptr_t a_alert )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        std::vector< concurrent_receiver* > t_subscribers;
+        for( const auto& t_subscription : f_alert_subscribers )
+        {
+            if( topic_matches( t_subscription.first, a_alert->routing_key() ) ) t_subscribers.push_back( t_subscription.second );
+        }
+
+        // the mark goes with the copy sent through the broker, so the subscribers here can drop that copy
+        a_alert->local_origin() = t_subscribers.empty() ? std::string() : f_process_id;
+        for( concurrent_receiver* t_subscriber : t_subscribers )
+        {
+            t_subscriber->process_message( a_alert );
+        }
+        return t_subscribers.size();
+    }
+
+    bool local_delivery::was_delivered_locally( const msg_alert& a_alert, const receiver* a_receiver ) const
+    {
+        if( a_alert.local_origin() != f_process_id ) return false;
+
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        for( const auto& t_subscription : f_alert_subscribers )
+        {
+            if( static_cast< const receiver* >( t_subscription.second ) == a_receiver && topic_matches( t_subscription.first, a_alert.routing_key() ) ) return true;
+        }
+        return false;
+    }
+
+    const std::string& local_delivery::process_id() const
+    {
+        return f_process_id;
+    }
+
+    bool local_delivery::wait_for_reply( const std::vector< sent_msg_pkg_ptr >& a_sent_pkgs, unsigned& a_index, reply_ptr_t& a_reply, unsigned a_timeout_ms )
+    {
+        auto t_take_reply = [&]() -> bool {
+            for( unsigned i_pkg = 0; i_pkg < a_sent_pkgs.size(); ++i_pkg )
+            {
+                const sent_msg_pkg_ptr& t_pkg = a_sent_pkgs[i_pkg];
+                if( ! t_pkg || ! t_pkg->f_local_replies || t_pkg->f_local_replies->f_replies.empty() ) continue;
+                a_reply = t_pkg->f_local_replies->f_replies.front();
+                t_pkg->f_local_replies->f_replies.pop_front();
+                a_index = i_pkg;
+                return true;
+            }
+            return false;
+        };
+
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        if( a_timeout_ms == 0 ) return t_take_reply();
+        return f_reply_condition.wait_for( t_lock, std::chrono::milliseconds(a_timeout_ms), t_take_reply );
+    }
+
+    bool local_delivery::is_local_reply_key( const std::string& a_routing_key )
+    {
+        return a_routing_key.compare( 0, s_reply_prefix.size(), s_reply_prefix ) == 0;
+    }
+
+    bool local_delivery::topic_matches( const std::string& a_binding_key, const std::string& a_routing_key )
+    {
+        return words_match( split_words( a_binding_key ), 0, split_words( a_routing_key ), 0 );
+    }
+
+} /* namespace dripline */
@@ -0,0 +1,140 @@
+/*
+ * local_delivery.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_LOCAL_DELIVERY_HH_
+#define DRIPLINE_LOCAL_DELIVERY_HH_
+
+#include "dripline_api.hh"
+#include "dripline_fwd.hh"
+
+#include "singleton.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dripline
+{
+    class concurrent_receiver;
+    class receiver;
+
+    /*!
+     @class local_reply_box
+     @author N.S. Oblath
+
+     @brief Holds the replies to a request that was delivered in-process, until they're waited for
+
+     @details
+     A box is created by @ref local_delivery for each request it delivers, and is kept in the request's @ref sent_msg_pkg.
+     Its contents are guarded by the local_delivery mutex.  When the box is destroyed, replies to its key are dropped.
+    */
+    struct DRIPLINE_API local_reply_box
+    {
+        std::string f_reply_key;
+        std::deque< reply_ptr_t > f_replies;
+        ~local_reply_box();
+    };
+
+    /*!
+     @class local_delivery
+     @author N.S. Oblath
+
+     @brief Process-wide registry of local services, so that messages between them can skip the broker
+
+     @details
+     When a client and the service it's sending a request to are in the same process, the request can be handed directly
+     to the service instead of being encoded, sent through the broker, and decoded (and likewise for the reply).
+
+     Services with `local_delivery` enabled register themselves, their synchronous children, and their asynchronous children
+     as targets when they start, by name, and remove themselves when they stop.  A @ref core with `local_delivery` enabled
+     then looks up the first word of each request's routing key (the name to which it's bound on the broker);
+     if there's a local target, the request message object itself is given to the target's `process_message()`,
+     and the request is given a reply-to key starting with `s_reply_prefix`.  The reply to such a request is put in the
+     @ref local_reply_box in the request's @ref sent_msg_pkg by `core::send()`, whether or not the replying service has
+     `local_delivery` enabled, and `receiver::wait_for_reply()` (and the other waiting functions) take it from there.
+     If there's no local target, the request is sent through the broker as usual.
+
+     Since the message objects are shared rather than copied, a sender should not modify a request after sending it.
+     Requests and replies delivered in-process are not seen by anything listening on the broker (e.g. a monitor).
+     Broadcast requests are always sent through the broker, unless a local service is named for the broadcast key.
+
+     Alerts are delivered in-process to the receivers subscribed here with `add_alert_subscriber()`, whose binding keys
+     (which can use the AMQP wildcards `*` and `#`) match the alert's routing key.  They're also sent through the broker,
+     for subscribers in other processes and for monitoring.  A subscriber is usually bound to the same keys on the broker
+     (a @ref monitor with `local_delivery` enabled subscribes to its alert keys), so an alert that was delivered in-process
+     is marked with this process's ID (`msg_alert::local_origin()`), and `receiver::decode_message()` drops the copy that
+     comes back through the broker to a receiver that already has it.
+
+     Targets and subscribers are concurrent_receivers, whose `process_message()` only queues the message; it's called
+     with the registry locked.  They must be removed before they're destroyed.
+    */
+    class DRIPLINE_API local_delivery : public scarab::singleton< local_delivery >
+    {
+        protected:
+            friend class scarab::singleton< local_delivery >;
+            friend class scarab::destroyer< local_delivery >;
+            friend struct local_reply_box;
+            local_delivery();
+            virtual ~local_delivery() = default;
+
+        public:
+            /// Beginning of the reply-to keys given to requests that are delivered in-process
+            static const std::string s_reply_prefix;
+
+            /// Registers a local target for requests to a_name; returns false if a different target is already registered for that name
+            bool add_target( const std::string& a_name, concurrent_receiver* a_target );
+            /// Removes the target for a_name, if it's a_target
+            void remove_target( const std::string& a_name, concurrent_receiver* a_target );
+            /// True if there's a local target for a_name
+            bool has_target( const std::string& a_name ) const;
+
+            /// Subscribes a receiver to the alerts sent in-process whose routing keys match a_binding_key
+            void add_alert_subscriber( const std::string& a_binding_key, concurrent_receiver* a_subscriber );
+            /// Removes a subscription
+            void remove_alert_subscriber( const std::string& a_binding_key, concurrent_receiver* a_subscriber );
+
+            /// Hands a request to the local target named by the first word of its routing key; returns an empty pointer if there isn't one
+            sent_msg_pkg_ptr deliver_request( request_ptr_t a_request );
+            /// Hands a reply to the local request it answers; returns false if its routing key isn't a local reply-to key
+            bool deliver_reply( reply_ptr_t a_reply );
+            /// Hands an alert to the matching local subscribers, marking it with `process_id()` if there are any; returns the number of subscribers it was given to
+            unsigned deliver_alert( alert_ptr_t a_alert );
+            /// True if a_alert, received through the broker, was sent from this process and was already delivered in-process to a_receiver
+            bool was_delivered_locally( const msg_alert& a_alert, const receiver* a_receiver ) const;
+
+            /// Unique ID of this process, used to recognize alerts that were delivered in-process
+            const std::string& process_id() const;
+
+            /// Waits up to a_timeout_ms (or not at all, if it's 0) for a reply to any of the requests in a_sent_pkgs that were delivered in-process.
+            /// Returns true if there was a reply, in which case it's put in a_reply, and a_index is the position of its request in a_sent_pkgs.
+            bool wait_for_reply( const std::vector< sent_msg_pkg_ptr >& a_sent_pkgs, unsigned& a_index, reply_ptr_t& a_reply, unsigned a_timeout_ms );
+
+            /// True if a_routing_key is the reply-to key of a request that was delivered in-process
+            static bool is_local_reply_key( const std::string& a_routing_key );
+
+            /// True if a_routing_key matches a_binding_key, following the AMQP topic-exchange rules (`*` matches one word, and `#` matches zero or more)
+            static bool topic_matches( const std::string& a_binding_key, const std::string& a_routing_key );
+
+        protected:
+            mutable std::mutex f_mutex;
+            std::map< std::string, concurrent_receiver* > f_targets;
+            std::vector< std::pair< std::string, concurrent_receiver* > > f_alert_subscribers;
+            std::map< std::string, local_reply_box* > f_reply_boxes;
+            std::condition_variable f_reply_condition;
+            std::atomic< uint64_t > f_next_reply_id;
+            const std::string f_process_id;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_LOCAL_DELIVERY_HH_ */
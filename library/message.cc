@@ -12,6 +12,7 @@
 #include "dripline_constants.hh"
 #include "dripline_exceptions.hh"
 #include "dripline_version.hh"
+#include "reply_result.hh"
 #include "version_store.hh"
 
 #include "logger.hh"
@@ -21,6 +22,7 @@
 #include "time.hh"
 #include "version_wrapper.hh"
 
+#include <chrono>
 #include <cmath>
 #include <map>
 
@@ -238,6 +240,24 @@ namespace dripline
                 t_request->lockout_key() = uuid_from_string( at( t_properties, std::string("lockout_key"), TableValue("") ).GetString(), t_lockout_key_valid );
                 t_request->set_lockout_key_valid( t_lockout_key_valid );
 
+                if( t_first_valid_message->PriorityIsSet() )
+                {
+                    t_request->set_priority( t_first_valid_message->Priority() );
+                }
+
+                if( t_first_valid_message->ExpirationIsSet() )
+                {
+                    try
+                    {
+                        t_request->set_ttl_ms( std::stoul( t_first_valid_message->Expiration() ) );
+                    }
+                    catch( const std::exception& )
+                    {
+                        LWARN( dlog, "Unable to interpret the message expiration: <" << t_first_valid_message->Expiration() << ">" );
+                    }
+                }
+                t_request->set_deadline_ms( at( t_properties, std::string("deadline_ms"), TableValue(uint64_t(0)) ).GetInteger() );
+
                 t_message = t_request;
                 break;
             }
@@ -261,6 +281,7 @@ namespace dripline
                         a_routing_key,
                         at( t_properties, std::string("specifier"), TableValue("") ).GetString(),
                         t_encoding);
+                t_alert->local_origin() = at( t_properties, std::string("local_origin"), TableValue("") ).GetString();
 
                 t_message = t_alert;
                 break;
@@ -474,7 +495,11 @@ namespace dripline
             message(),
             f_lockout_key( generate_nil_uuid() ),
             f_lockout_key_valid( true ),
-            f_message_operation( op_t::unknown )
+            f_message_operation( op_t::unknown ),
+            f_priority( 0 ),
+            f_ttl_ms( 0 ),
+            f_deadline_ms( 0 ),
+            f_receive_time( std::chrono::steady_clock::now() )
     {
         f_correlation_id = string_from_uuid( generate_random_uuid() );
     }
@@ -485,12 +510,53 @@ namespace dripline
         t_request->set_payload( std::move(a_payload) );
         t_request->set_message_operation( a_msg_op );
         t_request->routing_key() = a_routing_key;
-        t_request->parsed_specifier() = a_specifier;
+        t_request->parsed_specifier().parse( a_specifier );
         t_request->reply_to() = a_reply_to;
         t_request->set_encoding( a_encoding );
         return t_request;
     }
 
+    request_ptr_t msg_request::clone() const
+    {
+        request_ptr_t t_request = make_shared< msg_request >();
+        t_request->set_is_valid( f_is_valid );
+        t_request->routing_key() = f_routing_key;
+        t_request->correlation_id() = f_correlation_id;
+        t_request->message_id() = f_message_id;
+        t_request->reply_to() = f_reply_to;
+        t_request->set_encoding( f_encoding );
+        t_request->timestamp() = f_timestamp;
+        t_request->sender_exe() = f_sender_exe;
+        t_request->sender_hostname() = f_sender_hostname;
+        t_request->sender_username() = f_sender_username;
+        t_request->sender_service_name() = f_sender_service_name;
+        t_request->sender_versions() = f_sender_versions;
+        t_request->f_specifier = f_specifier;
+        t_request->set_payload( get_payload_ptr()->clone() );
+
+        t_request->lockout_key() = f_lockout_key;
+        t_request->set_lockout_key_valid( f_lockout_key_valid );
+        t_request->set_message_operation( f_message_operation );
+        t_request->set_priority( f_priority );
+        t_request->set_ttl_ms( f_ttl_ms );
+        t_request->set_deadline_ms( f_deadline_ms );
+        return t_request;
+    }
+
+    void msg_request::stamp_deadline()
+    {
+        if( f_ttl_ms == 0 || f_deadline_ms != 0 ) return;
+        f_deadline_ms = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::system_clock::now().time_since_epoch() ).count() + f_ttl_ms;
+        return;
+    }
+
+    bool msg_request::is_expired() const
+    {
+        if( f_deadline_ms == 0 ) return false;
+        uint64_t t_now_ms = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::system_clock::now().time_since_epoch() ).count();
+        return t_now_ms > f_deadline_ms;
+    }
+
     msg_t msg_request::s_message_type = msg_t::request;
 
     msg_t msg_request::message_type() const
@@ -499,6 +565,13 @@ namespace dripline
     }
 
 
+    reply_ptr_t msg_request::reply( reply_result&& a_result ) const
+    {
+        reply_ptr_t t_reply = msg_reply::create( a_result.get_return_code(), "", a_result.take_payload(), *this );
+        t_reply->return_message() = std::move( a_result.return_message() );
+        return t_reply;
+    }
+
     //*********
     // Reply
     //*********
@@ -523,7 +596,7 @@ namespace dripline
         t_reply->return_message() = a_ret_msg;
         t_reply->set_payload( std::move(a_payload) );
         t_reply->routing_key() = a_routing_key;
-        t_reply->parsed_specifier() = a_specifier;
+        t_reply->parsed_specifier().parse( a_specifier );
         t_reply->set_encoding( a_encoding );
         return t_reply;
     }
@@ -545,13 +618,14 @@ namespace dripline
         alert_ptr_t t_alert = make_shared< msg_alert >();
         t_alert->set_payload( std::move(a_payload) );
         t_alert->routing_key() = a_routing_key;
-        t_alert->parsed_specifier() = a_specifier;
+        t_alert->parsed_specifier().parse( a_specifier );
         t_alert->set_encoding( a_encoding );
         return t_alert;
     }
 
     msg_alert::msg_alert() :
-            message()
+            message(),
+            f_local_origin()
     {
         f_correlation_id = string_from_uuid( generate_random_uuid() );
     }
@@ -597,7 +671,10 @@ namespace dripline
         return operator==( static_cast< const message& >(a_lhs), static_cast< const message& >(a_rhs) ) &&
                 a_lhs.lockout_key() == a_rhs.lockout_key() &&
                 a_lhs.get_lockout_key_valid() == a_rhs.get_lockout_key_valid() &&
-                a_lhs.get_message_operation() == a_rhs.get_message_operation();
+                a_lhs.get_message_operation() == a_rhs.get_message_operation() &&
+                a_lhs.get_priority() == a_rhs.get_priority() &&
+                a_lhs.get_ttl_ms() == a_rhs.get_ttl_ms() &&
+                a_lhs.get_deadline_ms() == a_rhs.get_deadline_ms();
     }
 
     DRIPLINE_API bool operator==( const msg_reply& a_lhs, const msg_reply& a_rhs )
@@ -653,6 +730,9 @@ namespace dripline
         a_os << "Lockout Key: " << a_message.lockout_key() << '\n';
         a_os << "Lockout Key Valid: " << a_message.get_lockout_key_valid() << '\n';
         a_os << "Message Operation: " << a_message.get_message_operation() << '\n';
+        a_os << "Priority: " << a_message.get_priority() << '\n';
+        a_os << "TTL (ms): " << a_message.get_ttl_ms() << '\n';
+        a_os << "Deadline (ms): " << a_message.get_deadline_ms() << '\n';
         return a_os;
     }
 
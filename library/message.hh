@@ -19,6 +19,8 @@
 #include "specifier.hh"
 #include "uuid.hh"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <tuple>
 #include <string>
@@ -31,6 +33,7 @@ namespace scarab
 namespace dripline
 {
     class dripline_error;
+    class reply_result;
     struct return_code;
 
     //***********
@@ -174,6 +177,16 @@ namespace dripline
      @details
      Adds the lockout information and the message operation.
 
+     Requests can also carry a priority (0-255; 0 is the default and means "normal").  It's sent as the AMQP message priority, 
+     which is used by the broker if the destination queue was declared with a maximum priority (see `core::setup_queue()`), 
+     and it's used by @ref concurrent_receiver to decide which requests can skip ahead of the ones already waiting.
+
+     Requests can also have a time-to-live (`ttl_ms`; 0, the default, means no limit).  The TTL is sent as the AMQP message 
+     expiration, so that the broker drops the request if it waits in a queue for too long.  When the request is sent 
+     (see `core::send()`), the TTL is converted into a deadline (`deadline_ms`, in ms since the Unix epoch), which is sent in 
+     the message header.  The recipient uses `is_expired()` to avoid handling requests that the sender is no longer waiting for.  
+     Since the deadline is compared against the recipient's clock, the clocks of the sender and the recipient should be synchronized.
+
      Requests can be created using the static function `create()`.
     */
     class DRIPLINE_API msg_request : public message
@@ -190,6 +203,9 @@ namespace dripline
             /// Create a request message
             static request_ptr_t create( scarab::param_ptr_t a_payload, op_t a_msg_op, const std::string& a_routing_key, const std::string& a_specifier = "", const std::string& a_reply_to = "", message::encoding a_encoding = encoding::json );
 
+            /// Creates a copy of this request, with its own specifier and a copy of the payload; the copy's receive time is the time it was made
+            request_ptr_t clone() const;
+
             bool is_request() const;
             bool is_reply() const;
             bool is_alert() const;
@@ -198,6 +214,13 @@ namespace dripline
             reply_ptr_t reply( const return_code& a_return_code, const std::string& a_ret_msg, scarab::param_ptr_t a_payload = scarab::param_ptr_t( new scarab::param() ) ) const;
             /// Creates a reply message using the reply-to and correlation ID information in this message
             reply_ptr_t reply( const unsigned a_return_code, const std::string& a_ret_msg, scarab::param_ptr_t a_payload = scarab::param_ptr_t( new scarab::param() ) ) const;
+            /// Creates a reply message from a handler's result, moving the return message and payload into the reply
+            reply_ptr_t reply( reply_result&& a_result ) const;
+
+            /// Sets the deadline from the TTL, if the TTL is set and the deadline is not
+            void stamp_deadline();
+            /// Returns true if the request has a deadline and it has passed
+            bool is_expired() const;
 
         private:
             void derived_modify_amqp_message( amqp_message_ptr a_amqp_msg, AmqpClient::Table& a_properties ) const;
@@ -210,6 +233,14 @@ namespace dripline
             mv_referrable( uuid_t, lockout_key );
             mv_accessible( bool, lockout_key_valid );
             mv_accessible( op_t, message_operation );
+            /// Request priority; 0 is normal priority, and values above 255 are treated as 255
+            mv_accessible( unsigned, priority );
+            /// Time-to-live in ms; 0 means the request does not expire
+            mv_accessible( unsigned, ttl_ms );
+            /// Deadline in ms since the Unix epoch; 0 means the request does not expire
+            mv_accessible( uint64_t, deadline_ms );
+            /// Local time at which the request object was created; for requests that arrive from the broker, this is when it was received
+            mv_accessible( std::chrono::steady_clock::time_point, receive_time );
 
     };
 
@@ -322,6 +353,9 @@ namespace dripline
             virtual msg_t message_type() const;
             mv_accessible_static_noset( msg_t, message_type );
 
+            /// ID of the process (see `local_delivery::process_id()`) that also delivered the alert to its local subscribers; empty if it didn't
+            mv_referrable( std::string, local_origin );
+
     };
 
     DRIPLINE_API bool operator==( const msg_alert& a_lhs, const msg_alert& a_rhs );
@@ -381,10 +415,22 @@ namespace dripline
         return false;
     }
 
-    inline void msg_request::derived_modify_amqp_message( amqp_message_ptr /*a_amqp_msg*/, AmqpClient::Table& a_properties ) const
+    inline void msg_request::derived_modify_amqp_message( amqp_message_ptr a_amqp_msg, AmqpClient::Table& a_properties ) const
     {
         a_properties.insert( AmqpClient::TableEntry( "message_operation", AmqpClient::TableValue(to_uint(f_message_operation)) ) );
         a_properties.insert( AmqpClient::TableEntry( "lockout_key", AmqpClient::TableValue(string_from_uuid(lockout_key())) ) );
+        if( f_priority > 0 )
+        {
+            a_amqp_msg->Priority( static_cast< uint8_t >( std::min( f_priority, 255U ) ) );
+        }
+        if( f_ttl_ms > 0 )
+        {
+            a_amqp_msg->Expiration( std::to_string( f_ttl_ms ) );
+        }
+        if( f_deadline_ms > 0 )
+        {
+            a_properties.insert( AmqpClient::TableEntry( "deadline_ms", AmqpClient::TableValue( f_deadline_ms ) ) );
+        }
         return;
     }
 
@@ -392,6 +438,9 @@ namespace dripline
     {
         a_message_node.add( "message_operation", to_uint(f_message_operation) );
         a_message_node.add( "lockout_key", string_from_uuid(lockout_key()) );
+        a_message_node.add( "priority", f_priority );
+        a_message_node.add( "ttl_ms", f_ttl_ms );
+        a_message_node.add( "deadline_ms", f_deadline_ms );
         return;
     }
 
@@ -467,8 +516,12 @@ namespace dripline
         return true;
     }
 
-    inline void msg_alert::derived_modify_amqp_message( amqp_message_ptr, AmqpClient::Table& ) const
+    inline void msg_alert::derived_modify_amqp_message( amqp_message_ptr, AmqpClient::Table& a_properties ) const
     {
+        if( ! f_local_origin.empty() )
+        {
+            a_properties.insert( AmqpClient::TableEntry( "local_origin", AmqpClient::TableValue(f_local_origin) ) );
+        }
         return;
     }
 
@@ -10,16 +10,22 @@
 #include "monitor.hh"
 
 #include "dripline_exceptions.hh"
+#include "local_delivery.hh"
+#include "timer_service.hh"
 #include "uuid.hh"
 
 #include "logger.hh"
 #include "signal_handler.hh"
 
+#include <csignal>
+
 LOGGER( dlog, "monitor" );
 
 namespace dripline
 {
 
+    std::atomic< bool > monitor::s_liveness_snapshot_requested( false );
+
     monitor::monitor( const scarab::param_node& a_config, const scarab::authentication& a_auth ) :
             scarab::cancelable(),
             core( a_config["dripline_mesh"].as_node(), a_auth ),
@@ -29,7 +35,12 @@ namespace dripline
             f_json_print( false ),
             f_pretty_print( false ),
             f_requests_keys(),
-            f_alerts_keys()
+            f_alerts_keys(),
+            f_liveness(),
+            f_liveness_check_ms( a_config.get_value( "liveness_check_ms", 1000U ) ),
+            f_liveness_snapshot_s( a_config.get_value( "liveness_snapshot_s", 0U ) ),
+            f_liveness_timer_id( -1 ),
+            f_last_liveness_snapshot()
     {
         // get requests keys
         if( a_config.has( "request_keys" ) && a_config["request_keys"].is_array() )
@@ -66,14 +77,29 @@ namespace dripline
             LPROG( dlog, "Monitor <" << f_name << "> will monitor key <" << a_config["alert_key"]().as_string() << "> on the alerts exchange" );
             f_alerts_keys.push_back( a_config["alert_key"]().as_string() );
         }
+
+        // liveness mode: heartbeats go to the liveness table
+        if( a_config.get_value( "liveness", false ) )
+        {
+            f_liveness = std::make_shared< liveness_table >( std::chrono::seconds( a_config.get_value( "liveness_interval_s", 60U ) ),
+                                                             a_config.get_value( "liveness_down_after", 3U ) );
+            std::string t_heartbeat_key = f_heartbeat_routing_key + ".#";
+            LPROG( dlog, "Monitor <" << f_name << "> will keep track of services from their heartbeats, with key <" << t_heartbeat_key << "> on the alerts exchange" );
+            f_alerts_keys.push_back( t_heartbeat_key );
+        }
     }
 
     monitor::~monitor()
     {
+        stop_liveness_timer();
         if( f_status >= status::listening )
         {
             this->cancel( dl_success().rc_value() );
-            std::this_thread::sleep_for( std::chrono::milliseconds(1100) );
+            // cancellation wakes the listener, so this normally returns as soon as listen() has finished
+            if( ! wait_until_not_listening( f_listen_timeout_ms ) )
+            {
+                LWARN( dlog, "Monitor <" << f_name << "> is still listening while being destroyed" );
+            }
         }
         if( f_status > status::exchange_declared ) stop();
     }
@@ -129,34 +155,43 @@ namespace dripline
         }
 
         f_status = status::listening;
+        set_listening( true );
 
         try
         {
             f_receiver_thread = std::thread( &concurrent_receiver::execute, this );
 
+            start_liveness_timer();
+
             if( ! listen_on_queue() )
             {
                 throw dripline_error() << "Something went wrong while listening for messages";
             }
 
+            stop_liveness_timer();
+
             f_receiver_thread.join();
         }
         catch( std::system_error& e )
         {
             LERROR( dlog, "Could not start the a thread due to a system error: " << e.what() );
+            set_listening( false );
             return false;
         }
         catch( dripline_error& e )
         {
             LERROR( dlog, "Dripline error while running monitor: " << e.what() );
+            set_listening( false );
             return false;
         }
         catch( std::exception& e )
         {
             LERROR( dlog, "Error while running monitor: " << e.what() );
+            set_listening( false );
             return false;
         }
 
+        set_listening( false );
         return true;
 
     }
@@ -165,6 +200,16 @@ namespace dripline
     {
         LINFO( dlog, "Stopping message monitor <" << f_name << ">" );
 
+        stop_liveness_timer();
+
+        if( f_local_delivery )
+        {
+            for( auto t_al_key_it = f_alerts_keys.begin(); t_al_key_it != f_alerts_keys.end(); ++t_al_key_it )
+            {
+                local_delivery::get_instance()->remove_alert_subscriber( *t_al_key_it, this );
+            }
+        }
+
         if( f_status >= status::listening ) // listening
         {
             this->cancel( dl_success().rc_value() );
@@ -200,6 +245,15 @@ namespace dripline
             if( ! bind_key( f_channel, f_alerts_exchange, f_name, *t_al_key_it ) ) return false;
         }
 
+        // alerts from this process are delivered directly; the copies that come through the broker are dropped
+        if( f_local_delivery )
+        {
+            for( auto t_al_key_it = f_alerts_keys.begin(); t_al_key_it != f_alerts_keys.end(); ++t_al_key_it )
+            {
+                local_delivery::get_instance()->add_alert_subscriber( *t_al_key_it, this );
+            }
+        }
+
         return true;
     }
 
@@ -225,6 +279,12 @@ namespace dripline
                 continue;
             }
 
+            if( core::is_wake_token( t_envelope ) )
+            {
+                // left over from a cancellation that's been reset
+                continue;
+            }
+
             if( t_post_listen_status == core::post_listen_status::soft_error )
             {
                 LWARN( dlog, "A soft error ocurred while listening for messages for monitor <" << f_name << ">.  The channel is still valid" );
@@ -260,6 +320,14 @@ namespace dripline
     {
         try
         {
+            // in liveness mode, heartbeats are summarized by the liveness table instead of being printed
+            if( f_liveness && a_message->is_alert() &&
+                a_message->routing_key().compare( 0, f_heartbeat_routing_key.size() + 1, f_heartbeat_routing_key + "." ) == 0 )
+            {
+                handle_heartbeat( a_message );
+                return;
+            }
+
             if( ! f_json_print && ! f_pretty_print )
             {
                 if( a_message->is_request() )
@@ -304,4 +372,114 @@ namespace dripline
         return;
     }
 
+    void monitor::do_cancellation( int a_code )
+    {
+        LDEBUG( dlog, "Canceling monitor <" << f_name << ">" );
+        // wake up the threads that are waiting, instead of leaving them until their next timeout
+        concurrent_receiver::do_cancellation( a_code );
+        if( f_status >= status::listening ) wake_queues( std::vector< std::string >{ f_name } );
+        return;
+    }
+
+    void monitor::print_liveness_snapshot()
+    {
+        if( ! f_liveness ) return;
+
+        f_last_liveness_snapshot = liveness_table::clock_t::now();
+        scarab::param_node t_snapshot = f_liveness->snapshot( f_last_liveness_snapshot );
+        LPROG( dlog, "Liveness: " << f_liveness->count( liveness_table::state::alive ) << " alive, " <<
+                f_liveness->count( liveness_table::state::late ) << " late, " <<
+                f_liveness->count( liveness_table::state::down ) << " down\n" << t_snapshot );
+        return;
+    }
+
+    void monitor::request_liveness_snapshot( int )
+    {
+        s_liveness_snapshot_requested.store( true );
+        return;
+    }
+
+    void monitor::handle_heartbeat( const message_ptr_t& a_message )
+    {
+        if( ! a_message->payload().is_node() )
+        {
+            LWARN( dlog, "Heartbeat on <" << a_message->routing_key() << "> has no payload" );
+            return;
+        }
+        const scarab::param_node& t_payload = a_message->payload().as_node();
+
+        // the ID is what identifies a service; the routing key is used if a heartbeat doesn't have one
+        std::string t_name = t_payload.get_value( "name", a_message->routing_key().substr( f_heartbeat_routing_key.size() + 1 ) );
+        std::string t_id = t_payload.get_value( "id", t_name );
+        scarab::param_node t_stats;
+        if( t_payload.has( "stats" ) && t_payload["stats"].is_node() ) t_stats = t_payload["stats"].as_node();
+
+        liveness_table::change t_change;
+        if( f_liveness->record( t_id, t_name, t_stats, t_change ) ) print_liveness_change( t_change );
+        return;
+    }
+
+    void monitor::check_liveness()
+    {
+        for( const liveness_table::change& t_change : f_liveness->check() )
+        {
+            print_liveness_change( t_change );
+        }
+
+        bool t_snapshot_due = f_liveness_snapshot_s > 0 &&
+                liveness_table::clock_t::now() - f_last_liveness_snapshot >= std::chrono::seconds( f_liveness_snapshot_s );
+        if( s_liveness_snapshot_requested.exchange( false ) || t_snapshot_due ) print_liveness_snapshot();
+        return;
+    }
+
+    void monitor::print_liveness_change( const liveness_table::change& a_change )
+    {
+        long t_since_s = std::chrono::duration_cast< std::chrono::seconds >( a_change.f_since_last_seen ).count();
+        switch( a_change.f_event )
+        {
+            case liveness_table::event::joined:
+                LPROG( dlog, "Service <" << a_change.f_name << "> (" << a_change.f_id << ") joined" );
+                break;
+            case liveness_table::event::recovered:
+                LPROG( dlog, "Service <" << a_change.f_name << "> (" << a_change.f_id << ") recovered after missing " << a_change.f_n_missed << " heartbeat(s); last seen " << t_since_s << " s ago" );
+                break;
+            case liveness_table::event::missed:
+                LPROG( dlog, "Service <" << a_change.f_name << "> (" << a_change.f_id << ") missed " << a_change.f_n_missed << " heartbeat(s); last seen " << t_since_s << " s ago" );
+                break;
+            case liveness_table::event::down:
+                LPROG( dlog, "Service <" << a_change.f_name << "> (" << a_change.f_id << ") is down after missing " << a_change.f_n_missed << " heartbeats; last seen " << t_since_s << " s ago" );
+                break;
+        }
+        return;
+    }
+
+    void monitor::start_liveness_timer()
+    {
+        if( ! f_liveness || f_liveness_timer_id >= 0 ) return;
+
+#ifdef SIGUSR1
+        std::signal( SIGUSR1, &monitor::request_liveness_snapshot );
+        LPROG( dlog, "Send SIGUSR1 to print a snapshot of the services on the mesh" );
+#endif
+
+        f_last_liveness_snapshot = liveness_table::clock_t::now();
+        std::chrono::milliseconds t_interval( f_liveness_check_ms > 0 ? f_liveness_check_ms : 1000 );
+        f_liveness_timer_id = timer_service::get_instance()->schedule( [this](){ check_liveness(); }, t_interval,
+                timer_service::clock_t::now() + t_interval, missed_tick_policy::coalesce );
+        return;
+    }
+
+    void monitor::stop_liveness_timer()
+    {
+        if( f_liveness_timer_id < 0 ) return;
+
+        timer_service::get_instance()->cancel_timer( f_liveness_timer_id );
+        f_liveness_timer_id = -1;
+
+#ifdef SIGUSR1
+        std::signal( SIGUSR1, SIG_DFL );
+#endif
+        return;
+    }
+
 } /* namespace dripline */
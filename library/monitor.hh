@@ -10,8 +10,12 @@
 
 #include "core.hh"
 #include "listener.hh"
+#include "liveness_table.hh"
 #include "receiver.hh"
 
+#include <atomic>
+#include <chrono>
+
 namespace scarab
 {
     class authentication;
@@ -40,6 +44,20 @@ namespace DRIPLINE_API dripline
      When activated, the alerts keys are bound to the alerts exchange, and the 
      requests keys are bound to the requests exchange.  The monitor then waits to receive 
      a message.  When a message is seen, it prints it to stdout.
+
+     In liveness mode (`liveness` set to true in the configuration), the monitor also binds to the heartbeats
+     (`[heartbeat_routing_key].#` on the alerts exchange) and keeps a @ref liveness_table of the services on the mesh.
+     Instead of printing each heartbeat, it prints the changes: services joining, missing heartbeats, going down, and
+     recovering.  Missed heartbeats are checked for on a timer (see @ref timer_service).  A snapshot of the whole table
+     is printed every `liveness_snapshot_s` seconds (if non-zero), when the process receives SIGUSR1 (where available),
+     and when `print_liveness_snapshot()` is called.
+
+     Liveness configuration options:
+       - `liveness` (bool; default: false) -- Keep track of the services on the mesh from their heartbeats
+       - `liveness_interval_s` (unsigned int; default: 60) -- Heartbeat interval assumed until a service has sent two heartbeats
+       - `liveness_down_after` (unsigned int; default: 3) -- Number of missed heartbeats after which a service is down
+       - `liveness_check_ms` (unsigned int; default: 1000) -- Time between checks for missed heartbeats
+       - `liveness_snapshot_s` (unsigned int; default: 0) -- Time between snapshots of the table; 0 means only on request
     */
     class monitor :
             public core,
@@ -83,6 +101,13 @@ namespace DRIPLINE_API dripline
             /// Set of alerts keys to be listened for.
             mv_referrable( keys_t, alerts_keys );
 
+            /// Table of the services seen on the mesh; only present in liveness mode
+            mv_accessible( std::shared_ptr< liveness_table >, liveness );
+            /// Time between checks for missed heartbeats, in ms
+            mv_accessible( unsigned, liveness_check_ms );
+            /// Time between snapshots of the liveness table, in s; 0 means snapshots are only printed on request
+            mv_accessible( unsigned, liveness_snapshot_s );
+
         public:
             /// Opens the AMQP connection, binds keys, and starts consuming.
             bool start();
@@ -93,9 +118,32 @@ namespace DRIPLINE_API dripline
             /// Stops listening for messages and closes the AMQP connection.
             bool stop();
 
+            /// Prints the whole liveness table (only in liveness mode)
+            void print_liveness_snapshot();
+
+            /// Asks the liveness timer to print a snapshot at its next check; safe to call from a signal handler
+            static void request_liveness_snapshot( int a_signal = 0 );
+
         protected:
             bool bind_keys();
 
+            /// Records a heartbeat in the liveness table, and prints the change if there is one
+            void handle_heartbeat( const message_ptr_t& a_message );
+            /// Checks for missed heartbeats, and prints the changes and any snapshot that's due
+            void check_liveness();
+            void print_liveness_change( const liveness_table::change& a_change );
+
+            void start_liveness_timer();
+            void stop_liveness_timer();
+
+            /// Wakes the listener and receiver threads
+            virtual void do_cancellation( int a_code );
+
+            int f_liveness_timer_id;
+            liveness_table::clock_t::time_point f_last_liveness_snapshot;
+
+            static std::atomic< bool > s_liveness_snapshot_requested;
+
         public:
             /// Waits for a single AMQP message and processes it.
             /// Returns false if the return is due to an error in this function; returns true otherwise (namely because it was canceled)
@@ -0,0 +1,176 @@
+/*
+ * pool_executor.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "pool_executor.hh"
+
+#include "worker_pool.hh"
+
+#include "logger.hh"
+
+#include <string>
+
+namespace dripline
+{
+    LOGGER( dlog, "pool_executor" );
+
+    pool_executor::pool_executor( unsigned a_n_threads, overlap_policy a_overlap ) :
+            base_executor(),
+            f_n_threads( a_n_threads > 0 ? a_n_threads : 1 ),
+            f_overlap( a_overlap ),
+            f_mutex(),
+            f_pool(),
+            f_active_events(),
+            f_n_skipped( 0 ),
+            f_n_unkeyed( 0 )
+    {}
+
+    pool_executor::~pool_executor()
+    {
+        stop();
+    }
+
+    namespace
+    {
+        // the executor and event whose executable is running on this thread, if any
+        thread_local const pool_executor* s_running_executor = nullptr;
+        thread_local int s_running_event_id = -1;
+
+        struct running_marker
+        {
+            running_marker( const pool_executor* an_executor, int an_event_id )
+            {
+                s_running_executor = an_executor;
+                s_running_event_id = an_event_id;
+            }
+            ~running_marker()
+            {
+                s_running_executor = nullptr;
+                s_running_event_id = -1;
+            }
+        };
+    }
+
+    void pool_executor::operator()( const std::function< void() >& an_executable )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        // each unkeyed executable gets its own strand, so it doesn't wait for anything else
+        pool().submit( "unkeyed-" + std::to_string( f_n_unkeyed++ ), [this, an_executable](){
+            running_marker t_marker( this, -1 );
+            an_executable();
+        } );
+        return;
+    }
+
+    void pool_executor::operator()( const std::function< void() >& an_executable, int an_event_id )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        unsigned& t_n_active = f_active_events[ an_event_id ];
+        if( f_overlap == overlap_policy::skip && t_n_active > 0 )
+        {
+            ++f_n_skipped;
+            LDEBUG( dlog, "Skipping a run of event <" << an_event_id << "> because the previous run hasn't finished" );
+            return;
+        }
+        ++t_n_active;
+
+        auto t_run = [this, an_executable, an_event_id](){ run_event( an_executable, an_event_id ); };
+        if( f_overlap == overlap_policy::allow )
+        {
+            pool().submit( "unkeyed-" + std::to_string( f_n_unkeyed++ ), std::move(t_run) );
+        }
+        else
+        {
+            // the worker pool runs the tasks in a strand one at a time, in order
+            pool().submit( "event-" + std::to_string( an_event_id ), std::move(t_run) );
+        }
+        return;
+    }
+
+    void pool_executor::run_event( const std::function< void() >& an_executable, int an_event_id )
+    {
+        auto t_finish = [this, an_event_id](){
+            std::unique_lock< std::mutex > t_lock( f_mutex );
+            auto t_active_it = f_active_events.find( an_event_id );
+            if( t_active_it != f_active_events.end() && --t_active_it->second == 0 )
+            {
+                f_active_events.erase( t_active_it );
+                f_inactive_condition.notify_all();
+            }
+        };
+
+        try
+        {
+            running_marker t_marker( this, an_event_id );
+            an_executable();
+        }
+        catch( ... )
+        {
+            t_finish();
+            throw;
+        }
+        t_finish();
+        return;
+    }
+
+    void pool_executor::stop()
+    {
+        std::unique_ptr< worker_pool > t_pool;
+        {
+            std::unique_lock< std::mutex > t_lock( f_mutex );
+            t_pool.swap( f_pool );
+        }
+        // the lock isn't held while waiting, since running events need it to finish
+        if( t_pool ) t_pool->stop();
+
+        // the runs that hadn't started were dropped
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        f_active_events.clear();
+        f_inactive_condition.notify_all();
+        return;
+    }
+
+    uint64_t pool_executor::n_skipped() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_n_skipped;
+    }
+
+    bool pool_executor::is_active( int an_event_id ) const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_active_events.count( an_event_id ) != 0;
+    }
+
+    void pool_executor::wait_until_inactive( int an_event_id )
+    {
+        // the run on this thread can't finish while it's waiting for itself
+        if( s_running_executor == this && s_running_event_id == an_event_id ) return;
+
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        f_inactive_condition.wait( t_lock, [this, an_event_id](){ return f_active_events.count( an_event_id ) == 0; } );
+        return;
+    }
+
+    bool pool_executor::in_event() const
+    {
+        return s_running_executor == this;
+    }
+
+    worker_pool& pool_executor::pool()
+    {
+        if( ! f_pool )
+        {
+            LDEBUG( dlog, "Starting " << f_n_threads << " worker thread(s)" );
+            f_pool.reset( new worker_pool() );
+            f_pool->start( f_n_threads );
+        }
+        return *f_pool;
+    }
+
+} /* namespace dripline */
@@ -0,0 +1,109 @@
+/*
+ * pool_executor.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_POOL_EXECUTOR_HH_
+#define DRIPLINE_POOL_EXECUTOR_HH_
+
+#include "scheduler.hh"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace dripline
+{
+    class worker_pool;
+
+    /*!
+     @class pool_executor
+     @author N.S. Oblath
+
+     @brief Executor for @ref scheduler that runs events on a pool of worker threads
+
+     @details
+     With @ref simple_executor, the scheduler thread runs each event itself, so a slow event delays every event
+     scheduled after it.  A pool_executor hands each event to a @ref worker_pool and returns right away, so events
+     run on up to `n_threads` workers while the scheduler thread keeps time.  Use it as the scheduler's executor:
+     `scheduler< pool_executor >`.
+
+     The scheduler gives the executor each event's ID, which is used to decide what to do when a repeating event
+     comes due while its previous run is still waiting or running (`overlap`):
+       * `overlap_policy::serialize` (default) -- the new run waits until the previous one finishes; runs of the same
+         event never overlap, and none are dropped
+       * `overlap_policy::skip` -- the new run is dropped (and counted in `n_skipped()`); the event runs again at its
+         next scheduled time
+       * `overlap_policy::allow` -- runs of the same event can run at the same time
+
+     `wait_until_inactive()` waits for the runs of an event that have been handed to the executor, so that an event
+     that has been unscheduled can be known not to be running (as @ref timer_service does when a timer is canceled).
+
+     The threads are started when the first event is executed, so `n_threads` can be changed until then
+     (e.g. via `scheduler::the_executor()`).  Destroying the executor waits for the events that are running,
+     and drops the ones that have not started.
+
+     Exceptions that escape from an event are logged and dropped.
+    */
+    class DRIPLINE_API pool_executor : public base_executor
+    {
+        public:
+            enum class overlap_policy
+            {
+                serialize, ///< Runs of the same event wait for each other
+                skip, ///< A run is dropped if the previous run of the same event hasn't finished
+                allow ///< Runs of the same event can overlap
+            };
+
+        public:
+            pool_executor( unsigned a_n_threads = 4, overlap_policy a_overlap = overlap_policy::serialize );
+            pool_executor( const pool_executor& ) = delete;
+            pool_executor( pool_executor&& ) = delete;
+            virtual ~pool_executor();
+
+            pool_executor& operator=( const pool_executor& ) = delete;
+            pool_executor& operator=( pool_executor&& ) = delete;
+
+            /// Runs an executable that isn't associated with an event; it can run alongside anything else
+            virtual void operator()( const std::function< void() >& an_executable );
+            /// Runs an event, applying the overlap policy
+            void operator()( const std::function< void() >& an_executable, int an_event_id );
+
+            /// Waits for the running events to finish and drops the ones that haven't started
+            void stop();
+
+            /// Number of runs dropped by the `skip` policy
+            uint64_t n_skipped() const;
+            /// True if a run of the event is waiting or running
+            bool is_active( int an_event_id ) const;
+            /// Waits until no run of the event is waiting or running; returns right away if called from a run of that event
+            void wait_until_inactive( int an_event_id );
+            /// True if called from an executable that this executor is running
+            bool in_event() const;
+
+            mv_accessible( unsigned, n_threads );
+            mv_accessible( overlap_policy, overlap );
+
+        protected:
+            /// Starts the pool if it's not running yet; the mutex must be locked
+            worker_pool& pool();
+
+            /// Runs an event's executable, and removes it from the active events when it's done; called on a worker thread
+            void run_event( const std::function< void() >& an_executable, int an_event_id );
+
+            mutable std::mutex f_mutex;
+            std::unique_ptr< worker_pool > f_pool;
+            /// Number of runs waiting or running for each event that has any
+            std::map< int, unsigned > f_active_events;
+            std::condition_variable f_inactive_condition;
+            uint64_t f_n_skipped;
+            uint64_t f_n_unkeyed;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_POOL_EXECUTOR_HH_ */
@@ -10,11 +10,18 @@
 #include "receiver.hh"
 
 #include "dripline_exceptions.hh"
+#include "endpoint.hh"
+#include "local_delivery.hh"
 #include "message.hh"
+#include "timer_service.hh"
+#include "worker_pool.hh"
 
 #include "logger.hh"
 #include "signal_handler.hh"
 
+#include <algorithm>
+#include <map>
+
 LOGGER( dlog, "receiver" );
 
 namespace dripline
@@ -23,9 +30,7 @@ namespace dripline
             f_messages(),
             f_chunks_received(),
             f_routing_key(),
-            f_thread(),
-            f_mutex(),
-            f_conv(),
+            f_timer_id( -1 ),
             f_processing( false )
     {}
 
@@ -33,12 +38,11 @@ namespace dripline
             f_messages( std::move(a_orig.f_messages) ),
             f_chunks_received( a_orig.f_chunks_received ),
             f_routing_key( std::move(a_orig.f_routing_key) ),
-            f_thread( std::move(a_orig.f_thread) ),
-            f_mutex(),
-            f_conv(),
+            f_timer_id( a_orig.f_timer_id ),
             f_processing( a_orig.f_processing.load() )
     {
         a_orig.f_chunks_received = 0;
+        a_orig.f_timer_id = -1;
         a_orig.f_processing.store( false );
     }
 
@@ -47,15 +51,59 @@ namespace dripline
             scarab::cancelable(),
             f_incoming_messages(),
             f_single_message_wait_ms( 1000 ),
-            f_reply_listen_timeout_ms( 1000 )
+            f_reply_listen_timeout_ms( 1000 ),
+            f_incoming_mutex(),
+            f_used_timers( false )
     {}
 
+    receiver::receiver( receiver&& a_orig ) :
+            scarab::cancelable( std::move(a_orig) ),
+            f_incoming_messages(),
+            f_single_message_wait_ms( a_orig.f_single_message_wait_ms ),
+            f_reply_listen_timeout_ms( a_orig.f_reply_listen_timeout_ms ),
+            f_incoming_mutex(),
+            f_used_timers( false )
+    {
+        *this = std::move(a_orig);
+    }
+
+    receiver::~receiver()
+    {
+        if( ! f_used_timers ) return;
+
+        // remove the reassembly timers, and make sure none are running, since they refer to this receiver
+        std::vector< int > t_timer_ids;
+        std::unique_lock< std::mutex > t_lock( f_incoming_mutex );
+        for( auto& t_pack : f_incoming_messages )
+        {
+            if( t_pack.second.f_timer_id >= 0 ) t_timer_ids.push_back( t_pack.second.f_timer_id );
+        }
+        f_incoming_messages.clear();
+        // a timer that's running waits for the lock, so it's released before waiting for the timers
+        t_lock.unlock();
+        for( int t_timer_id : t_timer_ids )
+        {
+            timer_service::get_instance()->cancel_timer( t_timer_id );
+        }
+    }
+
     receiver& receiver::operator=( receiver&& a_orig )
     {
         cancelable::operator=( std::move(a_orig) );
+        std::unique_lock< std::mutex > t_lock( f_incoming_mutex, std::defer_lock );
+        std::unique_lock< std::mutex > t_orig_lock( a_orig.f_incoming_mutex, std::defer_lock );
+        std::lock( t_lock, t_orig_lock );
         f_incoming_messages = std::move(a_orig.f_incoming_messages);
+        a_orig.f_incoming_messages.clear();
         f_single_message_wait_ms = a_orig.f_single_message_wait_ms;
         f_reply_listen_timeout_ms = a_orig.f_reply_listen_timeout_ms;
+        // the reassembly timers refer to the original receiver, so they're replaced
+        for( auto& t_pack : f_incoming_messages )
+        {
+            if( t_pack.second.f_timer_id < 0 ) continue;
+            timer_service::get_instance()->unschedule( t_pack.second.f_timer_id );
+            arm_message_timer( t_pack.second, t_pack.first );
+        }
         return *this;
     }
 
@@ -67,12 +115,16 @@ namespace dripline
             LDEBUG( dlog, "Received a message chunk <" << t_message->MessageId() );
 
             auto t_parsed_message_id = message::parse_message_id( t_message->MessageId() );
-            if( incoming_messages().count( std::get<0>(t_parsed_message_id) ) == 0 )
+            const std::string& t_message_id = std::get<0>(t_parsed_message_id);
+
+            std::unique_lock< std::mutex > t_lock( f_incoming_mutex );
+            auto t_pack_it = f_incoming_messages.find( t_message_id );
+            if( t_pack_it == f_incoming_messages.end() )
             {
                 // this path: first chunk for this message
                 LDEBUG( dlog, "This is the first chunk for this message; creating new message pack" );
                 // create the new message_pack object
-                incoming_message_pack& t_pack = incoming_messages()[std::get<0>(t_parsed_message_id)];
+                incoming_message_pack& t_pack = f_incoming_messages[t_message_id];
                 // set the f_messages vector to the expected size
                 t_pack.f_messages.resize( std::get<2>(t_parsed_message_id) );
                 // put in place the first message chunk received
@@ -82,43 +134,41 @@ namespace dripline
 
                 if( t_pack.f_messages.size() == 1 )
                 {
-                    // if we only expect one chunk, we can bypass creating a separate thread, etc
+                    // if we only expect one chunk, we can bypass setting a timer
                     LDEBUG( dlog, "Single-chunk message being sent directly to processing" );
-                    process_message_pack( t_pack, t_message->MessageId() );
+                    process_message_pack( t_lock, t_message_id );
                 }
                 else
                 {
-                    // start the thread to wait for message chunks
-                    t_pack.f_thread = std::thread([this, &t_pack, &t_parsed_message_id](){ wait_for_message(t_pack, std::get<0>(t_parsed_message_id)); });
-                    t_pack.f_thread.detach();
+                    // wait for the rest of the message chunks
+                    arm_message_timer( t_pack, t_message_id );
                 }
             }
             else
             {
                 // this path: have already received chunks from this message
                 LDEBUG( dlog, "This is not the first chunk for this message; adding to message pack" );
-                incoming_message_pack& t_pack = incoming_messages()[std::get<0>(t_parsed_message_id)];
+                incoming_message_pack& t_pack = t_pack_it->second;
                 if( t_pack.f_processing.load() )
                 {
-                    LWARN( dlog, "Message <" << std::get<0>(t_parsed_message_id) << "> is already being processed\n" <<
+                    LWARN( dlog, "Message <" << t_message_id << "> is already being processed\n" <<
                             "Just received chunk " << std::get<1>(t_parsed_message_id) << " of " << std::get<2>(t_parsed_message_id) );
                 }
+                else if( t_pack.f_messages[std::get<1>(t_parsed_message_id)] )
+                {
+                    LWARN( dlog, "Received duplicate message chunk for message <" << t_message_id << ">; chunk " << std::get<1>(t_parsed_message_id) );
+                }
                 else
                 {
-                    // lock mutex to access f_messages
-                    std::unique_lock< std::mutex > t_lock( t_pack.f_mutex );
-                    if( t_pack.f_messages[std::get<1>(t_parsed_message_id)] )
-                    {
-                        LWARN( dlog, "Received duplicate message chunk for message <" << std::get<0>(t_parsed_message_id) << ">; chunk " << std::get<1>(t_parsed_message_id) );
-                    }
-                    else
+                    // add chunk to set of chunks
+                    t_pack.f_messages[std::get<1>(t_parsed_message_id)] = t_message;
+                    ++t_pack.f_chunks_received;
+                    if( t_pack.f_chunks_received == t_pack.f_messages.size() )
                     {
-                        // add chunk to set of chunks
-                        t_pack.f_messages[std::get<1>(t_parsed_message_id)] = t_message;
-                        ++t_pack.f_chunks_received;
-                        t_lock.unlock();
-                        // inform the message-processing thread it should check whether it has the complete message
-                        t_pack.f_conv.notify_one();
+                        // the message is complete; the timer isn't needed
+                        LDEBUG( dlog, "All chunks received for message <" << t_message_id << ">" );
+                        if( t_pack.f_timer_id >= 0 ) timer_service::get_instance()->unschedule( t_pack.f_timer_id );
+                        process_message_pack( t_lock, t_message_id );
                     }
                 }
             } // new/current message if/else block
@@ -135,49 +185,75 @@ namespace dripline
         return;
     }
 
-    void receiver::wait_for_message( incoming_message_pack& a_pack, const std::string& a_message_id )
+    void receiver::arm_message_timer( incoming_message_pack& a_pack, const std::string& a_message_id )
     {
-        std::unique_lock< std::mutex > t_lock( a_pack.f_mutex );
-
-        LDEBUG( dlog, "Waiting for message; chunks received: " << a_pack.f_chunks_received << "  chunks expected: " << a_pack.f_messages.size() );
+        f_used_timers = true;
+        a_pack.f_timer_id = timer_service::get_instance()->schedule_after( [this, a_message_id](){ on_message_timeout( a_message_id ); },
+                std::chrono::milliseconds( f_single_message_wait_ms ) );
+        return;
+    }
 
-        // if the message is already complete, submit it for processing
-        if( a_pack.f_chunks_received == a_pack.f_messages.size() )
+    void receiver::on_message_timeout( const std::string& a_message_id )
+    {
+        std::unique_lock< std::mutex > t_lock( f_incoming_mutex );
+        auto t_pack_it = f_incoming_messages.find( a_message_id );
+        if( t_pack_it == f_incoming_messages.end() || t_pack_it->second.f_processing.load() )
         {
-            t_lock.release(); // process_message() will unlock the mutex before erasing the message pack
-            process_message_pack( a_pack, a_message_id );
+            // the message was completed in the meantime
             return;
         }
 
-        auto t_now = std::chrono::system_clock::now();
-        while( a_pack.f_conv.wait_until( t_lock, t_now + std::chrono::milliseconds(f_single_message_wait_ms) ) == std::cv_status::no_timeout )
+        // once the waiting period is over, submit it whether it's complete or not
+        LWARN( dlog, "Timed out waiting for the chunks of message <" << a_message_id << ">; received " << 
+                t_pack_it->second.f_chunks_received << " of " << t_pack_it->second.f_messages.size() << "; message may be incomplete" );
+        process_message_pack( t_lock, a_message_id );
+        return;
+    }
+
+    void receiver::process_message_pack( std::unique_lock< std::mutex >& a_lock, const std::string& a_message_id )
+    {
+        auto t_pack_it = f_incoming_messages.find( a_message_id );
+        if( t_pack_it == f_incoming_messages.end() )
         {
-            // if the message is complete during the waiting period, submit it for processing
-            if( a_pack.f_chunks_received == a_pack.f_messages.size() )
-            {
-                t_lock.release(); // process_message() will unlock the mutex before erasing the message pack
-                process_message_pack( a_pack, a_message_id );
-                return;
-            }
+            a_lock.unlock();
+            return;
         }
 
-        // once the waiting period is over, submit it whether it's complete or not
-        t_lock.release(); // process_message() will unlock the mutex before erasing the message pack
-        LWARN( dlog, "Timed out; message may be incomplete" );
-        process_message_pack( a_pack, a_message_id );
+        incoming_message_pack& t_pack = t_pack_it->second;
+        t_pack.f_processing.store( true );
+
+        undecoded_message t_undecoded{ std::move(t_pack.f_messages), std::move(t_pack.f_routing_key) };
+
+        f_incoming_messages.erase( t_pack_it );
+        a_lock.unlock();
+
+        this->decode_message( std::move(t_undecoded) );
 
         return;
     }
 
-    void receiver::process_message_pack( incoming_message_pack& a_pack, const std::string& a_message_id )
+    unsigned receiver::n_incoming_messages()
+    {
+        std::unique_lock< std::mutex > t_lock( f_incoming_mutex );
+        return f_incoming_messages.size();
+    }
+
+    void receiver::decode_message( undecoded_message&& a_message )
     {
-        a_pack.f_processing.store( true );
         try
         {
-            message_ptr_t t_message = message::process_message( a_pack.f_messages, a_pack.f_routing_key );
+            message_ptr_t t_message = message::process_message( std::move(a_message.f_chunks), a_message.f_routing_key );
 
-            a_pack.f_mutex.unlock();
-            incoming_messages().erase( a_message_id );
+            // an alert from this process may already have been delivered to this receiver in-process
+            if( t_message->is_alert() )
+            {
+                alert_ptr_t t_alert = std::static_pointer_cast< msg_alert >( t_message );
+                if( ! t_alert->local_origin().empty() && local_delivery::get_instance()->was_delivered_locally( *t_alert, this ) )
+                {
+                    LDEBUG( dlog, "Dropping alert <" << t_alert->message_id() << ">, which was already delivered in-process" );
+                    return;
+                }
+            }
 
             // if the message is not valid at this point, continue processing it, and we'll deal with it in the endpoint class
 
@@ -210,6 +286,13 @@ namespace dripline
 
     reply_ptr_t receiver::wait_for_reply( const sent_msg_pkg_ptr a_receive_reply, core::post_listen_status& a_status, int a_timeout_ms )
     {
+        if( a_receive_reply->f_local_replies )
+        {
+            // the request was delivered in-process, so its reply will be too
+            unsigned t_index = 0;
+            return wait_for_local_reply( std::vector< sent_msg_pkg_ptr >{ a_receive_reply }, t_index, a_status, a_timeout_ms );
+        }
+
         if ( ! a_receive_reply->f_channel )
         {
             return reply_ptr_t();
@@ -232,14 +315,14 @@ namespace dripline
         }
 
         // for checking the wait_for_reply timeout
-        auto t_timeout_time = std::chrono::system_clock::now() + std::chrono::milliseconds(a_timeout_ms);
+        auto t_timeout_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(a_timeout_ms);
 
         // wait for messages until either:
         //   1. the channel is no longer valid (return empty reply pointer; a_chan_valid will be false)
         //   2. listening times out (return empty reply pointer; a_chan_valid will be true)
         //   3. a full dripline message is received (return message)
         //   4. error processing a recieved amqp message (return empty reply pointer)
-        while( ! is_canceled() && (a_timeout_ms == 0 || std::chrono::system_clock::now() < t_timeout_time) )
+        while( ! is_canceled() && (a_timeout_ms == 0 || std::chrono::steady_clock::now() < t_timeout_time) )
         {
             amqp_envelope_ptr t_envelope;
             core::listen_for_message( t_envelope, a_status, a_receive_reply->f_channel, a_receive_reply->f_consumer_tag, t_chunk_timeout_ms, false );
@@ -286,72 +369,166 @@ namespace dripline
             // go ahead with message processing
             try
             {
-                amqp_message_ptr t_message = t_envelope->Message();
-                LDEBUG( dlog, "Received a message chunk <" << t_message->MessageId() );
+                reply_ptr_t t_reply;
+                if( handle_reply_chunk( t_envelope, t_reply ) ) return t_reply;
+            }
+            catch( dripline_error& e )
+            {
+                LERROR( dlog, "There was a problem processing the message: " << e.what() );
+                a_status = core::post_listen_status::soft_error;
+                return reply_ptr_t();
+            }
+
+        } // end while( ! is_canceled() && not timed out )
 
-                auto t_parsed_message_id = message::parse_message_id( t_message->MessageId() );
-                if( f_incoming_messages.count( std::get<0>(t_parsed_message_id) ) == 0 )
+        // check if listening timed out
+        if( ! is_canceled() && std::chrono::steady_clock::now() > t_timeout_time )
+        {
+            LINFO( dlog, "Listening for reply message timed out" );
+            a_status = core::post_listen_status::timeout;
+            return reply_ptr_t();
+        }
+
+        LDEBUG( dlog, "Receiver was canceled" );
+        return reply_ptr_t();
+    }
+
+    reply_ptr_t receiver::wait_for_any( const std::vector< sent_msg_pkg_ptr >& a_receive_replies, unsigned& a_index, int a_timeout_ms )
+    {
+        core::post_listen_status t_temp = core::post_listen_status::unknown;
+        return wait_for_any( a_receive_replies, a_index, t_temp, a_timeout_ms );
+    }
+
+    reply_ptr_t receiver::wait_for_any( const std::vector< sent_msg_pkg_ptr >& a_receive_replies, unsigned& a_index, core::post_listen_status& a_status, int a_timeout_ms )
+    {
+        a_index = a_receive_replies.size();
+
+        // group the consumer tags by channel so that each channel can be listened to with a single call
+        struct channel_group
+        {
+            amqp_channel_ptr f_channel;
+            std::vector< std::string > f_consumer_tags;
+        };
+        std::vector< channel_group > t_groups;
+        std::map< std::string, unsigned > t_index_by_tag;
+        // requests that were delivered in-process have their replies delivered the same way
+        bool t_any_local = false;
+        for( unsigned i_pkg = 0; i_pkg < a_receive_replies.size(); ++i_pkg )
+        {
+            const sent_msg_pkg_ptr& t_pkg = a_receive_replies[i_pkg];
+            if( t_pkg && t_pkg->f_local_replies ) t_any_local = true;
+            if( ! t_pkg || ! t_pkg->f_channel ) continue;
+
+            t_index_by_tag[t_pkg->f_consumer_tag] = i_pkg;
+            auto t_group_it = std::find_if( t_groups.begin(), t_groups.end(), [&t_pkg]( const channel_group& a_group ){ return a_group.f_channel == t_pkg->f_channel; } );
+            if( t_group_it == t_groups.end() )
+            {
+                t_groups.push_back( channel_group{ t_pkg->f_channel, { t_pkg->f_consumer_tag } } );
+            }
+            else
+            {
+                t_group_it->f_consumer_tags.push_back( t_pkg->f_consumer_tag );
+            }
+        }
+
+        if( t_groups.empty() )
+        {
+            if( t_any_local ) return wait_for_local_reply( a_receive_replies, a_index, a_status, a_timeout_ms );
+            return reply_ptr_t();
+        }
+
+        LDEBUG( dlog, "Waiting for a reply to any of " << t_index_by_tag.size() << " requests on " << t_groups.size() << " channel(s) (timeout: " << a_timeout_ms << " ms)" );
+
+        // Assign the chunk timeout time as in wait_for_reply(); if there's more than one channel, the time is shared among them,
+        // but each listen is at least t_min_group_listen_ms (or the whole chunk timeout, if that's shorter) so that many channels don't turn into a busy poll
+        unsigned t_chunk_timeout_ms = f_reply_listen_timeout_ms;
+        if( a_timeout_ms > 0 && a_timeout_ms < int(t_chunk_timeout_ms) )
+        {
+            t_chunk_timeout_ms = a_timeout_ms;
+        }
+        const unsigned t_min_group_listen_ms = 50;
+        t_chunk_timeout_ms = std::max( { 1U, t_chunk_timeout_ms / unsigned(t_groups.size()), std::min( t_chunk_timeout_ms, t_min_group_listen_ms ) } );
+        // replies delivered in-process are checked for between listens, so while they can arrive, each listen is kept short
+        const unsigned t_local_poll_ms = 10;
+        if( t_any_local ) t_chunk_timeout_ms = std::min( t_chunk_timeout_ms, t_local_poll_ms );
+
+        // for checking the wait_for_any timeout
+        auto t_timeout_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(a_timeout_ms);
+
+        while( ! is_canceled() && ! t_groups.empty() && (a_timeout_ms == 0 || std::chrono::steady_clock::now() < t_timeout_time) )
+        {
+            for( auto t_group_it = t_groups.begin(); t_group_it != t_groups.end(); )
+            {
+                reply_ptr_t t_local_reply;
+                if( t_any_local && local_delivery::get_instance()->wait_for_reply( a_receive_replies, a_index, t_local_reply, 0 ) )
                 {
-                    // this path: first chunk for this message
-                    LDEBUG( dlog, "This is the first chunk for this message; creating new message pack" );
-                    // create the new message_pack object
-                    incoming_message_pack& t_pack = f_incoming_messages[std::get<0>(t_parsed_message_id)];
-                    // set the f_messages vector to the expected size
-                    t_pack.f_messages.resize( std::get<2>(t_parsed_message_id) );
-                    // put in place the first message chunk received
-                    t_pack.f_messages[std::get<1>(t_parsed_message_id)] = t_message;
-                    t_pack.f_routing_key = t_envelope->RoutingKey();
-                    t_pack.f_chunks_received = 1;
+                    a_status = core::post_listen_status::message_received;
+                    return t_local_reply;
+                }
 
-                    if( t_pack.f_chunks_received == t_pack.f_messages.size() )
-                    {
-                        return process_received_reply( t_pack, std::get<0>(t_parsed_message_id) );
-                    }
-                    // else, need more chunks
+                amqp_envelope_ptr t_envelope;
+                core::listen_for_message( t_envelope, a_status, t_group_it->f_channel, t_group_it->f_consumer_tags, t_chunk_timeout_ms, false );
+
+                if( is_canceled() )
+                {
+                    LDEBUG( dlog, "Receiver was canceled before receiving reply" );
+                    return reply_ptr_t();
                 }
-                else
+
+                if( a_status == core::post_listen_status::hard_error || a_status == core::post_listen_status::unknown )
                 {
-                    // this path: have already received chunks from this message
-                    LDEBUG( dlog, "This is not the first chunk for this message; adding to message pack" );
-                    incoming_message_pack& t_pack = f_incoming_messages[std::get<0>(t_parsed_message_id)];
-                    if( t_pack.f_processing.load() )
+                    // the other channels may still be usable
+                    LERROR( dlog, "There was an error while listening for replies; no further replies will be received on this channel" );
+                    t_group_it = t_groups.erase( t_group_it );
+                    continue;
+                }
+
+                if( a_status != core::post_listen_status::message_received )
+                {
+                    // soft error or timeout
+                    ++t_group_it;
+                    continue;
+                }
+
+                try
+                {
+                    reply_ptr_t t_reply;
+                    if( handle_reply_chunk( t_envelope, t_reply ) )
                     {
-                        LWARN( dlog, "Message <" << std::get<0>(t_parsed_message_id) << "> is already being processed\n" <<
-                                "Just received chunk " << std::get<1>(t_parsed_message_id) << " of " << std::get<2>(t_parsed_message_id) );
-                    }
-                    else
-                    {
-                        if( t_pack.f_messages[std::get<1>(t_parsed_message_id)] )
-                        {
-                            LWARN( dlog, "Received duplicate message chunk for message <" << std::get<0>(t_parsed_message_id) << ">; chunk " << std::get<1>(t_parsed_message_id) );
-                        }
-                        else
-                        {
-                            // add chunk to set of chunks
-                            t_pack.f_messages[std::get<1>(t_parsed_message_id)] = t_message;
-                            ++t_pack.f_chunks_received;
-                            if( t_pack.f_chunks_received == t_pack.f_messages.size() )
-                            {
-                                return process_received_reply( t_pack, std::get<0>(t_parsed_message_id) );
-                            }
-                        }
+                        auto t_index_it = t_index_by_tag.find( t_envelope->ConsumerTag() );
+                        if( t_index_it != t_index_by_tag.end() ) a_index = t_index_it->second;
+                        return t_reply;
                     }
                 }
-
+                catch( dripline_error& e )
+                {
+                    LERROR( dlog, "There was a problem processing the message: " << e.what() );
+                }
+                ++t_group_it;
             }
-            catch( dripline_error& e )
+        } // end while( ! is_canceled() && channels remain && not timed out )
+
+        if( t_groups.empty() )
+        {
+            if( t_any_local && ! is_canceled() )
             {
-                LERROR( dlog, "There was a problem processing the message: " << e.what() );
-                a_status = core::post_listen_status::soft_error;
-                return reply_ptr_t();
+                // the channels failed, but replies can still arrive in-process for the rest of the time
+                int t_remaining_ms = 0;
+                if( a_timeout_ms > 0 )
+                {
+                    t_remaining_ms = std::chrono::duration_cast< std::chrono::milliseconds >( t_timeout_time - std::chrono::steady_clock::now() ).count();
+                    if( t_remaining_ms <= 0 ) t_remaining_ms = 1;
+                }
+                return wait_for_local_reply( a_receive_replies, a_index, a_status, t_remaining_ms );
             }
-
-        } // end while( ! is_canceled() && not timed out )
+            a_status = core::post_listen_status::hard_error;
+            return reply_ptr_t();
+        }
 
         // check if listening timed out
-        if( ! is_canceled() && std::chrono::system_clock::now() > t_timeout_time )
+        if( ! is_canceled() && std::chrono::steady_clock::now() > t_timeout_time )
         {
-            LINFO( dlog, "Listening for reply message timed out" );
+            LINFO( dlog, "Listening for reply messages timed out" );
             a_status = core::post_listen_status::timeout;
             return reply_ptr_t();
         }
@@ -360,6 +537,234 @@ namespace dripline
         return reply_ptr_t();
     }
 
+    std::vector< reply_ptr_t > receiver::wait_for_all( const std::vector< sent_msg_pkg_ptr >& a_receive_replies, int a_timeout_ms )
+    {
+        std::vector< reply_ptr_t > t_replies( a_receive_replies.size() );
+
+        // packages still waiting for a reply, and their positions in a_receive_replies
+        std::vector< sent_msg_pkg_ptr > t_waiting( a_receive_replies );
+        std::vector< unsigned > t_positions( a_receive_replies.size() );
+        for( unsigned i_pkg = 0; i_pkg < t_positions.size(); ++i_pkg ) t_positions[i_pkg] = i_pkg;
+
+        auto t_timeout_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(a_timeout_ms);
+
+        while( ! t_waiting.empty() && ! is_canceled() )
+        {
+            int t_remaining_ms = 0;
+            if( a_timeout_ms > 0 )
+            {
+                t_remaining_ms = std::chrono::duration_cast< std::chrono::milliseconds >( t_timeout_time - std::chrono::steady_clock::now() ).count();
+                if( t_remaining_ms <= 0 ) break;
+            }
+
+            unsigned t_index = 0;
+            core::post_listen_status t_status = core::post_listen_status::unknown;
+            reply_ptr_t t_reply = wait_for_any( t_waiting, t_index, t_status, t_remaining_ms );
+            if( t_index >= t_waiting.size() )
+            {
+                // nothing was received: timed out, canceled, or no usable channels remain
+                break;
+            }
+
+            t_replies[t_positions[t_index]] = t_reply;
+            t_waiting.erase( t_waiting.begin() + t_index );
+            t_positions.erase( t_positions.begin() + t_index );
+        }
+
+        if( ! t_waiting.empty() )
+        {
+            LINFO( dlog, "Did not receive replies to " << t_waiting.size() << " of " << a_receive_replies.size() << " requests" );
+        }
+        return t_replies;
+    }
+
+    std::map< std::string, reply_ptr_t > receiver::gather_replies( const sent_msg_pkg_ptr a_receive_reply, int a_timeout_ms, unsigned a_quiet_ms, unsigned a_expected )
+    {
+        std::map< std::string, reply_ptr_t > t_replies;
+        if( ! a_receive_reply->f_channel && ! a_receive_reply->f_local_replies )
+        {
+            return t_replies;
+        }
+
+        LDEBUG( dlog, "Gathering replies (timeout: " << a_timeout_ms << " ms; quiet period: " << a_quiet_ms << " ms; expected replies: " << a_expected << ")" );
+
+        typedef std::chrono::steady_clock gather_clock;
+        gather_clock::time_point t_timeout_time = gather_clock::now() + std::chrono::milliseconds(a_timeout_ms);
+        // the quiet period is measured from the start and then from the last reply received
+        gather_clock::time_point t_last_reply_time = gather_clock::now();
+
+        while( ! is_canceled() )
+        {
+            gather_clock::time_point t_now = gather_clock::now();
+            if( a_timeout_ms > 0 && t_now >= t_timeout_time )
+            {
+                LDEBUG( dlog, "Gathering replies timed out" );
+                break;
+            }
+            if( a_quiet_ms > 0 && t_now >= t_last_reply_time + std::chrono::milliseconds(a_quiet_ms) )
+            {
+                LDEBUG( dlog, "No replies received during the quiet period" );
+                break;
+            }
+
+            // listen until the earliest of the timeouts
+            gather_clock::time_point t_listen_until = t_now + std::chrono::milliseconds(f_reply_listen_timeout_ms);
+            if( a_timeout_ms > 0 ) t_listen_until = std::min( t_listen_until, t_timeout_time );
+            if( a_quiet_ms > 0 ) t_listen_until = std::min( t_listen_until, t_last_reply_time + std::chrono::milliseconds(a_quiet_ms) );
+            int t_listen_ms = std::max( 1, int(std::chrono::duration_cast< std::chrono::milliseconds >( t_listen_until - t_now ).count()) );
+
+            reply_ptr_t t_reply;
+            if( a_receive_reply->f_local_replies )
+            {
+                // the request was delivered in-process, so its replies are too
+                unsigned t_index = 0;
+                if( ! local_delivery::get_instance()->wait_for_reply( std::vector< sent_msg_pkg_ptr >{ a_receive_reply }, t_index, t_reply, t_listen_ms ) ) continue;
+            }
+            else
+            {
+                amqp_envelope_ptr t_envelope;
+                core::post_listen_status t_status = core::post_listen_status::unknown;
+                core::listen_for_message( t_envelope, t_status, a_receive_reply->f_channel, a_receive_reply->f_consumer_tag, t_listen_ms, false );
+
+                if( t_status == core::post_listen_status::hard_error || t_status == core::post_listen_status::unknown )
+                {
+                    LERROR( dlog, "There was an error while listening for replies; no further replies will be received" );
+                    break;
+                }
+                if( t_status != core::post_listen_status::message_received )
+                {
+                    // soft error or timeout
+                    continue;
+                }
+
+                try
+                {
+                    if( ! handle_reply_chunk( t_envelope, t_reply ) ) continue;
+                }
+                catch( dripline_error& e )
+                {
+                    LERROR( dlog, "There was a problem processing the message: " << e.what() );
+                    continue;
+                }
+            }
+
+            if( ! t_reply ) continue;
+
+            t_last_reply_time = gather_clock::now();
+            std::string t_sender = t_reply->sender_service_name();
+            if( t_sender.empty() ) t_sender = t_reply->sender_exe() + "@" + t_reply->sender_hostname();
+            if( t_replies.count( t_sender ) != 0 )
+            {
+                LWARN( dlog, "Received more than one reply from <" << t_sender << ">; keeping the latest" );
+            }
+            LDEBUG( dlog, "Received a reply from <" << t_sender << ">" );
+            t_replies[t_sender] = t_reply;
+
+            if( a_expected > 0 && t_replies.size() >= a_expected )
+            {
+                LDEBUG( dlog, "Received all of the expected replies" );
+                break;
+            }
+        }
+
+        LDEBUG( dlog, "Gathered " << t_replies.size() << " replies" );
+        return t_replies;
+    }
+
+    reply_ptr_t receiver::wait_for_local_reply( const std::vector< sent_msg_pkg_ptr >& a_receive_replies, unsigned& a_index, core::post_listen_status& a_status, int a_timeout_ms )
+    {
+        a_index = a_receive_replies.size();
+
+        // cancellation is checked at least every f_reply_listen_timeout_ms, as when listening on a channel
+        typedef std::chrono::steady_clock wait_clock;
+        wait_clock::time_point t_timeout_time = wait_clock::now() + std::chrono::milliseconds(a_timeout_ms);
+        while( ! is_canceled() )
+        {
+            unsigned t_wait_ms = f_reply_listen_timeout_ms;
+            if( a_timeout_ms > 0 )
+            {
+                int t_remaining_ms = std::chrono::duration_cast< std::chrono::milliseconds >( t_timeout_time - wait_clock::now() ).count();
+                if( t_remaining_ms <= 0 )
+                {
+                    LINFO( dlog, "Waiting for a local reply timed out" );
+                    a_status = core::post_listen_status::timeout;
+                    return reply_ptr_t();
+                }
+                t_wait_ms = std::min( t_wait_ms, unsigned(t_remaining_ms) );
+            }
+
+            reply_ptr_t t_reply;
+            if( local_delivery::get_instance()->wait_for_reply( a_receive_replies, a_index, t_reply, std::max( t_wait_ms, 1U ) ) )
+            {
+                a_status = core::post_listen_status::message_received;
+                return t_reply;
+            }
+        }
+
+        LDEBUG( dlog, "Receiver was canceled before receiving reply" );
+        return reply_ptr_t();
+    }
+
+    bool receiver::handle_reply_chunk( amqp_envelope_ptr a_envelope, reply_ptr_t& a_reply )
+    {
+        amqp_message_ptr t_message = a_envelope->Message();
+        LDEBUG( dlog, "Received a message chunk <" << t_message->MessageId() );
+
+        auto t_parsed_message_id = message::parse_message_id( t_message->MessageId() );
+        std::unique_lock< std::mutex > t_lock( f_incoming_mutex );
+        if( f_incoming_messages.count( std::get<0>(t_parsed_message_id) ) == 0 )
+        {
+            // this path: first chunk for this message
+            LDEBUG( dlog, "This is the first chunk for this message; creating new message pack" );
+            // create the new message_pack object
+            incoming_message_pack& t_pack = f_incoming_messages[std::get<0>(t_parsed_message_id)];
+            // set the f_messages vector to the expected size
+            t_pack.f_messages.resize( std::get<2>(t_parsed_message_id) );
+            // put in place the first message chunk received
+            t_pack.f_messages[std::get<1>(t_parsed_message_id)] = t_message;
+            t_pack.f_routing_key = a_envelope->RoutingKey();
+            t_pack.f_chunks_received = 1;
+
+            if( t_pack.f_chunks_received == t_pack.f_messages.size() )
+            {
+                a_reply = process_received_reply( t_pack, std::get<0>(t_parsed_message_id) );
+                return true;
+            }
+            // else, need more chunks
+        }
+        else
+        {
+            // this path: have already received chunks from this message
+            LDEBUG( dlog, "This is not the first chunk for this message; adding to message pack" );
+            incoming_message_pack& t_pack = f_incoming_messages[std::get<0>(t_parsed_message_id)];
+            if( t_pack.f_processing.load() )
+            {
+                LWARN( dlog, "Message <" << std::get<0>(t_parsed_message_id) << "> is already being processed\n" <<
+                        "Just received chunk " << std::get<1>(t_parsed_message_id) << " of " << std::get<2>(t_parsed_message_id) );
+            }
+            else
+            {
+                if( t_pack.f_messages[std::get<1>(t_parsed_message_id)] )
+                {
+                    LWARN( dlog, "Received duplicate message chunk for message <" << std::get<0>(t_parsed_message_id) << ">; chunk " << std::get<1>(t_parsed_message_id) );
+                }
+                else
+                {
+                    // add chunk to set of chunks
+                    t_pack.f_messages[std::get<1>(t_parsed_message_id)] = t_message;
+                    ++t_pack.f_chunks_received;
+                    if( t_pack.f_chunks_received == t_pack.f_messages.size() )
+                    {
+                        a_reply = process_received_reply( t_pack, std::get<0>(t_parsed_message_id) );
+                        return true;
+                    }
+                }
+            }
+        }
+        // more chunks are needed to complete the message
+        return false;
+    }
+
     reply_ptr_t receiver::process_received_reply( incoming_message_pack& a_pack, const std::string& a_message_id )
     {
         a_pack.f_processing.store( true );
@@ -401,12 +806,32 @@ namespace dripline
 
     concurrent_receiver::concurrent_receiver() :
             receiver(),
-            f_message_queue()
+            f_n_decoders( 0 ),
+            f_use_priority_lane( false ),
+            f_priority_threshold( 1 ),
+            f_worker_pool(),
+            f_strand(),
+            f_drain_timeout_ms( 0 ),
+            f_message_queue(),
+            f_priority_queue(),
+            f_receiver_thread(),
+            f_decode_queue(),
+            f_decoder_threads()
     {}
 
     concurrent_receiver::concurrent_receiver( concurrent_receiver&& a_orig ) :
             receiver( std::move(a_orig) ),
-            f_message_queue()
+            f_n_decoders( a_orig.f_n_decoders ),
+            f_use_priority_lane( a_orig.f_use_priority_lane ),
+            f_priority_threshold( a_orig.f_priority_threshold ),
+            f_worker_pool( a_orig.f_worker_pool ),
+            f_strand( std::move(a_orig.f_strand) ),
+            f_drain_timeout_ms( a_orig.f_drain_timeout_ms ),
+            f_message_queue(),
+            f_priority_queue(),
+            f_receiver_thread(),
+            f_decode_queue(),
+            f_decoder_threads()
     {}
 
     concurrent_receiver::~concurrent_receiver()
@@ -415,28 +840,82 @@ namespace dripline
     concurrent_receiver& concurrent_receiver::operator=( concurrent_receiver&& a_orig )
     {
         receiver::operator=( std::move(a_orig) );
-        // nothing to do with message queue
+        f_n_decoders = a_orig.f_n_decoders;
+        f_use_priority_lane = a_orig.f_use_priority_lane;
+        f_priority_threshold = a_orig.f_priority_threshold;
+        f_worker_pool = a_orig.f_worker_pool;
+        f_strand = std::move(a_orig.f_strand);
+        f_drain_timeout_ms = a_orig.f_drain_timeout_ms;
+        // nothing to do with message queues
         return *this;
     }
 
     void concurrent_receiver::process_message( message_ptr_t a_message )
     {
+        if( f_worker_pool )
+        {
+            f_worker_pool->submit( f_strand, 
+                    [this, a_message](){ 
+                        try
+                        {
+                            // after cancellation, messages are only handled while the pool is being drained
+                            if( ! is_canceled() || f_drain_timeout_ms > 0 ) this->submit_message( a_message );
+                        }
+                        catch( const std::exception& e )
+                        {
+                            // shutdown gracefully on an exception, as in execute()
+                            LERROR( dlog, "Exception caught; shutting down.\n" << "\t" << e.what() );
+                            scarab::signal_handler::cancel_all( RETURN_ERROR );
+                        }
+                    },
+                    is_priority_message( a_message ) );
+            return;
+        }
+
+        if( is_priority_message( a_message ) )
+        {
+            LDEBUG( dlog, "Placing message in the priority lane" );
+            f_priority_queue.push( a_message );
+            // an empty message wakes up execute() in case it's waiting on the main queue
+            f_message_queue.push( message_ptr_t() );
+            return;
+        }
         f_message_queue.push( a_message );
         return;
     }
 
+    bool concurrent_receiver::is_priority_message( const message_ptr_t a_message ) const
+    {
+        if( ! f_use_priority_lane || ! a_message || ! a_message->is_request() ) return false;
+
+        const msg_request& t_request = static_cast< const msg_request& >( *a_message );
+        return t_request.get_priority() >= f_priority_threshold || endpoint::is_control_request( t_request );
+    }
+
     void concurrent_receiver::execute()
     {
         try
         {
+            // a message taken from the main queue when cancellation arrives is left for drain_queues()
+            message_ptr_t t_message;
             while( ! is_canceled() )
             {
-                message_ptr_t t_message;
-                if( f_message_queue.timed_wait_and_pop( t_message ) )
+                if( ! f_message_queue.timed_wait_and_pop( t_message ) ) continue;
+
+                // anything in the priority lane goes ahead of the message from the main queue
+                message_ptr_t t_priority_message;
+                while( ! is_canceled() && f_priority_queue.try_pop( t_priority_message ) )
                 {
-                    this->submit_message( t_message );
+                    this->submit_message( t_priority_message );
                 }
+
+                // empty messages are only used to wake up this thread
+                if( ! t_message || is_canceled() ) continue;
+                this->submit_message( t_message );
+                t_message.reset();
             }
+
+            drain_queues( std::move(t_message) );
         }
         catch( const std::exception& e )
         {
@@ -446,6 +925,119 @@ namespace dripline
         }
     }
 
+    void concurrent_receiver::drain_queues( message_ptr_t a_pending )
+    {
+        auto t_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( f_drain_timeout_ms );
+        unsigned t_n_handled = 0;
+        unsigned t_n_dropped = 0;
+        while( true )
+        {
+            bool t_in_time = std::chrono::steady_clock::now() < t_deadline;
+            message_ptr_t t_message;
+            bool t_popped = f_priority_queue.try_pop( t_message );
+            if( ! t_popped && a_pending )
+            {
+                t_message = std::move( a_pending );
+                a_pending.reset();
+                t_popped = true;
+            }
+            if( t_popped || f_message_queue.try_pop( t_message ) )
+            {
+                // empty messages are only used to wake up execute()
+                if( ! t_message ) continue;
+                if( t_in_time )
+                {
+                    this->submit_message( t_message );
+                    ++t_n_handled;
+                }
+                else ++t_n_dropped;
+                continue;
+            }
+            // messages still being decoded will arrive in the message queue shortly
+            if( ! t_in_time || f_decode_queue.empty() ) break;
+            std::this_thread::yield();
+        }
+
+        if( t_n_handled > 0 ) LDEBUG( dlog, "Handled " << t_n_handled << " message(s) after cancellation" );
+        if( t_n_dropped > 0 ) LWARN( dlog, "Dropped " << t_n_dropped << " message(s) that were not handled before cancellation" );
+        return;
+    }
+
+    void concurrent_receiver::do_cancellation( int )
+    {
+        // an empty message wakes up execute(), and an empty set of chunks wakes up each decoder thread
+        f_message_queue.push( message_ptr_t() );
+        for( unsigned i_thread = 0; i_thread < f_decoder_threads.size(); ++i_thread )
+        {
+            f_decode_queue.push( undecoded_message() );
+        }
+        return;
+    }
+
+    void concurrent_receiver::decode_message( undecoded_message&& a_message )
+    {
+        if( f_decoder_threads.empty() )
+        {
+            receiver::decode_message( std::move(a_message) );
+            return;
+        }
+        f_decode_queue.push( std::move(a_message) );
+        return;
+    }
+
+    void concurrent_receiver::start_decoders()
+    {
+        if( f_n_decoders == 0 ) return;
+
+        for( unsigned i_thread = 0; i_thread < f_n_decoders; ++i_thread )
+        {
+            f_decoder_threads.emplace_back( &concurrent_receiver::decode_execute, this );
+        }
+        return;
+    }
+
+    void concurrent_receiver::join_decoders()
+    {
+        for( std::thread& t_thread : f_decoder_threads )
+        {
+            if( t_thread.joinable() ) t_thread.join();
+        }
+        f_decoder_threads.clear();
+        return;
+    }
+
+    void concurrent_receiver::decode_execute()
+    {
+        while( ! is_canceled() )
+        {
+            undecoded_message t_undecoded;
+            // an empty set of chunks is only used to wake up this thread
+            if( f_decode_queue.timed_wait_and_pop( t_undecoded ) && ! t_undecoded.f_chunks.empty() )
+            {
+                // receiver::decode_message() handles all exceptions from decoding and from process_message()
+                receiver::decode_message( std::move(t_undecoded) );
+            }
+        }
+
+        // messages that were already received are decoded so that execute() can handle them while it drains;
+        // the rest are dropped, along with any wake-ups left for the other decoder threads
+        auto t_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( f_drain_timeout_ms );
+        undecoded_message t_undecoded;
+        while( f_decode_queue.try_pop( t_undecoded ) )
+        {
+            if( ! t_undecoded.f_chunks.empty() && std::chrono::steady_clock::now() < t_deadline )
+            {
+                receiver::decode_message( std::move(t_undecoded) );
+            }
+        }
+        return;
+    }
+
+    unsigned concurrent_receiver::queue_depth()
+    {
+        return f_message_queue.size() + f_priority_queue.size() + f_decode_queue.size();
+    }
+
 
 
 } /* namespace dripline */
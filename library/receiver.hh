@@ -17,12 +17,16 @@
 #include "member_variables.hh"
 
 #include <atomic>
-#include <condition_variable>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace dripline
 {
+    class worker_pool;
 
     /*!
      @struct incoming_message_pack
@@ -34,9 +38,8 @@ namespace dripline
         amqp_split_message_ptrs f_messages;
         unsigned f_chunks_received;
         std::string f_routing_key;
-        std::thread f_thread;
-        std::mutex f_mutex;
-        std::condition_variable f_conv;
+        /// ID of the reassembly timer in the timer_service; negative if there isn't one
+        int f_timer_id;
         std::atomic< bool > f_processing;
         incoming_message_pack();
         incoming_message_pack( const incoming_message_pack& ) = delete;
@@ -44,6 +47,17 @@ namespace dripline
     };
     typedef std::map< std::string, incoming_message_pack > incoming_message_map;
 
+    /*!
+     @struct undecoded_message
+     @author N.S. Oblath
+     @brief The complete set of AMQP messages (chunks) for a Dripline message that has not yet been decoded
+    */
+    struct undecoded_message
+    {
+        amqp_split_message_ptrs f_chunks;
+        std::string f_routing_key;
+    };
+
 
     // contains mechanisms for receiving messages synchronously
     /*!
@@ -59,15 +73,23 @@ namespace dripline
      A receiver is responsible for handling message chunks, storing incomplete Dripline messages, and eventually 
      processing complete Dripline messages.
 
-     The receiver class contains an interface specifically for users waiting to receive reply messages: `wait_for_reply()`.
+     The receiver class contains an interface specifically for users waiting to receive reply messages: `wait_for_reply()`.  
+     Replies to many requests can be waited for together with `wait_for_any()`, which returns the next reply to arrive, and 
+     `wait_for_all()`, which collects all of the replies within one overall timeout.  Those are most efficient when the requests 
+     were sent on the same channel (e.g. with `core::send_requests()`), in which case a single call listens for all of the replies.
+     For a request that will be answered by more than one service, such as one sent with the broadcast routing key, 
+     `gather_replies()` collects the replies from a single reply queue.
 
      When the first message chunk for a message is received, one of two things happens:
      1. if the message comprises one chunk, then the message is processed immediately;
-     2. if the message comprises multiple chunks, then a separate thread is spun up to wait for the remaining chunks.
+     2. if the message comprises multiple chunks, then a timer is set in the @ref timer_service for the remaining chunks to arrive.
 
      Incomplete messages are stored in the incoming-message map.  Message chunks for a given message can be received 
      in any order.  The receiver will wait `single_message_wait_ms` ms for all of the chunks of a message to arrive 
-     before timing out processing the incomplete message.
+     before timing out processing the incomplete message.  The message is processed by whichever comes first: 
+     the thread that receives the last chunk, or a timer_service worker thread.
+
+     Timeouts are measured with `std::chrono::steady_clock`, so they are not affected by changes to the system clock.
 
      The actual assembly of message chunks into complete messages is done in @ref message.
 
@@ -79,8 +101,8 @@ namespace dripline
         public:
             receiver();
             receiver( const receiver& a_orig ) = delete;
-            receiver( receiver&& a_orig ) = default;
-            virtual ~receiver() = default;
+            receiver( receiver&& a_orig );
+            virtual ~receiver();
 
             receiver& operator=( const receiver& a_orig ) = delete;
             receiver& operator=( receiver&& a_orig );
@@ -91,17 +113,25 @@ namespace dripline
             /// For single-chunk messages, processes the message immediately.
             void handle_message_chunk( amqp_envelope_ptr a_envelope );
 
-            /// Waits for messages for a set amount of time (`single_message_wait_ms`), and submits the message pack for processing.
-            /// Intended to be used in a separate thread for each message pack.
-            void wait_for_message( incoming_message_pack& a_pack, const std::string& a_message_id );
-            /// Converts a message pack into a Dripline message, and then submits the message for processing.
-            void process_message_pack( incoming_message_pack& a_pack, const std::string& a_message_id );
+            /// Called by the reassembly timer once `single_message_wait_ms` has passed; submits the message pack for processing, 
+            /// whether it's complete or not, if it hasn't been processed already.
+            void on_message_timeout( const std::string& a_message_id );
+            /// Removes a message pack from the incoming-message map and submits its chunks for decoding.
+            /// The lock must hold the incoming-message mutex; it's unlocked before the chunks are decoded.
+            void process_message_pack( std::unique_lock< std::mutex >& a_lock, const std::string& a_message_id );
+
+            /// Converts a set of message chunks into a Dripline message, and then submits the message for processing.
+            /// The default implementation does the conversion in the calling thread.
+            virtual void decode_message( undecoded_message&& a_message );
 
             /// Processes a single Dripline message.
             /// This is the default implementation that always throws a `dripline_error`.
             virtual void process_message( message_ptr_t a_message );
 
-            /// Stores the incomplete messages
+            /// Number of multi-chunk messages waiting for the rest of their chunks
+            unsigned n_incoming_messages();
+
+            /// Stores the incomplete messages; guarded by the incoming-message mutex
             mv_referrable( incoming_message_map, incoming_messages );
             /// Wait time for all message chunks from a single dripline message
             mv_accessible( unsigned, single_message_wait_ms );
@@ -128,9 +158,64 @@ namespace dripline
             */
             reply_ptr_t wait_for_reply( const sent_msg_pkg_ptr a_receive_reply, core::post_listen_status& a_status, int a_timeout_ms = 0 );
 
+            /*!
+            User interface for waiting for the first reply to any of a set of requests.
+            Call it again (without the package that was answered) to get the next reply.
+            @param[in] a_receive_replies The sent-message packages from the requests.
+            @param[out] a_index Position in a_receive_replies of the request that was answered; set to the size of a_receive_replies if no reply was received.
+            @param[in] a_timeout_ms Timeout for waiting for a reply; if it's 0, there will be no timeout.
+            @return Reply message
+            */
+            reply_ptr_t wait_for_any( const std::vector< sent_msg_pkg_ptr >& a_receive_replies, unsigned& a_index, int a_timeout_ms = 0 );
+            /*!
+            User interface for waiting for the first reply to any of a set of requests.
+            Call it again (without the package that was answered) to get the next reply.
+            @param[in] a_receive_replies The sent-message packages from the requests.
+            @param[out] a_index Position in a_receive_replies of the request that was answered; set to the size of a_receive_replies if no reply was received.
+            @param[out] a_status Status of the last attempt to listen for a message.
+            @param[in] a_timeout_ms Timeout for waiting for a reply; if it's 0, there will be no timeout.
+            @return Reply message
+            */
+            reply_ptr_t wait_for_any( const std::vector< sent_msg_pkg_ptr >& a_receive_replies, unsigned& a_index, core::post_listen_status& a_status, int a_timeout_ms = 0 );
+
+            /*!
+            User interface for waiting for the replies to a set of requests.
+            @param a_receive_replies The sent-message packages from the requests.
+            @param a_timeout_ms Overall timeout for waiting for the replies; if it's 0, there will be no timeout.
+            @return Reply messages in the same order as a_receive_replies; replies that were not received are empty pointers
+            */
+            std::vector< reply_ptr_t > wait_for_all( const std::vector< sent_msg_pkg_ptr >& a_receive_replies, int a_timeout_ms = 0 );
+
+            /*!
+            User interface for collecting the replies from every service that answers a request (e.g. a broadcast request).
+            Replies are collected until the first of these happens: the timeout passes, no reply arrives for the quiet period, 
+            or the expected number of replies has arrived.  If none of those is set, replies are collected until the receiver is canceled.
+            @param a_receive_reply The sent-message package from the request.
+            @param a_timeout_ms Overall timeout; if it's 0, there will be no overall timeout.
+            @param a_quiet_ms Quiet period, measured from the start and from each reply received; if it's 0, there is no quiet period.
+            @param a_expected Number of replies after which to stop; if it's 0, there's no limit.
+            @return Replies keyed by the name of the sending service (`sender_service_name`, or `[exe]@[host]` if that's not set)
+            */
+            std::map< std::string, reply_ptr_t > gather_replies( const sent_msg_pkg_ptr a_receive_reply, int a_timeout_ms, unsigned a_quiet_ms, unsigned a_expected = 0 );
+
         protected:
+            /// Adds a received chunk to its message pack; returns true if the message is complete, in which case a_reply is the processed reply 
+            /// (or an empty pointer if processing failed).  Throws dripline_error if the chunk can't be interpreted.
+            bool handle_reply_chunk( amqp_envelope_ptr a_envelope, reply_ptr_t& a_reply );
+
+            /// Decodes a complete reply and removes its message pack; the incoming-message mutex must be locked
             reply_ptr_t process_received_reply( incoming_message_pack& a_pack, const std::string& a_message_id );
 
+            /// Sets the reassembly timer for a message pack; the incoming-message mutex must be locked
+            void arm_message_timer( incoming_message_pack& a_pack, const std::string& a_message_id );
+
+            /// Waits for a reply to any of the requests that were delivered in-process (see @ref local_delivery); the arguments are as for `wait_for_any()`
+            reply_ptr_t wait_for_local_reply( const std::vector< sent_msg_pkg_ptr >& a_receive_replies, unsigned& a_index, core::post_listen_status& a_status, int a_timeout_ms );
+
+            std::mutex f_incoming_mutex;
+            /// Set once a reassembly timer has been used, so that the receiver knows to cancel its timers when it's destroyed
+            bool f_used_timers;
+
     };
 
     /*!
@@ -146,12 +231,35 @@ namespace dripline
      The typical use case involves three threads:
      1. A listener gets messages from the AMQP channel (using `listen_on_queue(), e.g. @ref service or @ref endpoint_listener_receiver) and 
         calls `receiver::handle_message_chunk()`
-     2. A receiver has a timing thread waiting for multiple message chunks (if relevant); 
-        when the message is complete, `concurrent_receiver::process_message()` is called, which deposits the message in a concurrent queue.
+     2. When a message is complete (or the @ref timer_service times out waiting for its chunks), 
+        `concurrent_receiver::process_message()` is called, which deposits the message in a concurrent queue.
      3. A concurrent_receiver picks up the complete message from the concurrent queue, and processes the message using `submit_message()`.
 
      The `execute()` function implements thread 3.
 
+     Optionally the conversion of AMQP messages into Dripline messages (including parsing the payload) can be taken 
+     off of the listener thread.  If `n_decoders` is non-zero and the decoder threads have been started with `start_decoders()`, 
+     complete sets of message chunks are deposited in a second concurrent queue, and are then decoded by a small pool of 
+     decoder threads (`decode_execute()`) before being passed to `process_message()`.  With more than one decoder thread, 
+     messages may reach the receiver queue in a different order than they arrived from the broker.
+
+     Requests can skip ahead of other messages waiting in the receiver queue by way of a priority lane.  If `use_priority_lane` 
+     is true (the default is false, so that requests are handled in the order they arrive), requests that have a priority at or above `priority_threshold`, and control requests 
+     (see `endpoint::is_control_request()`), are deposited in a separate queue that `execute()` empties before it takes 
+     the next message from the main queue.  A request in the priority lane therefore waits at most for the message currently 
+     being handled.
+
+     Instead of running `execute()` in its own thread, a concurrent_receiver can hand its messages to a shared @ref worker_pool 
+     by setting `worker_pool`.  `process_message()` then submits each message to the pool, in the strand named by `strand`; 
+     messages in the priority lane go to the front of the strand.  Receivers that share a pool should use different strands 
+     so that each one's messages are handled in order but the receivers do not wait on each other.
+
+     Canceling a concurrent_receiver wakes `execute()` and the decoder threads right away.  By default, messages that are still 
+     waiting to be handled are then dropped.  If `drain_timeout_ms` is non-zero, `execute()` and the decoder threads first 
+     handle the messages that were already received, for up to that long, so that requests in progress can be answered; 
+     messages handed to a worker pool are likewise still handled while the pool is drained (see `worker_pool::drain()`).
+     Whatever is left after the drain timeout is dropped.
+
      A class deriving from concurrent_receiver must implement `submit_message()`.
     */
     class DRIPLINE_API concurrent_receiver : public receiver
@@ -172,13 +280,58 @@ namespace dripline
             /// Handles messages that appear in the concurrent queue by calling `submit_message()`.
             void execute();
 
+            /// Passes the message chunks to the decoder threads, if they're running; otherwise decodes them in the calling thread
+            virtual void decode_message( undecoded_message&& a_message );
+
+            /// Starts `n_decoders` decoder threads; does nothing if `n_decoders` is 0
+            void start_decoders();
+            /// Joins the decoder threads; they exit once the receiver is canceled
+            void join_decoders();
+
+            /// Decodes message chunks that appear in the decode queue and passes the results to `process_message()`.
+            void decode_execute();
+
+            /// Number of messages waiting to be decoded or handled
+            unsigned queue_depth();
+
+            /// Number of threads used to decode messages; if 0, messages are decoded by the thread that received them
+            mv_accessible( unsigned, n_decoders );
+
+            /// Returns true if the message should be put in the priority lane
+            bool is_priority_message( const message_ptr_t a_message ) const;
+
+            /// Flag to enable the priority lane
+            mv_accessible( bool, use_priority_lane );
+            /// Minimum request priority for using the priority lane; control requests always use the priority lane if it's enabled
+            mv_accessible( unsigned, priority_threshold );
+
+            /// Pool used to handle messages; if empty, messages are handled by `execute()`
+            mv_accessible( std::shared_ptr< worker_pool >, worker_pool );
+            /// Strand of the worker pool used for this receiver's messages
+            mv_referrable( std::string, strand );
+
+            /// Time allowed after cancellation for handling the messages that were already received, in ms; if 0, they're dropped
+            mv_accessible( unsigned, drain_timeout_ms );
+
         protected:
+            /// Wakes `execute()` and the decoder threads
+            virtual void do_cancellation( int a_code );
+
+            /// Handles messages still waiting in the queues until the drain timeout has passed, and drops the rest.
+            /// a_pending is a message that was already taken from the main queue; it's handled after the priority lane and before the rest of the main queue.
+            void drain_queues( message_ptr_t a_pending = message_ptr_t() );
+
+
             /// Handles messages according to the use case.  It's to be implemented by the class inheriting from concurrent_receiver
             /// For a concrete example, see @ref service or @ref endpoint_listener_receiver.
             virtual void submit_message( message_ptr_t a_message ) = 0;
 
             mv_referrable( scarab::concurrent_queue< message_ptr_t >, message_queue );
+            mv_referrable( scarab::concurrent_queue< message_ptr_t >, priority_queue );
             mv_referrable( std::thread, receiver_thread );
+
+            mv_referrable( scarab::concurrent_queue< undecoded_message >, decode_queue );
+            mv_referrable( std::vector< std::thread >, decoder_threads );
     };
 
 } /* namespace dripline */
@@ -137,7 +137,7 @@ namespace dripline
     reply_ptr_t relayer::wait_for_reply( const wait_for_send_pkg_ptr a_receive_reply, core::post_listen_status& a_status, int a_timeout_ms )
     {
         std::unique_lock< std::mutex > t_lock( a_receive_reply->f_mutex );
-        auto t_deadline = std::chrono::system_clock::now() + std::chrono::milliseconds( a_timeout_ms );
+        auto t_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( a_timeout_ms );
         while( ! a_receive_reply->f_sent_msg_pkg_ptr )
         {
             std::cv_status t_status = a_receive_reply->f_condition_var.wait_until( t_lock, t_deadline );
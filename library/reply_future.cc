@@ -0,0 +1,152 @@
+/*
+ * reply_future.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "reply_future.hh"
+
+#include "dripline_exceptions.hh"
+
+#include "logger.hh"
+
+#include <chrono>
+
+namespace dripline
+{
+    LOGGER( dlog, "reply_future" );
+
+    reply_future::reply_future() :
+            f_state()
+    {}
+
+    reply_future::reply_future( std::shared_ptr< state > a_state ) :
+            f_state( std::move(a_state) )
+    {}
+
+    reply_future reply_future::make_ready( reply_ptr_t a_reply )
+    {
+        reply_promise t_promise;
+        t_promise.set_reply( std::move(a_reply) );
+        return t_promise.get_future();
+    }
+
+    bool reply_future::valid() const
+    {
+        return bool(f_state);
+    }
+
+    bool reply_future::is_ready() const
+    {
+        if( ! f_state ) return false;
+        std::unique_lock< std::mutex > t_lock( f_state->f_mutex );
+        return f_state->f_ready;
+    }
+
+    reply_ptr_t reply_future::get() const
+    {
+        if( ! f_state ) throw dripline_error() << "Cannot get the reply from an invalid reply_future";
+
+        std::unique_lock< std::mutex > t_lock( f_state->f_mutex );
+        f_state->f_condition.wait( t_lock, [this](){ return f_state->f_ready; } );
+        if( f_state->f_exception ) std::rethrow_exception( f_state->f_exception );
+        return f_state->f_reply;
+    }
+
+    bool reply_future::wait_for( unsigned a_timeout_ms ) const
+    {
+        if( ! f_state ) return false;
+
+        std::unique_lock< std::mutex > t_lock( f_state->f_mutex );
+        return f_state->f_condition.wait_for( t_lock, std::chrono::milliseconds( a_timeout_ms ), [this](){ return f_state->f_ready; } );
+    }
+
+    reply_future reply_future::then( continuation_t a_continuation )
+    {
+        if( ! f_state ) throw dripline_error() << "Cannot attach a continuation to an invalid reply_future";
+
+        reply_promise t_next;
+        // the continuation is stored in the state, so it only holds a weak reference back to it
+        std::weak_ptr< state > t_weak_state = f_state;
+        std::function< void () > t_run = [t_weak_state, t_next, a_continuation]() mutable {
+            try
+            {
+                reply_future t_done( t_weak_state.lock() );
+                t_next.set_reply( a_continuation( t_done ) );
+            }
+            catch( ... )
+            {
+                t_next.set_exception( std::current_exception() );
+            }
+        };
+
+        {
+            std::unique_lock< std::mutex > t_lock( f_state->f_mutex );
+            if( ! f_state->f_ready )
+            {
+                f_state->f_continuations.push_back( std::move(t_run) );
+                return t_next.get_future();
+            }
+        }
+        // already complete: run it now
+        t_run();
+        return t_next.get_future();
+    }
+
+
+    reply_promise::reply_promise() :
+            f_state( std::make_shared< reply_future::state >() )
+    {}
+
+    reply_future reply_promise::get_future() const
+    {
+        return reply_future( f_state );
+    }
+
+    void reply_promise::set_reply( reply_ptr_t a_reply )
+    {
+        complete( std::move(a_reply), std::exception_ptr() );
+        return;
+    }
+
+    void reply_promise::set_exception( std::exception_ptr a_exception )
+    {
+        complete( reply_ptr_t(), a_exception );
+        return;
+    }
+
+    bool reply_promise::is_set() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_state->f_mutex );
+        return f_state->f_ready;
+    }
+
+    void reply_promise::complete( reply_ptr_t a_reply, std::exception_ptr a_exception )
+    {
+        std::vector< std::function< void () > > t_continuations;
+        {
+            std::unique_lock< std::mutex > t_lock( f_state->f_mutex );
+            if( f_state->f_ready )
+            {
+                LWARN( dlog, "Reply promise was already completed; ignoring the new result" );
+                return;
+            }
+            f_state->f_ready = true;
+            f_state->f_reply = std::move(a_reply);
+            f_state->f_exception = a_exception;
+            t_continuations.swap( f_state->f_continuations );
+        }
+        f_state->f_condition.notify_all();
+
+        // continuations run outside the lock so that they can use the future
+        for( auto& t_continuation : t_continuations )
+        {
+            t_continuation();
+        }
+        return;
+    }
+
+} /* namespace dripline */
@@ -0,0 +1,134 @@
+/*
+ * reply_future.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_REPLY_FUTURE_HH_
+#define DRIPLINE_REPLY_FUTURE_HH_
+
+#include "dripline_api.hh"
+#include "dripline_fwd.hh"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dripline
+{
+    class reply_promise;
+
+    /*!
+     @class reply_future
+     @author N.S. Oblath
+
+     @brief The reply to a request that may not have been handled yet
+
+     @details
+     A reply_future is returned by the asynchronous request handlers (`endpoint::do_get_request_async()`, etc.).
+     It's completed through the matching @ref reply_promise, either with a reply or with an exception.
+
+     Unlike `std::future`, a reply_future can have continuations attached with `then()`; each continuation runs once the 
+     future is complete, in the thread that completed it (or right away, in the calling thread, if it's already complete).
+     The continuation is given the completed future, and its return value (or exception) completes the future returned by `then()`.
+
+     Copies of a reply_future refer to the same result.
+    */
+    class DRIPLINE_API reply_future
+    {
+        public:
+            typedef std::function< reply_ptr_t ( reply_future& ) > continuation_t;
+
+        public:
+            /// Creates an invalid future, which has no result and no promise
+            reply_future();
+            reply_future( const reply_future& ) = default;
+            reply_future( reply_future&& ) = default;
+            virtual ~reply_future() = default;
+
+            reply_future& operator=( const reply_future& ) = default;
+            reply_future& operator=( reply_future&& ) = default;
+
+            /// Creates a future that's already complete
+            static reply_future make_ready( reply_ptr_t a_reply );
+
+            /// Returns true if the future is connected to a result
+            bool valid() const;
+            /// Returns true if the result is available
+            bool is_ready() const;
+
+            /// Waits for the result and returns the reply; rethrows the exception if the future was completed with one
+            reply_ptr_t get() const;
+            /// Waits for the result for up to a_timeout_ms; returns true if the result is available
+            bool wait_for( unsigned a_timeout_ms ) const;
+
+            /// Attaches a continuation, and returns a future for the continuation's result
+            reply_future then( continuation_t a_continuation );
+
+        protected:
+            friend class reply_promise;
+
+            struct state
+            {
+                std::mutex f_mutex;
+                std::condition_variable f_condition;
+                bool f_ready = false;
+                reply_ptr_t f_reply;
+                std::exception_ptr f_exception;
+                std::vector< std::function< void () > > f_continuations;
+            };
+
+            reply_future( std::shared_ptr< state > a_state );
+
+            std::shared_ptr< state > f_state;
+    };
+
+    /*!
+     @class reply_promise
+     @author N.S. Oblath
+
+     @brief Completes a @ref reply_future
+
+     @details
+     An asynchronous handler creates a reply_promise, returns `get_future()`, and later calls `set_reply()` (or `set_exception()`) 
+     from whichever thread finishes the work.  Only the first completion has any effect.
+
+     If every copy of the promise is destroyed without being completed, the future is never completed, and the request 
+     is never replied to.
+
+     Copies of a reply_promise complete the same future.
+    */
+    class DRIPLINE_API reply_promise
+    {
+        public:
+            reply_promise();
+            reply_promise( const reply_promise& ) = default;
+            reply_promise( reply_promise&& ) = default;
+            virtual ~reply_promise() = default;
+
+            reply_promise& operator=( const reply_promise& ) = default;
+            reply_promise& operator=( reply_promise&& ) = default;
+
+            reply_future get_future() const;
+
+            /// Completes the future with a reply
+            void set_reply( reply_ptr_t a_reply );
+            /// Completes the future with an exception, which is rethrown by `reply_future::get()`
+            void set_exception( std::exception_ptr a_exception );
+
+            /// Returns true if the future has been completed
+            bool is_set() const;
+
+        protected:
+            void complete( reply_ptr_t a_reply, std::exception_ptr a_exception );
+
+            std::shared_ptr< reply_future::state > f_state;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_REPLY_FUTURE_HH_ */
@@ -0,0 +1,181 @@
+/*
+ * reply_publisher.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "reply_publisher.hh"
+
+#include "core.hh"
+#include "dripline_exceptions.hh"
+#include "message.hh"
+
+#include "logger.hh"
+
+#include <vector>
+
+namespace dripline
+{
+    LOGGER( dlog, "reply_publisher" );
+
+    reply_publisher::reply_publisher( const core& a_core, unsigned a_max_batch_size ) :
+            f_max_batch_size( a_max_batch_size > 0 ? a_max_batch_size : 1 ),
+            f_failure_callback(),
+            f_core( a_core ),
+            f_channel(),
+            f_mutex(),
+            f_condition(),
+            f_queue(),
+            f_running( false ),
+            f_thread(),
+            f_n_published( 0 ),
+            f_n_failed( 0 )
+    {}
+
+    reply_publisher::~reply_publisher()
+    {
+        stop();
+    }
+
+    bool reply_publisher::start()
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        if( f_running ) return true;
+
+        if( ! prepare_channel() )
+        {
+            LERROR( dlog, "Unable to set up the channel for publishing replies" );
+            return false;
+        }
+
+        f_running = true;
+        f_thread = std::thread( &reply_publisher::execute, this );
+        return true;
+    }
+
+    void reply_publisher::stop()
+    {
+        {
+            std::unique_lock< std::mutex > t_lock( f_mutex );
+            f_running = false;
+        }
+        f_condition.notify_all();
+
+        // the thread publishes whatever is left in the queue before it exits
+        if( f_thread.joinable() ) f_thread.join();
+        return;
+    }
+
+    bool reply_publisher::submit( reply_ptr_t a_reply )
+    {
+        {
+            std::unique_lock< std::mutex > t_lock( f_mutex );
+            if( ! f_running ) return false;
+            f_queue.push_back( std::move(a_reply) );
+        }
+        f_condition.notify_one();
+        return true;
+    }
+
+    unsigned reply_publisher::size() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_queue.size();
+    }
+
+    bool reply_publisher::is_running() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_running;
+    }
+
+    uint64_t reply_publisher::n_published() const
+    {
+        return f_n_published.load();
+    }
+
+    uint64_t reply_publisher::n_failed() const
+    {
+        return f_n_failed.load();
+    }
+
+    void reply_publisher::execute()
+    {
+        std::vector< reply_ptr_t > t_batch;
+        t_batch.reserve( f_max_batch_size );
+        while( true )
+        {
+            {
+                std::unique_lock< std::mutex > t_lock( f_mutex );
+                f_condition.wait( t_lock, [this](){ return ! f_queue.empty() || ! f_running; } );
+                if( f_queue.empty() ) break; // only happens once stopped
+
+                while( ! f_queue.empty() && t_batch.size() < f_max_batch_size )
+                {
+                    t_batch.push_back( std::move(f_queue.front()) );
+                    f_queue.pop_front();
+                }
+            }
+
+            LTRACE( dlog, "Publishing a batch of " << t_batch.size() << " reply(ies)" );
+            std::string t_error_message;
+            for( reply_ptr_t& t_reply : t_batch )
+            {
+                if( ! f_channel && ! prepare_channel() )
+                {
+                    report_failure( t_reply, "Unable to reopen the channel for publishing replies" );
+                    continue;
+                }
+
+                if( publish( t_reply, t_error_message ) ) ++f_n_published;
+                else report_failure( t_reply, t_error_message );
+            }
+            t_batch.clear();
+        }
+        return;
+    }
+
+    bool reply_publisher::prepare_channel()
+    {
+        if( ! f_channel ) f_channel = f_core.open_channel();
+        if( ! f_channel ) return false;
+
+        if( ! core::setup_exchange( f_channel, f_core.requests_exchange() ) )
+        {
+            f_channel.reset();
+            return false;
+        }
+        return true;
+    }
+
+    bool reply_publisher::publish( reply_ptr_t a_reply, std::string& a_error_message )
+    {
+        try
+        {
+            return f_core.publish_message( a_reply, f_core.requests_exchange(), f_channel, a_error_message );
+        }
+        catch( connection_error& e )
+        {
+            // the channel is reopened for the next reply
+            f_channel.reset();
+            a_error_message = e.what();
+        }
+        catch( dripline_error& e )
+        {
+            a_error_message = e.what();
+        }
+        return false;
+    }
+
+    void reply_publisher::report_failure( reply_ptr_t a_reply, const std::string& a_error_message )
+    {
+        ++f_n_failed;
+        LERROR( dlog, "Failed to publish reply to <" << a_reply->routing_key() << ">:\n" << a_error_message );
+        if( f_failure_callback ) f_failure_callback( a_reply, a_error_message );
+        return;
+    }
+
+} /* namespace dripline */
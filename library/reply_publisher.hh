@@ -0,0 +1,112 @@
+/*
+ * reply_publisher.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_REPLY_PUBLISHER_HH_
+#define DRIPLINE_REPLY_PUBLISHER_HH_
+
+#include "amqp.hh"
+#include "dripline_api.hh"
+#include "dripline_fwd.hh"
+
+#include "member_variables.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace dripline
+{
+    class core;
+
+    /*!
+     @class reply_publisher
+     @author N.S. Oblath
+
+     @brief Publishes reply messages from its own thread, so that request handlers don't wait for the broker
+
+     @details
+     Replies are handed over with `submit()`, which only adds them to a queue.  The publisher thread takes the replies
+     that have accumulated (up to `max_batch_size` at a time) and publishes them one after another on a single long-lived
+     channel.  The channel is opened, and the requests exchange declared, once when the publisher starts, instead of
+     for every reply.
+
+     If the connection is lost, the channel is reopened before the next reply is published.  A reply that can't be
+     published is counted in `n_failed()` and passed, with the reason, to the failure callback, if one is set.
+     The callback is called from the publisher thread.
+
+     @ref service uses a reply_publisher for all of its replies (including those from its children)
+     when `async_reply_publishing` is enabled.
+
+     Classes that override `publish()` should call `stop()` in their destructors, so the thread is not still publishing
+     while the derived object is destroyed.
+    */
+    class DRIPLINE_API reply_publisher
+    {
+        public:
+            typedef std::function< void ( reply_ptr_t, const std::string& ) > failure_callback_t;
+
+        public:
+            reply_publisher( const core& a_core, unsigned a_max_batch_size = 100 );
+            reply_publisher( const reply_publisher& ) = delete;
+            reply_publisher( reply_publisher&& ) = delete;
+            virtual ~reply_publisher();
+
+            reply_publisher& operator=( const reply_publisher& ) = delete;
+            reply_publisher& operator=( reply_publisher&& ) = delete;
+
+            /// Opens the channel and starts the publisher thread; returns false if the channel could not be set up
+            bool start();
+            /// Publishes the replies that are already queued, then stops the publisher thread
+            void stop();
+
+            /// Queues a reply to be published; returns false if the publisher is not running
+            bool submit( reply_ptr_t a_reply );
+
+            /// Number of replies waiting to be published
+            unsigned size() const;
+            bool is_running() const;
+
+            /// Number of replies that have been published
+            uint64_t n_published() const;
+            /// Number of replies that could not be published
+            uint64_t n_failed() const;
+
+            mv_accessible( unsigned, max_batch_size );
+            /// Called for each reply that could not be published; set before calling `start()`
+            mv_referrable( failure_callback_t, failure_callback );
+
+        protected:
+            void execute();
+
+            /// Opens the channel (if needed) and declares the exchange; returns false on failure
+            virtual bool prepare_channel();
+            /// Publishes one reply on the channel; returns false, with the reason in a_error_message, on failure
+            virtual bool publish( reply_ptr_t a_reply, std::string& a_error_message );
+
+            void report_failure( reply_ptr_t a_reply, const std::string& a_error_message );
+
+            const core& f_core;
+            amqp_channel_ptr f_channel;
+
+            mutable std::mutex f_mutex;
+            std::condition_variable f_condition;
+            std::deque< reply_ptr_t > f_queue;
+            bool f_running;
+            std::thread f_thread;
+
+            std::atomic< uint64_t > f_n_published;
+            std::atomic< uint64_t > f_n_failed;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_REPLY_PUBLISHER_HH_ */
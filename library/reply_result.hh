@@ -0,0 +1,117 @@
+/*
+ * reply_result.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_REPLY_RESULT_HH_
+#define DRIPLINE_REPLY_RESULT_HH_
+
+#include "return_codes.hh"
+
+#include "member_variables.hh"
+#include "param.hh"
+
+#include <string>
+
+namespace dripline
+{
+
+    /*!
+     @class reply_result
+     @author N.S. Oblath
+     @brief The outcome of handling a request, returned by value instead of thrown
+
+     @details
+     A reply_result holds the same three pieces of information as a @ref throw_reply (return code, return message, and payload), 
+     but it's meant to be returned from a function rather than thrown.  It's turned into a reply with 
+     `msg_request::reply( reply_result&& )`, which moves the message and payload into the reply.
+
+     Reporting an error this way costs about the same as reporting success: there's no exception unwind, no string stream, 
+     and no copy of the payload.  This matters for handlers that often fail, e.g. when polling hardware that's offline.
+
+     Functions deep in a handler's call stack can return a reply_result without having access to the request, and hub handlers 
+     can return one directly (see `hub::register_get_handler()`, etc.).
+
+     The payload is optional; if it's not set, the reply gets an empty payload.
+
+     ~~~
+     reply_result read_value()
+     {
+         if( ! f_device.is_connected() ) return reply_result( dl_resource_error(), "Device is offline" );
+         return reply_result::success( "", std::move(t_value_payload) );
+     }
+     ~~~
+    */
+    class DRIPLINE_API reply_result
+    {
+        public:
+            reply_result( const return_code& a_code, std::string a_message = "", scarab::param_ptr_t a_payload = scarab::param_ptr_t() );
+            reply_result( unsigned a_code_value, std::string a_message = "", scarab::param_ptr_t a_payload = scarab::param_ptr_t() );
+            reply_result( const reply_result& ) = delete;
+            reply_result( reply_result&& ) = default;
+            virtual ~reply_result() = default;
+
+            reply_result& operator=( const reply_result& ) = delete;
+            reply_result& operator=( reply_result&& ) = default;
+
+            /// Creates a result with the success return code
+            static reply_result success( std::string a_message = "", scarab::param_ptr_t a_payload = scarab::param_ptr_t() );
+
+            bool is_success() const;
+
+            mv_accessible( unsigned, return_code );
+            mv_referrable( std::string, return_message );
+
+            const scarab::param_ptr_t& get_payload_ptr() const;
+            void set_payload( scarab::param_ptr_t a_payload );
+            /// Moves the payload out of the result; returns an empty param if no payload was set
+            scarab::param_ptr_t take_payload();
+
+        protected:
+            scarab::param_ptr_t f_payload;
+    };
+
+    inline reply_result::reply_result( const return_code& a_code, std::string a_message, scarab::param_ptr_t a_payload ) :
+            f_return_code( a_code.rc_value() ),
+            f_return_message( std::move(a_message) ),
+            f_payload( std::move(a_payload) )
+    {}
+
+    inline reply_result::reply_result( unsigned a_code_value, std::string a_message, scarab::param_ptr_t a_payload ) :
+            f_return_code( a_code_value ),
+            f_return_message( std::move(a_message) ),
+            f_payload( std::move(a_payload) )
+    {}
+
+    inline reply_result reply_result::success( std::string a_message, scarab::param_ptr_t a_payload )
+    {
+        return reply_result( dl_success::s_value, std::move(a_message), std::move(a_payload) );
+    }
+
+    inline bool reply_result::is_success() const
+    {
+        return f_return_code == dl_success::s_value;
+    }
+
+    inline const scarab::param_ptr_t& reply_result::get_payload_ptr() const
+    {
+        return f_payload;
+    }
+
+    inline void reply_result::set_payload( scarab::param_ptr_t a_payload )
+    {
+        f_payload = std::move(a_payload);
+        return;
+    }
+
+    inline scarab::param_ptr_t reply_result::take_payload()
+    {
+        if( ! f_payload ) return scarab::param_ptr_t( new scarab::param() );
+        return std::move(f_payload);
+    }
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_REPLY_RESULT_HH_ */
@@ -0,0 +1,93 @@
+/*
+ * request_stats.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "request_stats.hh"
+
+#include <cmath>
+
+namespace dripline
+{
+
+    request_stats::request_stats() :
+            f_bins(),
+            f_n_total( 0 ),
+            f_snapshot_mutex(),
+            f_interval_start( clock_t::now() )
+    {
+        for( auto& t_bin : f_bins ) t_bin.store( 0 );
+    }
+
+    void request_stats::record( clock_t::duration a_latency )
+    {
+        int64_t t_latency_us = std::chrono::duration_cast< std::chrono::microseconds >( a_latency ).count();
+        f_bins[ bin( t_latency_us > 0 ? uint64_t(t_latency_us) : 0 ) ].fetch_add( 1, std::memory_order_relaxed );
+        f_n_total.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+
+    request_stats::snapshot request_stats::take_snapshot()
+    {
+        std::unique_lock< std::mutex > t_lock( f_snapshot_mutex );
+
+        snapshot t_snapshot;
+        t_snapshot.f_n_total = f_n_total.load();
+
+        std::array< uint64_t, s_n_bins > t_counts;
+        for( unsigned i_bin = 0; i_bin < s_n_bins; ++i_bin )
+        {
+            t_counts[i_bin] = f_bins[i_bin].exchange( 0 );
+            t_snapshot.f_n_requests += t_counts[i_bin];
+        }
+
+        clock_t::time_point t_now = clock_t::now();
+        t_snapshot.f_interval_s = std::chrono::duration< double >( t_now - f_interval_start ).count();
+        f_interval_start = t_now;
+        if( t_snapshot.f_interval_s > 0. ) t_snapshot.f_rate = double(t_snapshot.f_n_requests) / t_snapshot.f_interval_s;
+
+        if( t_snapshot.f_n_requests == 0 ) return t_snapshot;
+
+        // percentiles are the upper edges of the bins in which they fall
+        uint64_t t_p50_count = ( t_snapshot.f_n_requests + 1 ) / 2;
+        uint64_t t_p99_count = t_snapshot.f_n_requests - t_snapshot.f_n_requests / 100;
+        uint64_t t_cumulative = 0;
+        bool t_p50_found = false;
+        for( unsigned i_bin = 0; i_bin < s_n_bins; ++i_bin )
+        {
+            t_cumulative += t_counts[i_bin];
+            if( ! t_p50_found && t_cumulative >= t_p50_count )
+            {
+                t_snapshot.f_p50_ms = 1.e-3 * bin_upper_edge_us( i_bin );
+                t_p50_found = true;
+            }
+            if( t_cumulative >= t_p99_count )
+            {
+                t_snapshot.f_p99_ms = 1.e-3 * bin_upper_edge_us( i_bin );
+                break;
+            }
+        }
+        return t_snapshot;
+    }
+
+    uint64_t request_stats::n_total() const
+    {
+        return f_n_total.load();
+    }
+
+    unsigned request_stats::bin( uint64_t a_latency_us )
+    {
+        unsigned t_bin = unsigned( s_bins_per_octave * std::log2( double(a_latency_us) + 1. ) );
+        return t_bin < s_n_bins ? t_bin : s_n_bins - 1;
+    }
+
+    double request_stats::bin_upper_edge_us( unsigned a_bin )
+    {
+        return std::exp2( double(a_bin + 1) / s_bins_per_octave ) - 1.;
+    }
+
+} /* namespace dripline */
@@ -0,0 +1,97 @@
+/*
+ * request_stats.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_REQUEST_STATS_HH_
+#define DRIPLINE_REQUEST_STATS_HH_
+
+#include "dripline_api.hh"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace dripline
+{
+
+    /*!
+     @class request_stats
+     @author N.S. Oblath
+
+     @brief Counts handled requests and keeps a histogram of how long they took
+
+     @details
+     An endpoint with a request_stats (see `endpoint::on_request_message()`) records each request it handles, with the time
+     from when the request was received until its reply was ready.  A service shares one request_stats with its children
+     when it includes statistics in its heartbeats (see @ref heartbeater).
+
+     Recording a request only increments atomic counters, so it's cheap enough to do for every request.  The latencies are
+     kept in a histogram with four logarithmic bins per factor of 2, from 1 us to about an hour, so percentiles are
+     accurate to about 20%.
+
+     `take_snapshot()` returns the request rate and latency percentiles for the requests recorded since the previous
+     snapshot, and starts a new interval.  All functions are thread-safe.
+    */
+    class DRIPLINE_API request_stats
+    {
+        public:
+            typedef std::chrono::steady_clock clock_t;
+
+            struct snapshot
+            {
+                /// Total number of requests recorded
+                uint64_t f_n_total = 0;
+                /// Number of requests recorded in the interval
+                uint64_t f_n_requests = 0;
+                /// Length of the interval in s
+                double f_interval_s = 0.;
+                /// Requests per second in the interval
+                double f_rate = 0.;
+                /// Median latency in the interval, in ms
+                double f_p50_ms = 0.;
+                /// 99th-percentile latency in the interval, in ms
+                double f_p99_ms = 0.;
+            };
+
+        public:
+            request_stats();
+            request_stats( const request_stats& ) = delete;
+            request_stats( request_stats&& ) = delete;
+            virtual ~request_stats() = default;
+
+            request_stats& operator=( const request_stats& ) = delete;
+            request_stats& operator=( request_stats&& ) = delete;
+
+            /// Records a handled request that took a_latency
+            void record( clock_t::duration a_latency );
+
+            /// Returns the statistics for the interval since the previous snapshot, and starts a new interval
+            snapshot take_snapshot();
+
+            /// Total number of requests recorded
+            uint64_t n_total() const;
+
+            static const unsigned s_n_bins = 128;
+            static const unsigned s_bins_per_octave = 4;
+
+            /// Histogram bin for a latency in us
+            static unsigned bin( uint64_t a_latency_us );
+            /// Upper edge of a histogram bin, in us
+            static double bin_upper_edge_us( unsigned a_bin );
+
+        protected:
+            std::array< std::atomic< uint64_t >, s_n_bins > f_bins;
+            std::atomic< uint64_t > f_n_total;
+
+            std::mutex f_snapshot_mutex;
+            clock_t::time_point f_interval_start;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_REQUEST_STATS_HH_ */
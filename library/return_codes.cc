@@ -74,6 +74,7 @@ namespace dripline
     IMPLEMENT_DL_RET_CODE( service_error_invalid_key, 308, "Invalid Lockout Key" );
     // 309 was formerly "Deprecated Feature"
     IMPLEMENT_DL_RET_CODE( service_error_invalid_specifier, 310, "Invalid Specifier" );
+    IMPLEMENT_DL_RET_CODE( service_error_overloaded, 311, "Service Overloaded; Retry Later" );
 
     IMPLEMENT_DL_RET_CODE( client_error, 400, "Generic Client Error" );
     IMPLEMENT_DL_RET_CODE( client_error_invalid_request, 401, "Invalid Request" );
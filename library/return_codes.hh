@@ -151,6 +151,7 @@ namespace dripline
     DEFINE_DL_RET_CODE( service_error_access_denied, DRIPLINE_API );
     DEFINE_DL_RET_CODE( service_error_invalid_key, DRIPLINE_API );
     DEFINE_DL_RET_CODE( service_error_invalid_specifier, DRIPLINE_API );
+    DEFINE_DL_RET_CODE( service_error_overloaded, DRIPLINE_API );
 
     DEFINE_DL_RET_CODE( client_error, DRIPLINE_API );
     DEFINE_DL_RET_CODE( client_error_invalid_request, DRIPLINE_API );
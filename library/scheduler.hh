@@ -15,13 +15,18 @@
 #include "logger.hh"
 #include "member_variables.hh"
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <thread>
-#include <map>
 #include <mutex>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 LOGGER( dlog_sh, "scheduler" )
 
@@ -44,7 +49,7 @@ namespace dripline
         virtual ~base_executor() = default;
         base_executor& operator=( const base_executor& ) = default;
         base_executor& operator=( base_executor&& ) = default;
-        virtual void operator()( std::function< void() > ) = 0;
+        virtual void operator()( const std::function< void() >& ) = 0;
     };
 
     /*!
@@ -61,7 +66,7 @@ namespace dripline
         virtual ~simple_executor() = default;
         simple_executor& operator=( const simple_executor& ) = default;
         simple_executor& operator=( simple_executor&& ) = default;
-        virtual void operator()( std::function< void() > an_executable )
+        virtual void operator()( const std::function< void() >& an_executable )
         {
             LDEBUG( dlog_sh, "executing" );
             an_executable();
@@ -69,6 +74,102 @@ namespace dripline
         }
     };
 
+    /*!
+     @enum missed_tick_policy
+     @brief What a @ref scheduler does with a repeating event whose next tick is already due when it runs (i.e. it's more than one interval late)
+    */
+    enum class missed_tick_policy
+    {
+        catch_up, ///< Every tick is executed, so the missed ticks run back to back
+        coalesce, ///< The late tick is executed once in place of all of the missed ticks, and the event continues at the next aligned tick
+        skip ///< The late and missed ticks are not executed; the event continues at the next aligned tick
+    };
+
+    /*!
+     @class event_queue
+     @author N.S. Oblath
+
+     @brief Scheduled events, ordered by execution time and indexed by ID
+
+     @details
+     Events are stored in a hash map by ID, and their execution times are kept in a binary heap.  Adding an event 
+     takes O(log n) time; removing an event by ID takes O(1) time: the event is removed from the map, and its heap entry 
+     is left behind to be discarded when it reaches the top of the heap (or when stale entries outnumber the live ones, 
+     at which point the heap is rebuilt).
+
+     `reschedule_next()` moves the earliest event to a new time without touching the event itself, so re-arming a 
+     repeating event doesn't allocate anything.
+
+     Events with the same execution time are kept in the order in which they were added.
+
+     The event type must have an `int f_id` member.  This class is not thread-safe.
+    */
+    template< typename time_point_t, typename event_t >
+    class event_queue
+    {
+        public:
+            event_queue() = default;
+            event_queue( const event_queue& ) = default;
+            event_queue( event_queue&& ) = default;
+            ~event_queue() = default;
+
+            event_queue& operator=( const event_queue& ) = default;
+            event_queue& operator=( event_queue&& ) = default;
+
+            /// Number of scheduled events
+            std::size_t size() const { return f_events.size(); }
+            bool empty() const { return f_events.empty(); }
+            bool contains( int an_id ) const { return f_events.count( an_id ) > 0; }
+
+            /// Adds an event; returns true if it's now the earliest event
+            bool insert( time_point_t a_time, event_t an_event );
+            /// Removes an event; returns false if there's no event with that ID
+            bool erase( int an_id );
+            void clear();
+
+            /// Returns the event with the given ID, or nullptr if there isn't one
+            event_t* find( int an_id );
+            const event_t* find( int an_id ) const;
+
+            /// Execution time of the earliest event; the queue must not be empty
+            time_point_t next_time();
+            /// The earliest event; the queue must not be empty
+            event_t& next_event();
+            /// Removes and returns the earliest event; the queue must not be empty
+            event_t pop_next();
+            /// Moves the earliest event to a new execution time; the queue must not be empty
+            void reschedule_next( time_point_t a_time );
+
+        protected:
+            struct heap_entry
+            {
+                time_point_t f_time;
+                uint64_t f_sequence;
+                int f_id;
+                // std::push_heap and friends make a max-heap, so "less" means later
+                bool operator<( const heap_entry& a_rhs ) const
+                {
+                    return f_time > a_rhs.f_time || ( f_time == a_rhs.f_time && f_sequence > a_rhs.f_sequence );
+                }
+            };
+
+            struct stored_event
+            {
+                event_t f_event;
+                /// Sequence number of the event's live heap entry
+                uint64_t f_sequence;
+            };
+
+            bool is_stale( const heap_entry& an_entry ) const;
+            /// Removes stale entries from the top of the heap
+            void prune_top();
+
+            std::vector< heap_entry > f_heap;
+            std::unordered_map< int, stored_event > f_events;
+            uint64_t f_next_sequence = 0;
+            std::size_t f_n_stale = 0;
+    };
+
     /*!
      @class scheduler
      @author N.S. Oblath
@@ -92,12 +193,36 @@ namespace dripline
 
      There are a variety of factors that can make execution of an event late.  For instance, 
      if the execution time of events is long compared to the time between them, then events 
-     will start to get delayed.  This could potentially be allayed by implementing a more complex 
-     @ref executor class that uses a pool of threaded workers, but that is not supplied in the 
-     current implementation.
+     will start to get delayed.  This can be allayed by using @ref pool_executor, which runs events 
+     on a pool of threaded workers.
+
+     The scheduler lock is not held while an event is handed to the executor, so events can be 
+     scheduled and unscheduled (including by the events themselves) while others are executing.  
+     A repeating event is re-armed for its next execution time before it's handed to the executor.  
+     The executor mutex is locked before the scheduler lock is released, and is held while the event is handed 
+     to the executor, so after unscheduling an event, locking the executor mutex waits for an execution of 
+     that event that was already on its way to the executor.
+
+     Repeating events tick at the first execution time plus whole multiples of the interval, so lateness doesn't 
+     accumulate.  If an event is running so late that its next tick is already due, its @ref missed_tick_policy 
+     determines whether the missed ticks are run back to back (`catch_up`, the default), replaced by a single 
+     execution (`coalesce`), or dropped (`skip`).  Execution statistics for each repeating event, including how late 
+     it has been executed, are available from `get_event_stats()`.
+
+     Events can be executed up to one execution buffer early, so the execution buffer bounds the jitter of on-time 
+     events.  Repeating events need an interval of at least twice the execution buffer; use a shorter execution 
+     buffer for shorter intervals.
+
+     If the executor can be called with the event ID as a second argument (as @ref pool_executor can), 
+     it is; that lets the executor recognize repeated runs of the same event.
 
      Each scheduled thread is assigned a unique ID, which is returned when the event is scheduled. 
      That ID can be used to unschedule an event (repeating or one-off).
+
+     The events are stored in an @ref event_queue, so unscheduling an event takes constant time, and re-arming 
+     a repeating event doesn't allocate.  The executable is stored once, when the event is scheduled, and each run 
+     only copies a pointer to it; executors get it by reference, so an executor that runs it right away (like 
+     @ref simple_executor) doesn't copy it either.
     */
     template< typename executor = simple_executor, typename clock = std::chrono::system_clock >
     class DRIPLINE_API scheduler : virtual public scarab::cancelable
@@ -107,6 +232,23 @@ namespace dripline
             using time_point_t = typename clock::time_point;
             using duration_t = typename clock::duration;
             using executable_t = std::function< void() >;
+            using executable_ptr_t = std::shared_ptr< const executable_t >;
+
+            /*!
+             @struct event_stats
+             @brief Execution statistics for a repeating event.  Lateness is the time between a tick and the event being handed to the executor; it's negative if the event was executed early (within the execution buffer).
+            */
+            struct event_stats
+            {
+                /// Number of times the event was executed
+                uint64_t f_n_executed = 0;
+                /// Number of ticks that were not executed because of the missed-tick policy
+                uint64_t f_n_missed = 0;
+                duration_t f_last_lateness = duration_t::zero();
+                duration_t f_max_lateness = duration_t::zero();
+                /// Sum of the lateness of all executions; divide by f_n_executed for the mean
+                duration_t f_total_lateness = duration_t::zero();
+            };
 
             /*!
              @struct event
@@ -114,10 +256,15 @@ namespace dripline
             */
             struct event
             {
-                executable_t f_executable;
+                /// Shared with the runs that have been handed to the executor, so that a repeating event isn't copied for each run
+                executable_ptr_t f_executable;
                 int f_id;
+                /// Repetition interval; zero for one-off events
+                duration_t f_interval = duration_t::zero();
+                missed_tick_policy f_missed_tick_policy = missed_tick_policy::catch_up;
+                event_stats f_stats;
             };
-            typedef std::multimap< time_point_t, event > events_map_t;
+            typedef event_queue< time_point_t, event > events_t;
 
             scheduler();
             scheduler( const scheduler& ) = delete;
@@ -138,18 +285,26 @@ namespace dripline
             /*!
              Schedule a repeating event
              @param an_executable The executable to be used for the event
-             @param an_interval The repetition interval
+             @param an_interval The repetition interval; must be at least twice the execution buffer
              @param an_exe_time The first execution time; default: now.
+             @param a_policy What to do when ticks are missed
              @return The ID for the scheduled event.
             */
-            int schedule( executable_t an_executable, duration_t an_interval, time_point_t an_exe_time = clock::now() );
+            int schedule( executable_t an_executable, duration_t an_interval, time_point_t an_exe_time = clock::now(), missed_tick_policy a_policy = missed_tick_policy::catch_up );
 
             /// Unschedule an event using the event's ID
             void unschedule( int an_id );
 
+            /// Gets the execution statistics for a scheduled event; returns false if there's no event with that ID
+            bool get_event_stats( int an_id, event_stats& a_stats );
+
             /// Main execution loop for the scheduler
             void execute();
 
+            /// Executes all of the events that are due (within one execution buffer of now), without waiting; returns the number executed.
+            /// This is used by `execute()`, and can be used directly to drive the scheduler from another loop or with a simulated clock.
+            unsigned run_due_events();
+
             /// The time difference from "now" that determines whether an event is executed
             mv_accessible( duration_t, exe_buffer );
 
@@ -157,18 +312,28 @@ namespace dripline
             mv_accessible( duration_t, cycle_time );
 
             /// The executor used to execute events.  
-            mv_referrable_const( executor, the_executor );
+            mv_referrable( executor, the_executor );
 
-            /// The scheduled events, stored in a map sorted by execution time
-            mv_referrable_const( events_map_t, events );
+            /// The scheduled events, in order of execution time
+            mv_referrable_const( events_t, events );
 
             /// The ID to be used for the next scheduled event
             mv_accessible_static( int, curr_id )
 
         protected:
-            void schedule_repeating( executable_t an_executable, duration_t an_interval, int an_id, time_point_t a_rep_start = clock::now() );
+            void schedule_repeating( executable_t an_executable, duration_t an_interval, int an_id, time_point_t a_rep_start = clock::now(), missed_tick_policy a_policy = missed_tick_policy::catch_up );
 
-            std::recursive_mutex f_scheduler_mutex;  // recursive_mutex is used so that the mutex can be locked twice by the same thread when using a repeating schedule
+            /// Adds an event, and calls `on_new_first_event()` if it's the new first event; the scheduler mutex must be locked
+            void insert_event( time_point_t an_exe_time, event&& an_event );
+
+            /// Called with the scheduler mutex locked when an event becomes the first in the schedule.
+            /// The default wakes the execution thread; override it to drive the scheduler from somewhere else (e.g. @ref timer_service).
+            virtual void on_new_first_event();
+
+            /// Hands an event to the executor, with its ID if the executor accepts one
+            void dispatch( const executable_t& an_executable, int an_id );
+
+            std::recursive_mutex f_scheduler_mutex;  // recursive_mutex is used so that the mutex can be locked twice by the same thread when scheduling a repeating event
 
             std::mutex f_executor_mutex;
 
@@ -176,6 +341,116 @@ namespace dripline
             std::thread f_scheduler_thread;
     };
 
+    template< typename time_point_t, typename event_t >
+    bool event_queue< time_point_t, event_t >::insert( time_point_t a_time, event_t an_event )
+    {
+        bool t_new_first = empty() || a_time < next_time();
+        int t_id = an_event.f_id;
+        uint64_t t_sequence = f_next_sequence++;
+        // if an event with this ID was already scheduled, it's replaced, and its heap entry becomes stale
+        if( ! f_events.insert_or_assign( t_id, stored_event{ std::move(an_event), t_sequence } ).second ) ++f_n_stale;
+        f_heap.push_back( heap_entry{ a_time, t_sequence, t_id } );
+        std::push_heap( f_heap.begin(), f_heap.end() );
+        return t_new_first;
+    }
+
+    template< typename time_point_t, typename event_t >
+    bool event_queue< time_point_t, event_t >::erase( int an_id )
+    {
+        if( f_events.erase( an_id ) == 0 ) return false;
+
+        // the heap entry is now stale; rebuild the heap if it's mostly stale entries
+        ++f_n_stale;
+        if( f_n_stale > 64 && f_n_stale > f_heap.size() / 2 )
+        {
+            f_heap.erase( std::remove_if( f_heap.begin(), f_heap.end(), [this]( const heap_entry& an_entry ){ return is_stale( an_entry ); } ), f_heap.end() );
+            std::make_heap( f_heap.begin(), f_heap.end() );
+            f_n_stale = 0;
+        }
+        return true;
+    }
+
+    template< typename time_point_t, typename event_t >
+    void event_queue< time_point_t, event_t >::clear()
+    {
+        f_heap.clear();
+        f_events.clear();
+        f_n_stale = 0;
+        return;
+    }
+
+    template< typename time_point_t, typename event_t >
+    event_t* event_queue< time_point_t, event_t >::find( int an_id )
+    {
+        auto t_event_it = f_events.find( an_id );
+        return t_event_it == f_events.end() ? nullptr : &t_event_it->second.f_event;
+    }
+
+    template< typename time_point_t, typename event_t >
+    const event_t* event_queue< time_point_t, event_t >::find( int an_id ) const
+    {
+        auto t_event_it = f_events.find( an_id );
+        return t_event_it == f_events.end() ? nullptr : &t_event_it->second.f_event;
+    }
+
+    template< typename time_point_t, typename event_t >
+    time_point_t event_queue< time_point_t, event_t >::next_time()
+    {
+        prune_top();
+        return f_heap.front().f_time;
+    }
+
+    template< typename time_point_t, typename event_t >
+    event_t& event_queue< time_point_t, event_t >::next_event()
+    {
+        prune_top();
+        return f_events.find( f_heap.front().f_id )->second.f_event;
+    }
+
+    template< typename time_point_t, typename event_t >
+    event_t event_queue< time_point_t, event_t >::pop_next()
+    {
+        prune_top();
+        auto t_event_it = f_events.find( f_heap.front().f_id );
+        event_t t_event = std::move( t_event_it->second.f_event );
+        f_events.erase( t_event_it );
+        std::pop_heap( f_heap.begin(), f_heap.end() );
+        f_heap.pop_back();
+        return t_event;
+    }
+
+    template< typename time_point_t, typename event_t >
+    void event_queue< time_point_t, event_t >::reschedule_next( time_point_t a_time )
+    {
+        prune_top();
+        std::pop_heap( f_heap.begin(), f_heap.end() );
+        heap_entry& t_entry = f_heap.back();
+        t_entry.f_time = a_time;
+        t_entry.f_sequence = f_next_sequence++;
+        f_events.find( t_entry.f_id )->second.f_sequence = t_entry.f_sequence;
+        std::push_heap( f_heap.begin(), f_heap.end() );
+        return;
+    }
+
+    template< typename time_point_t, typename event_t >
+    bool event_queue< time_point_t, event_t >::is_stale( const heap_entry& an_entry ) const
+    {
+        auto t_event_it = f_events.find( an_entry.f_id );
+        return t_event_it == f_events.end() || t_event_it->second.f_sequence != an_entry.f_sequence;
+    }
+
+    template< typename time_point_t, typename event_t >
+    void event_queue< time_point_t, event_t >::prune_top()
+    {
+        while( ! f_heap.empty() && is_stale( f_heap.front() ) )
+        {
+            std::pop_heap( f_heap.begin(), f_heap.end() );
+            f_heap.pop_back();
+            if( f_n_stale > 0 ) --f_n_stale;
+        }
+        return;
+    }
+
     template< typename executor, typename clock >
     int scheduler< executor, clock >::s_curr_id = 0;
 
@@ -232,84 +507,67 @@ namespace dripline
     template< typename executor, typename clock >
     int scheduler< executor, clock >::schedule( executable_t an_executable, time_point_t an_exe_time )
     {
-        bool t_new_first = false;
         std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
-        if( f_events.empty() || an_exe_time < f_events.begin()->first )
-        {
-            LDEBUG( dlog_sh, "New first event" );
-            t_new_first = true;
-        }
         LDEBUG( dlog_sh, "Inserting new event" );
         event t_event;
-        t_event.f_executable = an_executable;
+        t_event.f_executable = std::make_shared< const executable_t >( std::move(an_executable) );
         t_event.f_id = s_curr_id++;
-        f_events.insert( std::make_pair( an_exe_time, t_event ) );
-        if( t_new_first )
-        {
-            // wake the waiting thread
-            LDEBUG( dlog_sh, "That event was first; waking execution thread" );
-            f_cv.notify_one();
-        }
-
-        return t_event.f_id;
+        int t_id = t_event.f_id;
+        insert_event( an_exe_time, std::move(t_event) );
+        return t_id;
     }
 
     template< typename executor, typename clock >
-    int scheduler< executor, clock >::schedule( executable_t an_executable, duration_t an_interval, time_point_t an_exe_time )
+    int scheduler< executor, clock >::schedule( executable_t an_executable, duration_t an_interval, time_point_t an_exe_time, missed_tick_policy a_policy )
     {
         // if the interval is too short, it's more likely that the execution time will be longer than the interval
+        // shorter intervals can be used with a shorter execution buffer
         if( an_interval < 2*f_exe_buffer )
         {
-            throw dripline_error() << "Cannot schedule executions with an interval of less than " <<  std::chrono::duration_cast<std::chrono::seconds>(2*f_exe_buffer).count() << " seconds";
+            throw dripline_error() << "Cannot schedule executions with an interval of less than " << std::chrono::duration< double, std::milli >(2*f_exe_buffer).count() << " ms (twice the execution buffer)";
         }
 
         std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
         int t_id = scheduler< executor, clock >::s_curr_id++;
-        schedule_repeating( an_executable, an_interval, t_id, an_exe_time );
+        schedule_repeating( std::move(an_executable), an_interval, t_id, an_exe_time, a_policy );
 
         // return the id
         return t_id;
     }
 
     template< typename executor, typename clock >
-    void scheduler< executor, clock >::schedule_repeating( executable_t an_executable, duration_t an_interval, int an_id, time_point_t a_rep_start )
+    void scheduler< executor, clock >::schedule_repeating( executable_t an_executable, duration_t an_interval, int an_id, time_point_t a_rep_start, missed_tick_policy a_policy )
     {
         LDEBUG( dlog_sh, "Scheduling a repeating event" );
 
-        // create the wrapper executable around the event
-        executable_t t_wrapped_executable = [this, an_executable, an_interval, an_id, a_rep_start](){ 
-            if( this->is_canceled() ) return;
-            LDEBUG( dlog_sh, "wrapped execution" );
-            // reschedule itself an_interval in the future
-            this->schedule_repeating( an_executable, an_interval, an_id, a_rep_start + an_interval );
-            // execute the event
-            LDEBUG( dlog_sh, "executing the wrapped executable" );
-            an_executable();
-        };
-
-        // create the event
+        // create the event; it's re-armed by run_due_events() each time it's executed
         event t_event;
-        t_event.f_executable = t_wrapped_executable;
+        t_event.f_executable = std::make_shared< const executable_t >( std::move(an_executable) );
         t_event.f_id = an_id;
+        t_event.f_interval = an_interval;
+        t_event.f_missed_tick_policy = a_policy;
 
-        // check if this'll be a new first event
-        bool t_new_first = false;
         std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
-        if( f_events.empty() || a_rep_start < f_events.begin()->first )
-        {
-            LDEBUG( dlog_sh, "New first event" );
-            t_new_first = true;
-        }
+        insert_event( a_rep_start, std::move(t_event) );
+        return;
+    }
 
-        // add the event to the map
-        f_events.insert( std::make_pair( a_rep_start, t_event ) );
-        if( t_new_first )
+    template< typename executor, typename clock >
+    void scheduler< executor, clock >::insert_event( time_point_t an_exe_time, event&& an_event )
+    {
+        if( f_events.insert( an_exe_time, std::move(an_event) ) )
         {
-            // wake the waiting thread
-            LDEBUG( dlog_sh, "That event was first; waking execution thread" );
-            f_cv.notify_one();
+            LDEBUG( dlog_sh, "That event was first" );
+            on_new_first_event();
         }
+        return;
+    }
 
+    template< typename executor, typename clock >
+    void scheduler< executor, clock >::on_new_first_event()
+    {
+        // wake the waiting thread
+        f_cv.notify_one();
         return;
     }
 
@@ -317,31 +575,35 @@ namespace dripline
     void scheduler< executor, clock >::unschedule( int an_id )
     {
         std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
-        auto i_event = f_events.begin();
-        for( ; i_event->second.f_id != an_id && i_event != f_events.end(); ++i_event ) {
-            LDEBUG( dlog_sh, "Looking for event with id <" << an_id << ">; found one with id <" << i_event->second.f_id << ">" );
-        }
-
-        if( i_event->second.f_id == an_id ) 
+        if( f_events.erase( an_id ) )
         {
-            LDEBUG( dlog_sh, "Found event with id <" << i_event->second.f_id << ">; erasing it now" );
-            f_events.erase( i_event );
             LDEBUG( dlog_sh, "Removed event <" << an_id << "> from the schedule" );
         }
         else
         {
             LDEBUG( dlog_sh, "No event with id <" << an_id << "> found" );
         }
-        
         return;
     }
 
+    template< typename executor, typename clock >
+    bool scheduler< executor, clock >::get_event_stats( int an_id, event_stats& a_stats )
+    {
+        std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
+        const event* t_event = f_events.find( an_id );
+        if( t_event == nullptr ) return false;
+        a_stats = t_event->f_stats;
+        return true;
+    }
+
     template< typename executor, typename clock >
     void scheduler< executor, clock >::execute()
     {
         LDEBUG( dlog_sh, "Starting scheduler" );
         while( ! is_canceled() )
         {
+            run_due_events();
+
             std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
             if( f_events.empty() )
             {
@@ -349,32 +611,96 @@ namespace dripline
                 f_cv.wait_for( t_lock, f_cycle_time );
                 continue;
             }
-            else
+
+            time_point_t t_earliest = f_events.next_time();
+            duration_t t_to_earliest = t_earliest - clock::now();
+            if( t_to_earliest < f_exe_buffer )
+            {
+                // an event became due in the meantime
+                continue;
+            }
+            if( t_to_earliest < f_cycle_time )
+            {
+                // wait until the earliest event
+                f_cv.wait_until( t_lock, t_earliest );
+                continue;
+            }
+            // wait for f_cycle_time
+            f_cv.wait_for( t_lock, f_cycle_time );
+        }
+        LDEBUG( dlog_sh, "Scheduler exiting" );
+        return;
+    }
+
+    template< typename executor, typename clock >
+    unsigned scheduler< executor, clock >::run_due_events()
+    {
+        unsigned t_n_executed = 0;
+        std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
+        while( ! is_canceled() && ! f_events.empty() && f_events.next_time() - clock::now() < f_exe_buffer )
+        {
+            // take the event out of the schedule; a repeating event goes back in at its next tick
+            time_point_t t_now = clock::now();
+            time_point_t t_tick = f_events.next_time();
+            // the event keeps its executable, so only the pointer is copied for a repeating event
+            executable_ptr_t t_executable;
+            event& t_next = f_events.next_event();
+            int t_id = t_next.f_id;
+            if( t_next.f_interval > duration_t::zero() )
             {
-                auto t_first_event = f_events.begin();
-                //time_point_t t_earliest = t_first_exe.first;
-                duration_t t_to_earliest = t_first_event->first - clock::now();
-                if( t_to_earliest < f_exe_buffer )
+                // ticks stay aligned to the first execution time, however late this one is
+                time_point_t t_next_tick = t_tick + t_next.f_interval;
+                bool t_execute = true;
+                if( t_next_tick <= t_now && t_next.f_missed_tick_policy != missed_tick_policy::catch_up )
                 {
-                    // do event now
-                    LDEBUG( dlog_sh, "Executing first event from the map" );
-                    std::unique_lock< std::mutex > t_exe_lock( f_executor_mutex );
-                    f_the_executor( t_first_event->second.f_executable );
-                    f_events.erase( t_first_event );
-                    continue;
+                    // the following ticks are already due; jump to the first tick that isn't
+                    auto t_n_late_ticks = ( t_now - t_tick ) / t_next.f_interval;
+                    t_next_tick = t_tick + ( t_n_late_ticks + 1 ) * t_next.f_interval;
+                    t_execute = t_next.f_missed_tick_policy == missed_tick_policy::coalesce;
+                    t_next.f_stats.f_n_missed += t_execute ? t_n_late_ticks : t_n_late_ticks + 1;
+                    LDEBUG( dlog_sh, "Event <" << t_id << "> missed " << t_n_late_ticks << " tick(s)" );
                 }
-                if( t_to_earliest < f_cycle_time )
+                if( t_execute )
                 {
-                    // wait until t_first_event->first
-                    f_cv.wait_until( t_lock, t_first_event->first );
-                    continue;
+                    t_executable = t_next.f_executable;
+                    duration_t t_lateness = t_now - t_tick;
+                    ++t_next.f_stats.f_n_executed;
+                    t_next.f_stats.f_last_lateness = t_lateness;
+                    t_next.f_stats.f_total_lateness += t_lateness;
+                    if( t_lateness > t_next.f_stats.f_max_lateness ) t_next.f_stats.f_max_lateness = t_lateness;
                 }
-                // wait for f_cycle_time
-                f_cv.wait_for( t_lock, f_cycle_time );
-                continue;
+                f_events.reschedule_next( t_next_tick );
+                if( ! t_execute ) continue;
             }
+            else
+            {
+                t_executable = std::move( f_events.pop_next().f_executable );
+            }
+
+            // do event now, without holding the scheduler lock; the executor lock is taken first, so that an event 
+            // is never out of the schedule without either the scheduler lock or the executor lock being held
+            std::unique_lock< std::mutex > t_exe_lock( f_executor_mutex );
+            t_lock.unlock();
+            LDEBUG( dlog_sh, "Executing first event from the schedule" );
+            dispatch( *t_executable, t_id );
+            t_exe_lock.unlock();
+            ++t_n_executed;
+            t_lock.lock();
+        }
+        return t_n_executed;
+    }
+
+    template< typename executor, typename clock >
+    void scheduler< executor, clock >::dispatch( const executable_t& an_executable, int an_id )
+    {
+        if constexpr( std::is_invocable_v< executor&, const executable_t&, int > )
+        {
+            f_the_executor( an_executable, an_id );
+        }
+        else
+        {
+            f_the_executor( an_executable );
         }
-        LDEBUG( dlog_sh, "Scheduler exiting" );
         return;
     }
 
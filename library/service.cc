@@ -9,13 +9,26 @@
 
 #include "service.hh"
 
+#include "admission_controller.hh"
+#include "dedup_cache.hh"
 #include "dripline_config.hh"
 #include "dripline_exceptions.hh"
+#include "get_cache.hh"
+#include "get_coalescer.hh"
+#include "request_stats.hh"
 #include "service_config.hh"
+#include "timer_service.hh"
+#include "worker_pool.hh"
 
 #include "authentication.hh"
 #include "logger.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <sstream>
+
 using scarab::authentication;
 using scarab::param_node;
 using scarab::param_value;
@@ -40,10 +53,24 @@ namespace dripline
             f_status( status::nothing ),
             f_restart_on_error( a_config.get_value( "restart_on_error", true ) ),
             f_enable_scheduling( a_config.get_value( "enable_scheduling", false ) ),
+            f_max_priority( a_config.get_value( "max_priority", 0U ) ),
+            f_pool_async_children( false ),
+            f_async_pool_threads( a_config.get_value( "async_pool_threads", 4U ) ),
+            f_async_reply_publishing( a_config.get_value( "async_reply_publishing", false ) ),
+            f_reply_batch_size( a_config.get_value( "reply_batch_size", 100U ) ),
+            f_setup_threads( a_config.get_value( "setup_threads", 16U ) ),
+            f_reply_publisher(),
             f_id( generate_random_uuid() ),
             f_sync_children(),
             f_async_children(),
-            f_broadcast_key( a_config.get_value( "broadcast_key", "broadcast" ) )
+            f_broadcast_key( a_config.get_value( "broadcast_key", "broadcast" ) ),
+            f_async_channel(),
+            f_async_pool(),
+            f_async_dispatcher_thread(),
+            f_host_channel(),
+            f_host_pool(),
+            f_scheduler_timer_id( -1 ),
+            f_scheduler_timer_active( false )
     {
         LDEBUG( dlog, "Service (cpp) created with config:\n" << a_config );
         // get more values from the config
@@ -52,8 +79,51 @@ namespace dripline
         heartbeater::f_check_timeout_ms = f_listen_timeout_ms;
         // default of f_single_message_wait_ms is in the receiver class
         f_single_message_wait_ms = a_config.get_value( "message_wait_ms", f_single_message_wait_ms );
+        // default of f_drain_timeout_ms is in the concurrent_receiver class
+        f_drain_timeout_ms = a_config.get_value( "drain_timeout_ms", f_drain_timeout_ms );
         // default of f_heartbeat_interval_s is in the heartbeater class
         f_heartbeat_interval_s = a_config.get_value( "heartbeat_interval_s", f_heartbeat_interval_s );
+        // the request statistics are shared by the service and its children
+        if( a_config.get_value( "heartbeat_stats", false ) )
+        {
+            f_include_stats = true;
+            f_request_stats = std::make_shared< request_stats >();
+        }
+        // default of f_local_delivery is in the core class (from the dripline_mesh config)
+        f_local_delivery = a_config.get_value( "local_delivery", f_local_delivery );
+        // default of f_n_decoders is in the concurrent_receiver class
+        f_n_decoders = a_config.get_value( "decode_threads", f_n_decoders );
+        // defaults of f_use_priority_lane and f_priority_threshold are in the concurrent_receiver class
+        f_use_priority_lane = a_config.get_value( "priority_lane", f_use_priority_lane );
+        f_priority_threshold = a_config.get_value( "priority_lane_threshold", f_priority_threshold );
+        // the deduplication cache is shared by the service and its children
+        unsigned t_dedup_window_ms = a_config.get_value( "dedup_window_ms", 0U );
+        if( t_dedup_window_ms > 0 )
+        {
+            f_dedup_cache = std::make_shared< dedup_cache >( t_dedup_window_ms, a_config.get_value( "dedup_max_entries", 1000U ) );
+        }
+        if( a_config.has( "get_cache" ) )
+        {
+            f_get_cache = std::make_shared< get_cache >( a_config["get_cache"].as_node() );
+        }
+        if( a_config.has( "admission" ) )
+        {
+            f_admission_controller = std::make_shared< admission_controller >( a_config["admission"].as_node() );
+        }
+        // the get coalescer is shared by the service and its children
+        if( a_config.get_value( "coalesce_gets", false ) )
+        {
+            f_get_coalescer = std::make_shared< get_coalescer >();
+        }
+        std::string t_async_mode = a_config.get_value( "async_children_mode", "threads" );
+        if( t_async_mode == "pool" )
+        {
+            f_pool_async_children = true;
+        }
+        else if( t_async_mode != "threads" )
+        {
+            throw dripline_error() << "Invalid async_children_mode: <" << t_async_mode << ">; options are <threads> and <pool>";
+        }
     }
 /*
     service::service( const bool a_make_connection, const scarab::param_node& a_config, const scarab::authentication& a_auth ) :
@@ -79,13 +149,23 @@ namespace dripline
         if( f_status >= status::listening )
         {
             this->cancel( dl_success().rc_value() );
-            std::this_thread::sleep_for( std::chrono::milliseconds(1100) );
+            // cancellation wakes the listeners, so this normally returns as soon as listen() has finished
+            if( ! wait_until_not_listening( f_listen_timeout_ms + f_drain_timeout_ms ) )
+            {
+                LWARN( dlog, "Service <" << f_name << "> is still listening while being destroyed" );
+            }
         }
         if( f_status > status::exchange_declared ) stop();
+        if( f_local_delivery ) remove_local_targets();
     }
 
     service& service::operator=( service&& a_orig )
     {
+        // the scheduler timers refer to their services, so both are stopped before anything is moved; 
+        // this service's timer is started again when it listens
+        stop_scheduler_timer();
+        a_orig.stop_scheduler_timer();
+
         cancelable::operator=( std::move(a_orig) );
         core::operator=( std::move(a_orig) );
         endpoint::operator=( std::move(a_orig));
@@ -96,10 +176,23 @@ namespace dripline
         f_status = std::move( a_orig.f_status );
         f_restart_on_error = a_orig.f_restart_on_error;
         f_enable_scheduling = a_orig.f_enable_scheduling;
+        f_max_priority = a_orig.f_max_priority;
+        f_pool_async_children = a_orig.f_pool_async_children;
+        f_async_pool_threads = a_orig.f_async_pool_threads;
+        f_async_reply_publishing = a_orig.f_async_reply_publishing;
+        f_reply_batch_size = a_orig.f_reply_batch_size;
+        f_setup_threads = a_orig.f_setup_threads;
+        // the publisher refers to the original service, so a new one is made when this service starts
+        f_reply_publisher.reset();
         f_id = std::move( a_orig.f_id );
         f_sync_children = std::move( a_orig.f_sync_children );
         f_async_children = std::move( a_orig.f_async_children );
         f_broadcast_key = std::move( a_orig.f_broadcast_key );
+        f_async_channel = std::move( a_orig.f_async_channel );
+        f_async_pool = std::move( a_orig.f_async_pool );
+        f_async_dispatcher_thread = std::move( a_orig.f_async_dispatcher_thread );
+        f_host_channel = std::move( a_orig.f_host_channel );
+        f_host_pool = std::move( a_orig.f_host_pool );
 
         return *this;
     }
@@ -110,6 +203,11 @@ namespace dripline
         if( t_inserted.second )
         {
             a_endpoint_ptr->set_service( this );
+            if( f_dedup_cache ) a_endpoint_ptr->set_dedup_cache( f_dedup_cache );
+            // each child gets its own get cache, since cached replies are keyed by specifier and invalidated by requests to that endpoint
+            if( f_get_cache ) a_endpoint_ptr->set_get_cache( f_get_cache->create_empty_copy() );
+            if( f_get_coalescer ) a_endpoint_ptr->set_get_coalescer( f_get_coalescer );
+            if( f_request_stats ) a_endpoint_ptr->set_request_stats( f_request_stats );
         }
         else
         {
@@ -130,6 +228,13 @@ namespace dripline
         if( t_inserted.second )
         {
             a_endpoint_ptr->set_service( this );
+            if( f_dedup_cache ) a_endpoint_ptr->set_dedup_cache( f_dedup_cache );
+            // each child gets its own get cache, since cached replies are keyed by specifier and invalidated by requests to that endpoint
+            if( f_get_cache ) a_endpoint_ptr->set_get_cache( f_get_cache->create_empty_copy() );
+            if( f_get_coalescer ) a_endpoint_ptr->set_get_coalescer( f_get_coalescer );
+            if( f_request_stats ) a_endpoint_ptr->set_request_stats( f_request_stats );
+            t_listener_receiver_ptr->set_use_priority_lane( f_use_priority_lane );
+            t_listener_receiver_ptr->set_priority_threshold( f_priority_threshold );
         }
         else
         {
@@ -191,11 +296,6 @@ namespace dripline
 
     bool service::start()
     {
-        if( ! f_make_connection )
-        {
-            LWARN( dlog, "Should not start service when make_connection is disabled" );
-            return true;
-        }
         if( f_name.empty() )
         {
             LERROR( dlog, "Service requires a queue name to be started" );
@@ -206,24 +306,69 @@ namespace dripline
         endpoint::f_service = this;
         heartbeater::f_service = this;
 
+        // in-process delivery doesn't need the broker
+        if( f_local_delivery ) add_local_targets();
+
+        if( ! f_make_connection )
+        {
+            LWARN( dlog, "Should not start service when make_connection is disabled" );
+            return true;
+        }
+
         LINFO( dlog, "Connecting to <" << f_address << ":" << f_port << ">" );
 
+        // the time taken by each phase is logged, since startup time grows with the number of children
+        typedef std::chrono::steady_clock phase_clock;
+        phase_clock::time_point t_start_time = phase_clock::now();
+        phase_clock::time_point t_phase_start = t_start_time;
+        std::stringstream t_phase_times;
+        auto t_end_phase = [&]( const std::string& a_phase ) {
+            phase_clock::time_point t_now = phase_clock::now();
+            t_phase_times << ( t_phase_times.tellp() > 0 ? ", " : "" ) << a_phase << ": " << std::chrono::duration_cast< std::chrono::milliseconds >( t_now - t_phase_start ).count() << " ms";
+            t_phase_start = t_now;
+        };
+
         if( ! open_channels() ) return false;
         f_status = status::channel_created;
+        t_end_phase( "channels" );
 
         if( ! setup_exchange( f_channel, f_requests_exchange ) ) return false;
         if( ! setup_exchange( f_channel, f_alerts_exchange ) ) return false;
         f_status = status::exchange_declared;
+        t_end_phase( "exchanges" );
 
-        if( ! setup_queues() ) return false;
+        if( f_async_reply_publishing )
+        {
+            LINFO( dlog, "Starting the reply publisher" );
+            if( ! f_reply_publisher ) f_reply_publisher = std::make_shared< reply_publisher >( *this, f_reply_batch_size );
+            if( ! f_reply_publisher->start() ) return false;
+            t_end_phase( "reply publisher" );
+        }
+
+        // the reply publisher has its own thread, so it's stopped if the rest of the startup fails
+        auto t_fail = [this]() {
+            if( f_async_reply_publishing && f_reply_publisher )
+            {
+                LINFO( dlog, "Stopping the reply publisher" );
+                f_reply_publisher->stop();
+            }
+            return false;
+        };
+
+        if( ! setup_queues() ) return t_fail();
         f_status = status::queue_declared;
+        t_end_phase( "queues" );
 
-        if( ! bind_keys() ) return false;
+        if( ! bind_keys() ) return t_fail();
         f_status = status::queue_bound;
+        t_end_phase( "bindings" );
 
-        if( ! start_consuming() ) return false;
+        if( ! start_consuming() ) return t_fail();
         f_status = status::consuming;
+        t_end_phase( "consuming" );
 
+        LINFO( dlog, "Service <" << f_name << "> started in " << std::chrono::duration_cast< std::chrono::milliseconds >( phase_clock::now() - t_start_time ).count() << 
+                " ms with " << f_async_children.size() << " async and " << f_sync_children.size() << " sync children (" << t_phase_times.str() << ")" );
         return true;
     }
 
@@ -234,25 +379,24 @@ namespace dripline
             LWARN( dlog, "Should not listen for messages when make_connection is disabled" );
             return true;
         }
+        if( f_host_pool )
+        {
+            LERROR( dlog, "Service <" << f_name << "> is hosted by a service container, which listens for its messages" );
+            return false;
+        }
 
         f_status = status::listening;
+        set_listening( true );
 
         try
         {
-            if( f_heartbeat_interval_s != 0 )
-            {
-                LINFO( dlog, "Starting heartbeat" );
-                f_heartbeat_thread = std::thread( &heartbeater::execute, this, f_name, f_id, f_heartbeat_routing_key );
-            }
-            else
-            {
-                LINFO( dlog, "Heartbeat disabled" );
-            }
+            // heartbeats and scheduled events are driven by the process's timer_service
+            start_heartbeat( f_name, f_id, f_heartbeat_routing_key );
 
             if( f_enable_scheduling )
             {
                 LINFO( dlog, "Starting scheduler" );
-                f_scheduler_thread = std::thread( &scheduler::execute, this );
+                start_scheduler_timer();
             }
             else
             {
@@ -262,6 +406,12 @@ namespace dripline
             LINFO( dlog, "Starting receiver thread" );
             f_receiver_thread = std::thread( &concurrent_receiver::execute, this );
 
+            if( f_n_decoders > 0 )
+            {
+                LINFO( dlog, "Starting " << f_n_decoders << " decoder thread(s)" );
+                start_decoders();
+            }
+
             // lambda to cancel everything on an error from listener::listen_on_queue()
             bool t_listen_error = false;
             auto t_cancel_on_listen_error = [&t_listen_error, this](listener& a_listener) {
@@ -274,54 +424,89 @@ namespace dripline
 
             if( ! f_async_children.empty() ) { LINFO( dlog, "Starting async children" ); }
             else { LDEBUG( dlog, "No async children to start" ); }
-            for( async_map_t::iterator t_child_it = f_async_children.begin();
-                    t_child_it != f_async_children.end();
-                    ++t_child_it )
+            if( f_pool_async_children && ! f_async_children.empty() )
             {
-                t_child_it->second->receiver_thread() = std::thread( &concurrent_receiver::execute, static_cast< listener_receiver* >(t_child_it->second.get()) );
-                t_child_it->second->listener_thread() = std::thread( t_cancel_on_listen_error, std::ref(*t_child_it->second.get()) );
+                LINFO( dlog, "Async children share a pool of " << f_async_pool_threads << " thread(s)" );
+                f_async_pool = std::make_shared< worker_pool >();
+                for( async_map_t::iterator t_child_it = f_async_children.begin();
+                        t_child_it != f_async_children.end();
+                        ++t_child_it )
+                {
+                    t_child_it->second->set_worker_pool( f_async_pool );
+                    t_child_it->second->strand() = t_child_it->first;
+                }
+                f_async_pool->start( f_async_pool_threads );
+                f_async_dispatcher_thread = std::thread( [&t_listen_error, this]() {
+                    if( ! this->listen_on_async_queues() )
+                    {
+                        t_listen_error = true;
+                        this->cancel( RETURN_ERROR );
+                    }
+                } );
+            }
+            else
+            {
+                for( async_map_t::iterator t_child_it = f_async_children.begin();
+                        t_child_it != f_async_children.end();
+                        ++t_child_it )
+                {
+                    t_child_it->second->receiver_thread() = std::thread( &concurrent_receiver::execute, static_cast< listener_receiver* >(t_child_it->second.get()) );
+                    t_child_it->second->listener_thread() = std::thread( t_cancel_on_listen_error, std::ref(*t_child_it->second.get()) );
+                }
             }
 
             LINFO( dlog, "Starting listener thread" );
             t_cancel_on_listen_error( *this );
 
-            for( async_map_t::iterator t_child_it = f_async_children.begin();
-                    t_child_it != f_async_children.end();
-                    ++t_child_it )
+            if( f_async_dispatcher_thread.joinable() )
+            {
+                f_async_dispatcher_thread.join();
+                // the children's handlers can finish requests that were already received
+                if( f_drain_timeout_ms > 0 && ! f_async_pool->drain( f_drain_timeout_ms ) )
+                {
+                    LWARN( dlog, "Drain timeout reached; requests still waiting for the async children will be dropped" );
+                }
+                f_async_pool->stop();
+            }
+            else
             {
-                t_child_it->second->listener_thread().join();
-                t_child_it->second->receiver_thread().join();
+                for( async_map_t::iterator t_child_it = f_async_children.begin();
+                        t_child_it != f_async_children.end();
+                        ++t_child_it )
+                {
+                    t_child_it->second->listener_thread().join();
+                    t_child_it->second->receiver_thread().join();
+                }
             }
 
             f_receiver_thread.join();
+            join_decoders();
 
-            if( f_heartbeat_thread.joinable() )
-            {
-                f_heartbeat_thread.join();
-            }
-            if( f_scheduler_thread.joinable() )
-            {
-                f_scheduler_thread.join();
-            }
+            stop_heartbeat();
+            stop_scheduler_timer();
 
             if( t_listen_error) throw dripline_error() << "Something went wrong while listening for messages";
         }
         catch( std::system_error& e )
         {
             LERROR( dlog, "Could not start the a thread due to a system error: " << e.what() );
+            set_listening( false );
             return false;
         }
         catch( dripline_error& e )
         {
             LERROR( dlog, "Dripline error while running service: " << e.what() );
+            set_listening( false );
             return false;
         }
         catch( std::exception& e )
         {
             LERROR( dlog, "Error while running service: " << e.what() );
+            set_listening( false );
             return false;
         }
 
+        set_listening( false );
         return true;
     }
 
@@ -329,11 +514,22 @@ namespace dripline
     {
         LINFO( dlog, "Stopping service on <" << f_name << ">" );
 
+        if( f_local_delivery ) remove_local_targets();
+
+        // in case listen() exited early
+        stop_heartbeat();
+        stop_scheduler_timer();
+
         if( f_status >= status::listening ) // listening or processing
         {
             this->cancel( dl_success().rc_value() );
             f_status = status::consuming;
         }
+        if( f_reply_publisher )
+        {
+            // publishes any replies that are still queued
+            f_reply_publisher->stop();
+        }
         if( f_status >= status::queue_bound ) // queue_bound or consuming
         {
             if( ! stop_consuming() ) return false;
@@ -350,77 +546,214 @@ namespace dripline
         return true;
     }
 
-    bool service::open_channels()
+    void service::add_local_targets()
     {
-        LDEBUG( dlog, "Opening channel for service <" << f_name << ">" );
-        f_channel = open_channel();
-        if( ! f_channel ) return false;
-
-        for( async_map_t::iterator t_child_it = f_async_children.begin();
-                t_child_it != f_async_children.end();
+        // requests are bound for the service's queue by its own name and by the names of its synchronous children
+        local_delivery* t_registry = local_delivery::get_instance();
+        t_registry->add_target( f_name, this );
+        for( sync_map_t::const_iterator t_child_it = f_sync_children.begin();
+                t_child_it != f_sync_children.end();
                 ++t_child_it )
         {
-            LDEBUG( dlog, "Opening channel for child <" << t_child_it->first << ">" );
-            t_child_it->second->channel() = open_channel();
-            t_child_it->second->set_listen_timeout_ms( f_listen_timeout_ms );
+            t_registry->add_target( t_child_it->first, this );
         }
-        return true;
-    }
-
-    bool service::setup_queues()
-    {
-        LDEBUG( dlog, "Setting up queue for service <" << f_name << ">" );
-        if( ! setup_queue( f_channel, f_name ) ) return false;
-
         for( async_map_t::iterator t_child_it = f_async_children.begin();
                 t_child_it != f_async_children.end();
                 ++t_child_it )
         {
-            LDEBUG( dlog, "Setting up queue for async child <" << t_child_it->first << ">" );
-            if( ! setup_queue( t_child_it->second->channel(), t_child_it->first ) ) return false;
+            t_registry->add_target( t_child_it->first, t_child_it->second.get() );
         }
-
-        return true;
+        LINFO( dlog, "Service <" << f_name << "> accepts requests from local clients" );
+        return;
     }
 
-    bool service::bind_keys()
+    void service::remove_local_targets()
     {
-        LDEBUG( dlog, "Binding primary service keys" );
-        if( ! bind_key( f_channel, f_requests_exchange, f_name, f_name + ".#" ) ) return false;
-        if( ! bind_key( f_channel, f_requests_exchange, f_name, f_broadcast_key + ".#" ) ) return false;
-
-        LDEBUG( dlog, "Binding keys for synchronous children" );
+        // only removes the targets that are registered to this service and its children
+        local_delivery* t_registry = local_delivery::get_instance();
+        t_registry->remove_target( f_name, this );
         for( sync_map_t::const_iterator t_child_it = f_sync_children.begin();
                 t_child_it != f_sync_children.end();
                 ++t_child_it )
         {
-            if( ! bind_key( f_channel, f_requests_exchange, f_name, t_child_it->first + ".#" ) ) return false;
+            t_registry->remove_target( t_child_it->first, this );
         }
-
-        LDEBUG( dlog, "Binding keys for asynchronous children" );
         for( async_map_t::iterator t_child_it = f_async_children.begin();
                 t_child_it != f_async_children.end();
                 ++t_child_it )
         {
-            if( ! bind_key( t_child_it->second->channel(), f_requests_exchange, t_child_it->first, t_child_it->first + ".#" ) ) return false;
+            t_registry->remove_target( t_child_it->first, t_child_it->second.get() );
         }
-
-        return true;
+        return;
     }
 
-    bool service::start_consuming()
+    void service::start_hosted()
     {
-        f_consumer_tag = core::start_consuming( f_channel, f_name );
-        if( f_consumer_tag.empty() ) return false;
+        f_status = status::listening;
+        set_listening( true );
 
+        start_heartbeat( f_name, f_id, f_heartbeat_routing_key );
+        if( f_enable_scheduling ) start_scheduler_timer();
+
+        // each queue gets its own strand, so its messages are handled one at a time and in order
+        set_worker_pool( f_host_pool );
+        f_strand = f_name;
         for( async_map_t::iterator t_child_it = f_async_children.begin();
                 t_child_it != f_async_children.end();
                 ++t_child_it )
         {
-            t_child_it->second->consumer_tag() = core::start_consuming( t_child_it->second->channel(), t_child_it->first );
-            if( t_child_it->second->consumer_tag().empty() ) return false;
+            t_child_it->second->set_worker_pool( f_host_pool );
+            t_child_it->second->strand() = t_child_it->first;
         }
-        return true;
+        return;
+    }
+
+    void service::stop_hosted()
+    {
+        stop_heartbeat();
+        stop_scheduler_timer();
+
+        f_status = status::consuming;
+        set_listening( false );
+        return;
+    }
+
+    bool service::run_setup_step( const std::function< bool () >& a_main_step, const std::function< bool ( async_map_t::value_type& ) >& a_child_step )
+    {
+        std::vector< async_map_t::value_type* > t_children;
+        t_children.reserve( f_async_children.size() );
+        for( auto& t_child : f_async_children ) t_children.push_back( &t_child );
+
+        // a hosted service's steps all use the host's channel, so they're run one at a time in this thread
+        if( f_host_channel )
+        {
+            bool t_success = a_main_step ? a_main_step() : true;
+            for( async_map_t::value_type* t_child : t_children )
+            {
+                if( ! a_child_step( *t_child ) ) t_success = false;
+            }
+            return t_success;
+        }
+
+        // children that share a channel are set up one at a time, in one thread
+        unsigned t_n_threads = 0;
+        if( ! t_children.empty() )
+        {
+            t_n_threads = f_pool_async_children ? 1 : std::min< unsigned >( std::max( f_setup_threads, 1U ), t_children.size() );
+        }
+
+        std::atomic< unsigned > t_next_child( 0 );
+        auto t_set_up_children = [&]() -> bool {
+            bool t_success = true;
+            for( unsigned i_child = t_next_child++; i_child < t_children.size(); i_child = t_next_child++ )
+            {
+                if( ! a_child_step( *t_children[i_child] ) ) t_success = false;
+            }
+            return t_success;
+        };
+
+        std::vector< std::future< bool > > t_child_results;
+        for( unsigned i_thread = 0; i_thread < t_n_threads; ++i_thread )
+        {
+            t_child_results.push_back( std::async( std::launch::async, t_set_up_children ) );
+        }
+
+        // the service's own channel is set up in this thread meanwhile
+        bool t_success = a_main_step ? a_main_step() : true;
+        for( std::future< bool >& t_result : t_child_results )
+        {
+            if( ! t_result.get() ) t_success = false;
+        }
+        return t_success;
+    }
+
+    bool service::open_channels()
+    {
+        return run_setup_step( 
+            [this]() -> bool {
+                if( f_host_channel )
+                {
+                    LDEBUG( dlog, "Using the host's channel for service <" << f_name << ">" );
+                    f_channel = f_host_channel;
+                    return true;
+                }
+                LDEBUG( dlog, "Opening channel for service <" << f_name << ">" );
+                f_channel = open_channel();
+                return bool(f_channel);
+            },
+            [this]( async_map_t::value_type& a_child ) -> bool {
+                if( f_pool_async_children )
+                {
+                    if( ! f_async_channel )
+                    {
+                        LDEBUG( dlog, "Opening shared channel for async children" );
+                        f_async_channel = f_host_channel ? f_host_channel : open_channel();
+                        if( ! f_async_channel ) return false;
+                    }
+                    a_child.second->channel() = f_async_channel;
+                }
+                else
+                {
+                    LDEBUG( dlog, "Opening channel for child <" << a_child.first << ">" );
+                    a_child.second->channel() = open_channel();
+                    if( ! a_child.second->channel() ) return false;
+                }
+                a_child.second->set_listen_timeout_ms( f_listen_timeout_ms );
+                a_child.second->set_drain_timeout_ms( f_drain_timeout_ms );
+                return true;
+            } );
+    }
+
+    bool service::setup_queues()
+    {
+        return run_setup_step( 
+            [this]() -> bool {
+                LDEBUG( dlog, "Setting up queue for service <" << f_name << ">" );
+                return setup_queue( f_channel, f_name, f_max_priority );
+            },
+            [this]( async_map_t::value_type& a_child ) -> bool {
+                LDEBUG( dlog, "Setting up queue for async child <" << a_child.first << ">" );
+                return setup_queue( a_child.second->channel(), a_child.first, f_max_priority );
+            } );
+    }
+
+    bool service::bind_keys()
+    {
+        return run_setup_step( 
+            [this]() -> bool {
+                // the service's queue gets one binding per key, even if the broadcast key matches a child's name
+                std::set< std::string > t_keys{ f_name + ".#", f_broadcast_key + ".#" };
+                for( sync_map_t::const_iterator t_child_it = f_sync_children.begin();
+                        t_child_it != f_sync_children.end();
+                        ++t_child_it )
+                {
+                    t_keys.insert( t_child_it->first + ".#" );
+                }
+
+                LDEBUG( dlog, "Binding " << t_keys.size() << " keys for the service and its synchronous children" );
+                for( const std::string& t_key : t_keys )
+                {
+                    if( ! bind_key( f_channel, f_requests_exchange, f_name, t_key ) ) return false;
+                }
+                return true;
+            },
+            [this]( async_map_t::value_type& a_child ) -> bool {
+                LDEBUG( dlog, "Binding key for asynchronous child <" << a_child.first << ">" );
+                return bind_key( a_child.second->channel(), f_requests_exchange, a_child.first, a_child.first + ".#" );
+            } );
+    }
+
+    bool service::start_consuming()
+    {
+        return run_setup_step( 
+            [this]() -> bool {
+                f_consumer_tag = core::start_consuming( f_channel, f_name );
+                return ! f_consumer_tag.empty();
+            },
+            []( async_map_t::value_type& a_child ) -> bool {
+                a_child.second->consumer_tag() = core::start_consuming( a_child.second->channel(), a_child.first );
+                return ! a_child.second->consumer_tag().empty();
+            } );
     }
 
     bool service::stop_consuming()
@@ -473,6 +806,12 @@ namespace dripline
                 continue;
             }
 
+            if( core::is_wake_token( t_envelope ) )
+            {
+                // left over from a cancellation that's been reset
+                continue;
+            }
+
             if( t_post_listen_status == core::post_listen_status::soft_error )
             {
                 LWARN( dlog, "A soft error ocurred while listening for messages for <" << f_name << ">.  The channel is still valid" );
@@ -508,6 +847,77 @@ namespace dripline
         return true;
     }
 
+    bool service::listen_on_async_queues()
+    {
+        // all of the children consume on the shared channel, so messages are matched to children by consumer tag
+        std::vector< std::string > t_consumer_tags;
+        std::map< std::string, lr_ptr_t > t_children_by_tag;
+        for( async_map_t::iterator t_child_it = f_async_children.begin();
+                t_child_it != f_async_children.end();
+                ++t_child_it )
+        {
+            t_consumer_tags.push_back( t_child_it->second->consumer_tag() );
+            t_children_by_tag[ t_child_it->second->consumer_tag() ] = t_child_it->second;
+        }
+
+        LINFO( dlog, "Listening for incoming messages for " << t_consumer_tags.size() << " async children" );
+
+        while( ! is_canceled()  )
+        {
+            amqp_envelope_ptr t_envelope;
+            core::post_listen_status t_post_listen_status = core::post_listen_status::unknown;
+            core::listen_for_message( t_envelope, t_post_listen_status, f_async_channel, t_consumer_tags, f_listen_timeout_ms );
+
+            if( f_canceled.load() )
+            {
+                LDEBUG( dlog, "Service canceled" );
+                return true;
+            }
+
+            if( t_post_listen_status == core::post_listen_status::timeout )
+            {
+                // we end up here every time the listen times out with no message received
+                continue;
+            }
+
+            if( core::is_wake_token( t_envelope ) )
+            {
+                // left over from a cancellation that's been reset
+                continue;
+            }
+
+            if( t_post_listen_status == core::post_listen_status::soft_error )
+            {
+                LWARN( dlog, "A soft error ocurred while listening for messages for the async children of <" << f_name << ">.  The channel is still valid" );
+                continue;
+            }
+
+            if( t_post_listen_status == core::post_listen_status::hard_error )
+            {
+                LERROR( dlog, "A hard error ocurred while listening for messages for the async children of <" << f_name << ">.  The channel is no longer valid" );
+                return false;
+            }
+
+            if( t_post_listen_status == core::post_listen_status::unknown )
+            {
+                LERROR( dlog, "An unknown status occurred while listening for messages for the async children of <" << f_name << ">" );
+                return false;
+            }
+
+            // remaining status is core::post_listen_status::message_received
+
+            auto t_child_it = t_children_by_tag.find( t_envelope->ConsumerTag() );
+            if( t_child_it == t_children_by_tag.end() )
+            {
+                LWARN( dlog, "Received a message with unknown consumer tag <" << t_envelope->ConsumerTag() << ">; it will be ignored" );
+                continue;
+            }
+
+            t_child_it->second->handle_message_chunk( t_envelope );
+        }
+        return true;
+    }
+
     void service::submit_message( message_ptr_t a_message )
     {
         try
@@ -555,8 +965,8 @@ namespace dripline
 
     reply_ptr_t service::on_request_message( request_ptr_t a_request )
     {
-        std::string t_first_token( a_request->routing_key() );
-        t_first_token = t_first_token.substr( 0, t_first_token.find_first_of('.') );
+        std::string_view t_first_token( a_request->routing_key() );
+        t_first_token = t_first_token.substr( 0, t_first_token.find_first_of( routing_key::f_node_separator ) );
         LDEBUG( dlog, "First token in routing key: <" << t_first_token << ">" );
 
         if( t_first_token == f_name || t_first_token == f_broadcast_key )
@@ -569,8 +979,11 @@ namespace dripline
             auto t_endpoint_itr = f_sync_children.find( t_first_token );
             if( t_endpoint_itr == f_sync_children.end() )
             {
-                LERROR( dlog, "Did not find child endpoint called <" << t_first_token << ">" );
-                throw dripline_error() << "Did not find child endpoint <" << t_first_token << ">";
+                // a misdirected request gets an error reply; it's not a reason to stop the service
+                LWARN( dlog, "Did not find child endpoint called <" << t_first_token << ">" );
+                reply_ptr_t t_reply = a_request->reply( dl_amqp_error_routingkey_notfound(), "Did not find child endpoint <" + std::string( t_first_token ) + ">" );
+                if( ! a_request->reply_to().empty() ) send_reply( t_reply );
+                return t_reply;
             }
 
             // reply will be sent by endpoint::on_request_message or derived
@@ -578,16 +991,97 @@ namespace dripline
         }
     }
 
+    void service::start_scheduler_timer()
+    {
+        std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
+        f_scheduler_timer_active = true;
+        arm_scheduler_timer();
+        return;
+    }
+
+    void service::stop_scheduler_timer()
+    {
+        std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
+        f_scheduler_timer_active = false;
+        int t_timer_id = f_scheduler_timer_id;
+        f_scheduler_timer_id = -1;
+        // the timer may be waiting for the scheduler mutex
+        t_lock.unlock();
+        if( t_timer_id >= 0 ) timer_service::get_instance()->cancel_timer( t_timer_id );
+        return;
+    }
+
+    void service::arm_scheduler_timer()
+    {
+        if( f_scheduler_timer_id >= 0 )
+        {
+            timer_service::get_instance()->unschedule( f_scheduler_timer_id );
+            f_scheduler_timer_id = -1;
+        }
+        if( ! f_scheduler_timer_active || f_events.empty() ) return;
+
+        // the service's events are on the system clock, and the timers are on the steady clock, so the delay is what's passed along
+        auto t_delay = std::chrono::duration_cast< timer_service::duration_t >( f_events.next_time() - scheduler<>::clock_t::now() );
+        f_scheduler_timer_id = timer_service::get_instance()->schedule_after( [this](){
+                run_due_events();
+                std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
+                arm_scheduler_timer();
+            }, t_delay );
+        return;
+    }
+
+    void service::on_new_first_event()
+    {
+        if( f_scheduler_timer_active ) arm_scheduler_timer();
+        else scheduler<>::on_new_first_event();
+        return;
+    }
+
+    void service::add_heartbeat_stats( scarab::param_node& a_stats )
+    {
+        heartbeater::add_heartbeat_stats( a_stats );
+
+        unsigned t_queue_depth = queue_depth();
+        unsigned t_pending_messages = n_incoming_messages();
+        for( async_map_t::iterator t_child_it = f_async_children.begin();
+                t_child_it != f_async_children.end();
+                ++t_child_it )
+        {
+            t_queue_depth += t_child_it->second->queue_depth();
+            t_pending_messages += t_child_it->second->n_incoming_messages();
+        }
+        a_stats.add( "queue_depth", t_queue_depth );
+        a_stats.add( "pending_messages", t_pending_messages );
+
+        if( f_request_stats )
+        {
+            // the rate and latencies are for the requests handled since the previous heartbeat
+            request_stats::snapshot t_snapshot = f_request_stats->take_snapshot();
+            a_stats.add( "requests", t_snapshot.f_n_total );
+            a_stats.add( "request_rate", t_snapshot.f_rate );
+            a_stats.add( "latency_p50_ms", t_snapshot.f_p50_ms );
+            a_stats.add( "latency_p99_ms", t_snapshot.f_p99_ms );
+        }
+        return;
+    }
+
     void service::do_cancellation( int a_code )
     {
         LDEBUG( dlog, "Canceling service <" << f_name << ">" );
+        std::vector< std::string > t_queue_names{ f_name };
         for( async_map_t::iterator t_child_it = f_async_children.begin();
                 t_child_it != f_async_children.end();
                 ++t_child_it )
         {
             LDEBUG( dlog, "Canceling child endpoint <" << t_child_it->first << ">" );
             t_child_it->second->cancel( a_code );
+            t_queue_names.push_back( t_child_it->first );
         }
+
+        // wake up the threads that are waiting, instead of leaving them until their next timeout
+        concurrent_receiver::do_cancellation( a_code );
+        heartbeater::do_cancellation( a_code );
+        if( f_status >= status::listening ) wake_queues( t_queue_names );
         return;
     }
 
@@ -13,15 +13,20 @@
 #include "heartbeater.hh"
 #include "scheduler.hh"
 #include "listener.hh"
+#include "local_delivery.hh"
 #include "receiver.hh"
+#include "reply_publisher.hh"
 
 #include "dripline_exceptions.hh"
 #include "service_config.hh"
 #include "uuid.hh"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace scarab
@@ -42,7 +47,7 @@ namespace dripline
 
      The lifetime of a service is defined by the three main functions:
        1. `start()` -- create the AMQP channel, create the AMQP queue, bind the routing keys, and start consuming AMQP messages
-       2. `listen()` -- starts the heartbeat and scheduler threads (optional), starts the receiver thread, and waits for and handles messages on the queue
+       2. `listen()` -- starts the heartbeat and scheduler timers (optional), starts the receiver thread, and waits for and handles messages on the queue
        3. `stop()` -- (called asynchronously) cancels the listening service
 
      The ability to handle and respond to Dripline messages is embodied in the `endpoint` class.  
@@ -54,6 +59,19 @@ namespace dripline
        3. Service has asynchronous child endpoints.  These endpoints each have their own AMQP 
           queue and thread responsible for receiving and handling their messages.
 
+     By default each asynchronous child has its own AMQP channel, listener thread, and receiver thread.  For a service with many 
+     asynchronous children, the children can instead share resources (config `async_children_mode: pool`): their queues are consumed 
+     on a single channel by one dispatcher thread (`listen_on_async_queues()`), and their messages are handled by a shared 
+     @ref worker_pool of `async_pool_threads` threads.  Each child has its own strand in the pool, so a child's messages are still 
+     handled one at a time and in order, while different children are handled concurrently.
+
+     With `local_delivery` enabled, a service registers itself and its children with @ref local_delivery when it starts, 
+     so that requests from clients in the same process (with `local_delivery` enabled) are handed to it directly instead of 
+     going through the broker; requests it sends to other local services are delivered the same way.
+
+     Many services can also be run in one process by a @ref service_container, which hosts them on one channel, one dispatcher 
+     thread, and one worker pool.  A hosted service is started and stopped by the container rather than run on its own.
+
      A service has a number of key characteristics (most of which come from its parent classes):
        * `core` -- Has all of the basic AMQP capabilities, sending messages, and making and manipulating connections
        * `endpoint` -- Handles Dripline messages
@@ -64,12 +82,16 @@ namespace dripline
      As is apparent from the above descriptions, a service is responsible for a number of threads 
      when it executes:
        * Listening -- grabs AMQP messages off the channel when they arrive
-       * Message-wait -- any incomplete multi-part Dripline message will setup a thread to wait 
-       *                 until the message is complete, and then submits it for handling
+       * Decoders (optional) -- convert complete sets of AMQP messages into Dripline messages, so that the listener only consumes from the broker
        * Receiver -- grabs completed Dripline messages and handles it
        * Async endpoint listening -- same as abovefor each asynchronous endpoint
-       * Async endpoint message-wait -- same as above for each asynchronous endpoint
        * Async endpoint receiver -- same as above for each asynchronous endpoint
+       * Async dispatcher and worker pool -- replace the async endpoint listening and receiver threads in `pool` mode
+
+     The timing is done by the process's @ref timer_service, which is shared by all of the services in the process (the timers 
+     themselves run on its worker threads):
+       * Message-wait -- any incomplete multi-part Dripline message (for the service or an async endpoint) sets a timer, 
+                         so that it's submitted for handling if the rest of the message doesn't arrive in time
        * Heatbeater -- sends regular heartbeat messages
        * Scheduler -- executes scheduled events
 
@@ -104,11 +126,28 @@ namespace dripline
                  - *Service parameters*
                    - `name` (string; default: dlcpp_service) -- Name of the service and the queue used by the service
                    - `restart_on_error` (bool; default: true) -- Flag for whether the service attempts to restart itself if an error occurs in communicating with the broker
-                   - `enable_scheduling` (bool; default: false) -- Flag for enabling the scheduler
+                   - `enable_scheduling` (bool; default: false) -- Flag for enabling the scheduler; scheduled events are executed by the process's @ref timer_service
                    - `broadcast_key` (string; default: broadcast) -- Routing key used for broadcasts
                    - `loop_timeout_ms` (int; default: 1000) -- Maximum time used for listening timeouts (e.g. waiting for replies) in ms
                    - `message_wait_ms` (int; default: 1000) -- Maximum time used to wait for another AMQP message before declaring a DL message complete, in ms
+                   - `drain_timeout_ms` (int; default: 0) -- Time allowed after the service is canceled for requests that were already received to be handled and answered, in ms; if 0, they're dropped
                    - `heartbeat_interval_s` (int; default: 60) -- Interval between sending heartbeat messages in s
+                   - `heartbeat_stats` (bool; default: false) -- Flag for including load statistics in the heartbeats (see `add_heartbeat_stats()`)
+                   - `decode_threads` (int; default: 0) -- Number of threads used to decode incoming messages; if 0, messages are decoded by the listener thread
+                   - `max_priority` (int; default: 0) -- Maximum request priority supported by the service's queues (up to 255); if 0, the queues are declared without priority support
+                   - `priority_lane` (bool; default: false) -- Flag for letting control requests and high-priority requests skip ahead of other requests waiting to be handled
+                   - `priority_lane_threshold` (int; default: 1) -- Minimum request priority for using the priority lane
+                   - `dedup_window_ms` (int; default: 0) -- Time for which replies to set and cmd requests are kept so that duplicate requests are not handled twice, in ms; if 0, duplicates are not recognized
+                   - `dedup_max_entries` (int; default: 1000) -- Maximum number of replies kept for recognizing duplicate requests
+                   - `get_cache` (node; default: not present) -- If present, get requests to the service and its children are cached, with a separate cache (and the same TTLs) for each; see @ref get_cache for the format
+                   - `admission` (node; default: not present) -- If present, limits the requests the service itself accepts; requests over the limits are rejected with `dl_service_error_overloaded` (see @ref admission_controller for the format)
+                   - `coalesce_gets` (bool; default: false) -- Flag for letting identical get requests to the service and its children share one call to the handler (see @ref get_coalescer)
+                   - `async_children_mode` (string; default: threads) -- How asynchronous children receive and handle messages: `threads` (each child has its own channel and threads) or `pool` (children share a channel, a dispatcher thread, and a worker pool)
+                   - `async_pool_threads` (int; default: 4) -- Number of threads in the worker pool used for asynchronous children in `pool` mode
+                   - `async_reply_publishing` (bool; default: false) -- Flag for handing replies to a @ref reply_publisher, which publishes them from its own thread and channel, instead of publishing them from the handler's thread
+                   - `reply_batch_size` (int; default: 100) -- Maximum number of queued replies the reply publisher takes at a time
+                   - `setup_threads` (int; default: 16) -- Maximum number of threads used to set up the asynchronous children concurrently when the service starts (opening their channels, declaring their queues, binding their keys, and starting to consume)
+                   - `local_delivery` (bool; default: false) -- Flag for accepting requests directly from clients in the same process, and sending requests to local services directly (see @ref local_delivery); can also be set in `dripline_mesh`
                  - *Dripline core parameters -- within the `dripline` config object*
                    - `dripline.broker` (string; default: localhost) -- Address of the RabbitMQ broker
                    - `dripline.broker_port` (int; default: 5672) -- Port used by the RabbitMQ broker
@@ -138,6 +177,17 @@ namespace dripline
             mv_accessible( status, status );
             mv_accessible( bool, restart_on_error );
             mv_accessible( bool, enable_scheduling );
+            mv_accessible( unsigned, max_priority );
+            /// Flag for running the asynchronous children on a shared channel and worker pool (`async_children_mode: pool`)
+            mv_accessible( bool, pool_async_children );
+            mv_accessible( unsigned, async_pool_threads );
+            /// Flag for publishing replies with a reply_publisher (`async_reply_publishing`)
+            mv_accessible( bool, async_reply_publishing );
+            mv_accessible( unsigned, reply_batch_size );
+            /// Maximum number of threads used to set up the asynchronous children's channels, queues, and bindings when the service starts
+            mv_accessible( unsigned, setup_threads );
+            /// Publisher used when async_reply_publishing is enabled; created when the service starts if one has not been set
+            mv_accessible( std::shared_ptr< reply_publisher >, reply_publisher );
 
         public:
             /// Add a synchronous child endpoint
@@ -151,6 +201,7 @@ namespace dripline
             virtual sent_msg_pkg_ptr send( request_ptr_t a_request, amqp_channel_ptr a_channel = amqp_channel_ptr() ) const;
 
             /// Sends a reply message
+            /// If the reply publisher is running and no channel is supplied, the reply is queued to be published by the reply publisher
             virtual sent_msg_pkg_ptr send( reply_ptr_t a_reply, amqp_channel_ptr a_channel = amqp_channel_ptr() ) const;
 
             /// Sends an alert message
@@ -200,13 +251,18 @@ namespace dripline
             /// Returns false if the return is due to an error in this function; returns true otherwise (namely because it was canceled)
             virtual bool listen_on_queue();
 
+            /// Waits for AMQP messages arriving for any of the asynchronous children on the shared channel (used in `pool` mode)
+            /// Returns false if the return is due to an error in this function; returns true otherwise (namely because it was canceled)
+            virtual bool listen_on_async_queues();
+
             /// Sends a reply message
             virtual void send_reply( reply_ptr_t a_reply ) const;
 
             mv_accessible( uuid_t, id );
 
         public:
-            typedef std::map< std::string, endpoint_ptr_t > sync_map_t;
+            /// The comparator allows lookup by `std::string_view`
+            typedef std::map< std::string, endpoint_ptr_t, std::less<> > sync_map_t;
             mv_referrable( sync_map_t, sync_children );
 
             typedef std::map< std::string, lr_ptr_t > async_map_t;
@@ -214,6 +270,66 @@ namespace dripline
 
             mv_referrable( std::string, broadcast_key );
 
+        protected:
+            /// Channel shared by the asynchronous children in `pool` mode
+            mv_referrable( amqp_channel_ptr, async_channel );
+            /// Worker pool that handles the asynchronous children's messages in `pool` mode
+            mv_referrable( std::shared_ptr< worker_pool >, async_pool );
+            mv_referrable( std::thread, async_dispatcher_thread );
+
+            /*!
+             Runs one step of setting up the service's AMQP topology: a_main_step (if given) for the service's own channel, 
+             and a_child_step for each asynchronous child.  When the children have their own channels, their steps run concurrently 
+             on up to `setup_threads` threads, alongside the main step; when they share a channel (`pool` mode), they run in order.
+             Returns false if any step returned false.
+            */
+            bool run_setup_step( const std::function< bool () >& a_main_step, const std::function< bool ( async_map_t::value_type& ) >& a_child_step );
+
+        protected:
+            friend class service_container;
+
+            /// Channel of the @ref service_container hosting the service, if there is one; the service and its asynchronous children use it instead of opening their own
+            amqp_channel_ptr f_host_channel;
+            /// Worker pool of the @ref service_container hosting the service, if there is one
+            std::shared_ptr< worker_pool > f_host_pool;
+
+            /// Starts the heartbeats and the scheduler, and hands the messages for the service and its asynchronous children to the host's worker pool; used instead of `listen()` when the service is hosted
+            void start_hosted();
+            /// Stops the heartbeats and the scheduler of a hosted service
+            void stop_hosted();
+
+        protected:
+            /// Registers the service and its children as local targets (when `local_delivery` is enabled)
+            void add_local_targets();
+            /// Removes the service and its children as local targets
+            void remove_local_targets();
+
+        protected:
+            /// Starts executing the scheduled events from the timer_service
+            void start_scheduler_timer();
+            /// Stops executing the scheduled events; if they're being executed, waits for them to finish
+            void stop_scheduler_timer();
+            /// Sets the timer for the next scheduled event; the scheduler mutex must be locked
+            void arm_scheduler_timer();
+            /// Moves the timer when an earlier event is scheduled
+            virtual void on_new_first_event();
+
+            /*!
+             Adds the service's load statistics to the heartbeat statistics (when `heartbeat_stats` is enabled):
+               - `threads`, `rss_kb` -- from @ref heartbeater
+               - `queue_depth` -- messages waiting to be decoded or handled by the service and its asynchronous children
+               - `pending_messages` -- multi-chunk messages waiting for the rest of their chunks
+               - `requests` -- total number of requests handled by the service and its children
+               - `request_rate` -- requests handled per second since the previous heartbeat
+               - `latency_p50_ms`, `latency_p99_ms` -- median and 99th-percentile time from receiving a request to its reply being ready, 
+                 since the previous heartbeat
+            */
+            virtual void add_heartbeat_stats( scarab::param_node& a_stats );
+
+            /// ID of the timer for the next scheduled event; negative if there isn't one
+            int f_scheduler_timer_id;
+            bool f_scheduler_timer_active;
+
         protected:
             /// Implementation of submit_message (from concurrent_receiver)
             virtual void submit_message( message_ptr_t a_message );
@@ -235,6 +351,13 @@ namespace dripline
     inline sent_msg_pkg_ptr service::send( reply_ptr_t a_reply, amqp_channel_ptr a_channel ) const
     {
         a_reply->sender_service_name() = f_name ;
+        // the reply publisher reports its own failures, so a queued reply counts as sent; replies to local requests don't need it
+        if( f_reply_publisher && ! a_channel && ! local_delivery::is_local_reply_key( a_reply->routing_key() ) && f_reply_publisher->submit( a_reply ) )
+        {
+            sent_msg_pkg_ptr t_queued = std::make_shared< sent_msg_pkg >();
+            t_queued->f_successful_send = true;
+            return t_queued;
+        }
         // we don't use f_channel on this core::send command because a channel can only be used in a single thread, 
         // and f_channel is primarily meant for listening with the listener thread.
         return core::send( a_reply, a_channel );
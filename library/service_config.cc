@@ -36,6 +36,7 @@ namespace dripline
         an_app.add_config_option< unsigned >( "--loop-timeout-ms" "loop_timeout_ms", "Set the timeout for thread loops in ms" );
         an_app.add_config_option< unsigned >( "--message-wait-ms" "message_wait_ms", "Set the time to wait for a full multi-part message in ms" );
         an_app.add_config_option< unsigned >( "--heartbeat-interval-s", "heartbeat_interval_s", "Set the interval between heartbeats in s" );
+        an_app.add_config_option< unsigned >( "--drain-timeout-ms", "drain_timeout_ms", "Set the time allowed for handling requests already received when shutting down, in ms" );
         return;
     }
 
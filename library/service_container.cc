@@ -0,0 +1,342 @@
+/*
+ * service_container.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "service_container.hh"
+
+#include "dripline_exceptions.hh"
+#include "return_codes.hh"
+#include "service.hh"
+
+#include "authentication.hh"
+#include "logger.hh"
+
+#include <algorithm>
+
+LOGGER( dlog, "service_container" );
+
+namespace dripline
+{
+
+    service_container::service_container( const scarab::param_node& a_config, const scarab::authentication& a_auth, const bool a_make_connection ) :
+            scarab::cancelable(),
+            core( a_config.has("dripline_mesh") ? a_config["dripline_mesh"].as_node() : dripline_config(),
+                  a_auth, a_make_connection ),
+            listener(),
+            f_status( status::nothing ),
+            f_pool_threads( a_config.get_value( "pool_threads", 4U ) ),
+            f_drain_timeout_ms( a_config.get_value( "drain_timeout_ms", 0U ) ),
+            f_async_reply_publishing( a_config.get_value( "async_reply_publishing", false ) ),
+            f_services(),
+            f_pool( std::make_shared< worker_pool >() ),
+            f_reply_publisher()
+    {
+        // default of f_listen_timeout_ms is in the listener class
+        f_listen_timeout_ms = a_config.get_value( "loop_timeout_ms", f_listen_timeout_ms );
+        if( f_async_reply_publishing )
+        {
+            f_reply_publisher = std::make_shared< reply_publisher >( *this, a_config.get_value( "reply_batch_size", 100U ) );
+        }
+    }
+
+    service_container::~service_container()
+    {
+        if( f_status >= status::listening )
+        {
+            this->cancel( dl_success().rc_value() );
+            // cancellation wakes the dispatcher, so this normally returns as soon as listen() has finished
+            if( ! wait_until_not_listening( f_listen_timeout_ms + f_drain_timeout_ms ) )
+            {
+                LWARN( dlog, "Service container is still listening while being destroyed" );
+            }
+        }
+        if( f_status > status::nothing ) stop();
+    }
+
+    bool service_container::add_service( service_ptr_t a_service )
+    {
+        if( f_status != status::nothing )
+        {
+            LERROR( dlog, "Service <" << a_service->name() << "> could not be added because the container has already started" );
+            return false;
+        }
+
+        auto t_inserted = f_services.insert( std::make_pair( a_service->name(), a_service ) );
+        if( ! t_inserted.second )
+        {
+            LERROR( dlog, "Service <" << a_service->name() << "> could not be added because a service with that name is already hosted" );
+            return false;
+        }
+
+        // the dispatcher thread does the decoding, and the children are handled in the shared pool
+        a_service->f_host_pool = f_pool;
+        a_service->set_pool_async_children( true );
+        a_service->set_n_decoders( 0 );
+        if( f_reply_publisher ) a_service->set_reply_publisher( f_reply_publisher );
+        return true;
+    }
+
+    void service_container::run()
+    {
+        LINFO( dlog, "Starting the service container" );
+        if( ! start() ) throw dripline_error() << "There was a problem while starting the service container (check for prior error messages)";
+
+        LINFO( dlog, "Service container started; now listening for messages" );
+        bool t_listened = listen();
+
+        LINFO( dlog, "Stopping the service container" );
+        if( ! stop() ) throw dripline_error() << "There was a problem while stopping the service container (check for prior error messages)";
+        if( ! t_listened ) throw dripline_error() << "There was a problem while listening for messages (check for prior error messages)";
+        return;
+    }
+
+    bool service_container::start()
+    {
+        if( ! f_make_connection )
+        {
+            LWARN( dlog, "Should not start the service container when make_connection is disabled" );
+            return true;
+        }
+        if( f_status != status::nothing )
+        {
+            LERROR( dlog, "Service container is not in the right status to start" );
+            return false;
+        }
+        if( f_services.empty() )
+        {
+            LERROR( dlog, "No services to host" );
+            return false;
+        }
+
+        LINFO( dlog, "Connecting to <" << f_address << ":" << f_port << ">" );
+        f_channel = open_channel();
+        if( ! f_channel ) return false;
+        f_status = status::started;
+
+        // a channel can only be used by one thread at a time, so the services are started one after another
+        for( service_map_t::iterator t_service_it = f_services.begin();
+                t_service_it != f_services.end();
+                ++t_service_it )
+        {
+            t_service_it->second->f_host_channel = f_channel;
+            if( ! t_service_it->second->start() )
+            {
+                LERROR( dlog, "Unable to start service <" << t_service_it->first << ">" );
+                return false;
+            }
+        }
+
+        if( f_reply_publisher && ! f_reply_publisher->start() ) return false;
+
+        LINFO( dlog, "Started " << f_services.size() << " service(s) on a shared channel" );
+        return true;
+    }
+
+    bool service_container::listen()
+    {
+        if( ! f_make_connection )
+        {
+            LWARN( dlog, "Should not listen for messages when make_connection is disabled" );
+            return true;
+        }
+        if( f_status != status::started )
+        {
+            LERROR( dlog, "Service container is not in the right status to listen" );
+            return false;
+        }
+
+        f_status = status::listening;
+        set_listening( true );
+
+        bool t_success = true;
+        try
+        {
+            LINFO( dlog, "Starting a pool of " << f_pool_threads << " thread(s) for " << f_services.size() << " service(s)" );
+            f_pool->start( std::max( f_pool_threads, 1U ) );
+            start_hosted_services();
+
+            t_success = listen_on_queue();
+        }
+        catch( std::exception& e )
+        {
+            LERROR( dlog, "Error while running the service container: " << e.what() );
+            t_success = false;
+        }
+
+        // the handlers can finish requests that were already received
+        if( f_drain_timeout_ms > 0 && ! f_pool->drain( f_drain_timeout_ms ) )
+        {
+            LWARN( dlog, "Drain timeout reached; requests still waiting to be handled will be dropped" );
+        }
+        f_pool->stop();
+        stop_hosted_services();
+
+        f_status = status::started;
+        set_listening( false );
+        return t_success;
+    }
+
+    bool service_container::stop()
+    {
+        LINFO( dlog, "Stopping the service container" );
+
+        if( f_status >= status::listening )
+        {
+            this->cancel( dl_success().rc_value() );
+            f_status = status::started;
+        }
+
+        // doesn't stop on failure; continues trying to stop the other services
+        bool t_success = true;
+        for( service_map_t::iterator t_service_it = f_services.begin();
+                t_service_it != f_services.end();
+                ++t_service_it )
+        {
+            if( ! t_service_it->second->stop() ) t_success = false;
+        }
+
+        if( f_reply_publisher )
+        {
+            // publishes any replies that are still queued
+            f_reply_publisher->stop();
+        }
+
+        f_channel.reset();
+        f_status = status::nothing;
+        return t_success;
+    }
+
+    service_container::receiver_map_t service_container::receivers_by_consumer_tag() const
+    {
+        receiver_map_t t_receivers;
+        for( service_map_t::const_iterator t_service_it = f_services.begin();
+                t_service_it != f_services.end();
+                ++t_service_it )
+        {
+            t_receivers[ t_service_it->second->consumer_tag() ] = t_service_it->second;
+
+            for( service::async_map_t::iterator t_child_it = t_service_it->second->async_children().begin();
+                    t_child_it != t_service_it->second->async_children().end();
+                    ++t_child_it )
+            {
+                t_receivers[ t_child_it->second->consumer_tag() ] = t_child_it->second;
+            }
+        }
+        return t_receivers;
+    }
+
+    bool service_container::route_message_chunk( const receiver_map_t& a_receivers, amqp_envelope_ptr a_envelope )
+    {
+        auto t_receiver_it = a_receivers.find( a_envelope->ConsumerTag() );
+        if( t_receiver_it == a_receivers.end() )
+        {
+            LWARN( dlog, "Received a message with unknown consumer tag <" << a_envelope->ConsumerTag() << ">; it will be ignored" );
+            return false;
+        }
+
+        t_receiver_it->second->handle_message_chunk( a_envelope );
+        return true;
+    }
+
+    void service_container::start_hosted_services()
+    {
+        for( service_map_t::iterator t_service_it = f_services.begin();
+                t_service_it != f_services.end();
+                ++t_service_it )
+        {
+            t_service_it->second->start_hosted();
+        }
+        return;
+    }
+
+    void service_container::stop_hosted_services()
+    {
+        for( service_map_t::iterator t_service_it = f_services.begin();
+                t_service_it != f_services.end();
+                ++t_service_it )
+        {
+            t_service_it->second->stop_hosted();
+        }
+        return;
+    }
+
+    bool service_container::listen_on_queue()
+    {
+        // all of the queues are consumed on the shared channel, so messages are matched to services and children by consumer tag
+        receiver_map_t t_receivers_by_tag = receivers_by_consumer_tag();
+        std::vector< std::string > t_consumer_tags;
+        for( receiver_map_t::const_iterator t_receiver_it = t_receivers_by_tag.begin();
+                t_receiver_it != t_receivers_by_tag.end();
+                ++t_receiver_it )
+        {
+            t_consumer_tags.push_back( t_receiver_it->first );
+        }
+
+        LINFO( dlog, "Listening for incoming messages on " << t_consumer_tags.size() << " queues for " << f_services.size() << " service(s)" );
+
+        while( ! is_canceled()  )
+        {
+            amqp_envelope_ptr t_envelope;
+            core::post_listen_status t_post_listen_status = core::post_listen_status::unknown;
+            core::listen_for_message( t_envelope, t_post_listen_status, f_channel, t_consumer_tags, f_listen_timeout_ms );
+
+            if( f_canceled.load() )
+            {
+                LDEBUG( dlog, "Service container canceled" );
+                return true;
+            }
+
+            if( t_post_listen_status == core::post_listen_status::timeout )
+            {
+                // we end up here every time the listen times out with no message received
+                continue;
+            }
+
+            if( core::is_wake_token( t_envelope ) )
+            {
+                // left over from a cancellation that's been reset
+                continue;
+            }
+
+            if( t_post_listen_status == core::post_listen_status::soft_error )
+            {
+                LWARN( dlog, "A soft error ocurred while listening for messages for the hosted services.  The channel is still valid" );
+                continue;
+            }
+
+            if( t_post_listen_status == core::post_listen_status::hard_error )
+            {
+                LERROR( dlog, "A hard error ocurred while listening for messages for the hosted services.  The channel is no longer valid" );
+                return false;
+            }
+
+            if( t_post_listen_status == core::post_listen_status::unknown )
+            {
+                LERROR( dlog, "An unknown status occurred while listening for messages for the hosted services" );
+                return false;
+            }
+
+            // remaining status is core::post_listen_status::message_received
+
+            route_message_chunk( t_receivers_by_tag, t_envelope );
+        }
+        return true;
+    }
+
+    void service_container::do_cancellation( int )
+    {
+        LDEBUG( dlog, "Canceling service container" );
+        // every queue is consumed on the shared channel, so one wake token wakes the dispatcher
+        if( f_status >= status::listening && ! f_services.empty() )
+        {
+            wake_queues( std::vector< std::string >{ f_services.begin()->first } );
+        }
+        return;
+    }
+
+} /* namespace dripline */
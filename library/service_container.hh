@@ -0,0 +1,141 @@
+/*
+ * service_container.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_SERVICE_CONTAINER_HH_
+#define DRIPLINE_SERVICE_CONTAINER_HH_
+
+#include "core.hh"
+#include "listener.hh"
+#include "reply_publisher.hh"
+#include "worker_pool.hh"
+
+#include "dripline_config.hh"
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace scarab
+{
+    class authentication;
+}
+
+namespace dripline
+{
+
+    /*!
+     @class service_container
+     @author N.S. Oblath
+
+     @brief Runs many services in one process, sharing a channel, a dispatcher thread, and a worker pool
+
+     @details
+     Each @ref service run on its own has its own channels, listener and receiver threads, and (optionally) reply publisher.
+     For a process that runs many small services, the container hosts them instead:
+       * All of the services' queues, and their asynchronous children's queues, are declared and consumed on one channel
+       * One dispatcher thread (`listen_on_queue()`) receives the messages on that channel and passes them to the right service or child
+       * The messages are handled by one @ref worker_pool of `pool_threads` threads, with one strand for each service and
+         each asynchronous child, so each one's requests are still handled one at a time and in order
+       * If `async_reply_publishing` is enabled, all of the replies are published by one @ref reply_publisher
+       * Heartbeats and scheduled events already use the process's @ref timer_service
+
+     Each service keeps its own queue, children, lockout, and heartbeats.  Asynchronous children are run as they are in
+     the service's `pool` mode (`async_children_mode: pool`), and decoding is done by the dispatcher thread (`decode_threads` is ignored).
+
+     Services are added with `add_service()` before the container starts; from then on they're started, listened for,
+     and stopped by the container, and shouldn't be run on their own.  The interface for running the container is the same
+     as for a service: `start()`, `listen()` (blocking), and `stop()`, or `run()` for all three.
+
+     Canceling the container wakes the dispatcher thread, which stops handing out messages.  Requests that were received
+     but not yet handled are dropped, unless `drain_timeout_ms` is set, in which case they're handled for up to that long.
+
+     Configuration options:
+       - `pool_threads` (int; default: 4) -- Number of threads in the worker pool that handles the services' messages
+       - `loop_timeout_ms` (int; default: 1000) -- Maximum time the dispatcher waits for a message before checking whether it's been canceled, in ms
+       - `drain_timeout_ms` (int; default: 0) -- Time allowed after the container is canceled for requests that were already received to be handled, in ms
+       - `async_reply_publishing` (bool; default: false) -- Flag for publishing all of the services' replies with one @ref reply_publisher
+       - `reply_batch_size` (int; default: 100) -- Maximum number of queued replies the reply publisher takes at a time
+       - `dripline_mesh` (node; default: see @ref dripline_config) -- Broker and exchange configuration; should match the hosted services
+    */
+    class DRIPLINE_API service_container :
+            public core,
+            public listener
+    {
+        protected:
+            enum class status
+            {
+                nothing = 0,
+                started = 10,
+                listening = 20
+            };
+
+        public:
+            service_container( const scarab::param_node& a_config = scarab::param_node(),
+                               const scarab::authentication& a_auth = create_auth_with_dripline(true),
+                               const bool a_make_connection = true );
+            service_container( const service_container& ) = delete;
+            service_container( service_container&& ) = delete;
+            virtual ~service_container();
+
+            service_container& operator=( const service_container& ) = delete;
+            service_container& operator=( service_container&& ) = delete;
+
+            /// Adds a service to be hosted; returns false if the container has already started or if a service with the same name is already hosted
+            bool add_service( service_ptr_t a_service );
+
+            mv_accessible( status, status );
+            mv_accessible( unsigned, pool_threads );
+            mv_accessible( unsigned, drain_timeout_ms );
+            mv_accessible( bool, async_reply_publishing );
+
+            typedef std::map< std::string, service_ptr_t > service_map_t;
+            mv_referrable_const( service_map_t, services );
+
+            /// Worker pool that handles the messages for all of the hosted services
+            mv_referrable_const( std::shared_ptr< worker_pool >, pool );
+            /// Publisher shared by the hosted services; only present if `async_reply_publishing` is enabled
+            mv_accessible( std::shared_ptr< reply_publisher >, reply_publisher );
+
+        public:
+            /// Starts, listens, and stops the container; throws a dripline_error if any of them fails
+            void run();
+
+            /// Opens the shared channel and starts each of the services on it
+            bool start();
+
+            /// Starts the worker pool, the services' heartbeats and scheduled events, and the dispatcher (blocking)
+            bool listen();
+
+            /// Stops each of the services and closes the shared channel
+            bool stop();
+
+            /// Waits for AMQP messages for any of the hosted services or their asynchronous children on the shared channel
+            /// Returns false if the return is due to an error in this function; returns true otherwise (namely because it was canceled)
+            virtual bool listen_on_queue();
+
+        protected:
+            typedef std::map< std::string, std::shared_ptr< receiver > > receiver_map_t;
+
+            /// Maps the consumer tags of the hosted services and their asynchronous children to their receivers
+            receiver_map_t receivers_by_consumer_tag() const;
+
+            /// Hands a message chunk to the receiver for its consumer tag; returns false if no receiver has that tag
+            bool route_message_chunk( const receiver_map_t& a_receivers, amqp_envelope_ptr a_envelope );
+
+            /// Starts the hosted services' heartbeats and scheduled events, and has their messages handled in the worker pool
+            void start_hosted_services();
+
+            /// Stops the hosted services' heartbeats and scheduled events
+            void stop_hosted_services();
+
+            /// Wakes the dispatcher thread
+            virtual void do_cancellation( int a_code );
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_SERVICE_CONTAINER_HH_ */
@@ -11,123 +11,171 @@
 
 #include "logger.hh"
 
+#include <stdexcept>
+
 LOGGER( dlog, "specifier" );
 
 namespace dripline
 {
 
-    routing_key::routing_key( const std::string& a_rk ) :
-            deque()
+    token_list::token_list( const std::string& a_string ) :
+            f_buffer( a_string ),
+            f_inline_spans(),
+            f_overflow_spans(),
+            f_n_tokens( 0 ),
+            f_first( 0 )
     {
-        if( ! a_rk.empty() ) add_next( a_rk );
+        tokenize();
     }
 
-    void routing_key::parse( const std::string& a_rk )
+    void token_list::push_back( std::string_view a_token )
     {
-        while( ! empty() ) pop_front();
-
-        add_next( a_rk );
+        if( f_n_tokens > 0 ) f_buffer += f_node_separator;
+        std::size_t t_begin = f_buffer.size();
+        f_buffer.append( a_token.data(), a_token.size() );
+        add_span( t_begin, a_token.size() );
         return;
     }
 
-    std::string routing_key::to_string() const
+    void token_list::push_front( std::string_view a_token )
     {
-        std::string t_return;
-        for( container_type::const_iterator t_it = this->begin(); t_it != this->end(); ++t_it )
-        {
-            if( t_it != this->begin() ) t_return += f_node_separator;
-            t_return += *t_it;
-        }
-        return t_return;
+        container_type t_tokens = to_container();
+        t_tokens.emplace_front( a_token );
+        assign( t_tokens );
+        return;
     }
 
-    void routing_key::add_next( const std::string& a_addr )
+    token_list::const_iterator token_list::erase( const_iterator a_position )
     {
-        size_t t_div_pos = a_addr.find( f_node_separator );
-        if( t_div_pos == a_addr.npos )
-        {
-            push_back( a_addr );
-            return;
-        }
-        push_back( a_addr.substr( 0, t_div_pos ) );
-        add_next( a_addr.substr( t_div_pos + 1 ) );
-        return;
+        if( a_position == end() ) return end();
+        const_iterator t_next( a_position );
+        return erase( a_position, ++t_next );
     }
 
+    token_list::const_iterator token_list::erase( const_iterator a_first, const_iterator a_last )
+    {
+        unsigned t_first = a_first.f_index - f_first;
+        unsigned t_last = a_last.f_index - f_first;
+        container_type t_tokens = to_container();
+        t_tokens.erase( t_tokens.begin() + t_first, t_tokens.begin() + t_last );
+        assign( t_tokens );
+        return const_iterator( this, f_first + t_first );
+    }
 
-    specifier::specifier( const std::string& a_unparsed ) :
-            container_type(),
-            f_unparsed( a_unparsed )
+    token_list::token token_list::at( unsigned a_index ) const
     {
-        LTRACE( dlog, "Creating specifier <" << a_unparsed << ">" );
-        if( ! a_unparsed.empty() ) add_next( a_unparsed );
+        if( a_index >= size() ) throw std::out_of_range( "Token index " + std::to_string(a_index) + " is out of range (size: " + std::to_string(size()) + ")" );
+        return (*this)[a_index];
     }
 
-    specifier::specifier( const specifier& a_orig ) :
-            container_type( a_orig ),
-            f_unparsed( a_orig.f_unparsed )
-    {}
+    token_list::container_type token_list::to_container() const
+    {
+        return container_type( begin(), end() );
+    }
 
-    specifier::specifier( specifier&& a_orig ) :
-            container_type( a_orig ),
-            f_unparsed( std::move( a_orig.f_unparsed ) )
-    {}
+    void token_list::assign( const container_type& a_tokens )
+    {
+        // the new buffer is built separately, since the tokens could be views into the current one
+        std::string t_buffer;
+        for( const std::string& t_token : a_tokens )
+        {
+            if( &t_token != &a_tokens.front() ) t_buffer += f_node_separator;
+            t_buffer += t_token;
+        }
+        clear();
+        f_buffer = std::move( t_buffer );
+        std::size_t t_begin = 0;
+        for( const std::string& t_token : a_tokens )
+        {
+            add_span( t_begin, t_token.size() );
+            t_begin += t_token.size() + 1;
+        }
+        return;
+    }
 
-    specifier::~specifier()
+    void token_list::clear()
     {
+        f_buffer.clear();
+        f_overflow_spans.clear();
+        f_n_tokens = 0;
+        f_first = 0;
+        return;
     }
 
-    const specifier& specifier::operator=( const specifier& a_orig )
+    std::string token_list::to_string() const
     {
-        container_type::operator=( a_orig );
-        f_unparsed = a_orig.f_unparsed;
-        return *this;
+        if( empty() ) return std::string();
+
+        // the remaining tokens are contiguous in the buffer
+        const span& t_first = f_first < n_inline_tokens ? f_inline_spans[f_first] : f_overflow_spans[f_first - n_inline_tokens];
+        if( t_first.f_begin > f_buffer.size() ) return std::string();
+        return f_buffer.substr( t_first.f_begin );
     }
 
-    const specifier& specifier::operator=( specifier&& a_orig )
+    bool token_list::operator==( const token_list& a_rhs ) const
     {
-        container_type::operator=( a_orig );
-        f_unparsed = std::move(a_orig.f_unparsed);
-        return *this;
+        if( size() != a_rhs.size() ) return false;
+        for( unsigned i_token = 0; i_token < size(); ++i_token )
+        {
+            if( (*this)[i_token] != a_rhs[i_token] ) return false;
+        }
+        return true;
     }
 
-    void specifier::parse( const std::string& a_unparsed )
+    void token_list::tokenize()
     {
-        LTRACE( dlog, "Parsing <" << a_unparsed << ">" );
+        f_overflow_spans.clear();
+        f_n_tokens = 0;
+        f_first = 0;
 
-        while( ! empty() ) pop_front();
+        if( f_buffer.empty() ) return;
+
+        std::size_t t_begin = 0;
+        std::size_t t_div_pos = f_buffer.find( f_node_separator );
+        while( t_div_pos != f_buffer.npos )
+        {
+            add_span( t_begin, t_div_pos - t_begin );
+            t_begin = t_div_pos + 1;
+            t_div_pos = f_buffer.find( f_node_separator, t_begin );
+        }
+        add_span( t_begin, f_buffer.size() - t_begin );
+        return;
+    }
 
-        f_unparsed = a_unparsed;
+    void token_list::add_span( std::size_t a_begin, std::size_t a_length )
+    {
+        span t_span{ uint32_t(a_begin), uint32_t(a_length) };
+        if( f_n_tokens < n_inline_tokens ) f_inline_spans[f_n_tokens] = t_span;
+        else f_overflow_spans.push_back( t_span );
+        ++f_n_tokens;
+        return;
+    }
 
-        if( a_unparsed.empty() ) return;
 
-        add_next( a_unparsed );
+    routing_key::routing_key( const std::string& a_rk ) :
+            token_list( a_rk )
+    {}
+
+    void routing_key::parse( const std::string& a_rk )
+    {
+        f_buffer = a_rk;
+        tokenize();
         return;
     }
 
-    std::string specifier::to_string() const
+
+    specifier::specifier( const std::string& a_unparsed ) :
+            token_list( a_unparsed )
     {
-        std::string t_return;
-        for( container_type::const_iterator t_it = this->begin(); t_it != this->end(); ++t_it )
-        {
-            if( t_it != this->begin() ) t_return += f_node_separator;
-            t_return += *t_it;
-        }
-        return t_return;
+        LTRACE( dlog, "Creating specifier <" << a_unparsed << ">" );
     }
 
-    void specifier::add_next( const std::string& a_addr )
+    void specifier::parse( const std::string& a_unparsed )
     {
-        size_t t_div_pos = a_addr.find( f_node_separator );
-        if( t_div_pos == a_addr.npos )
-        {
-            push_back( a_addr );
-            return;
-        }
-        push_back( a_addr.substr( 0, t_div_pos ) );
-        add_next( a_addr.substr( t_div_pos + 1 ) );
+        LTRACE( dlog, "Parsing <" << a_unparsed << ">" );
+        f_buffer = a_unparsed;
+        tokenize();
         return;
     }
 
-
 } /* namespace dripline */
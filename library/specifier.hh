@@ -10,25 +10,153 @@
 
 #include "dripline_api.hh"
 
-#include "member_variables.hh"
-
+#include <array>
+#include <cstdint>
 #include <deque>
+#include <iterator>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace dripline
 {
 
     /*!
-     @class routing_key
+     @class token_list
      @author N.S. Oblath
 
-     @brief Parses routing keys and stores the tokenized information
+     @brief Stores a string split into tokens at a separator
+
+     @details
+     The string is kept in a single owned buffer, and each token is stored as an offset and length within that buffer.
+     The offsets for the first `n_inline_tokens` tokens are stored inline, so splitting a string with that many tokens
+     or fewer does not allocate anything beyond the buffer itself.  `pop_front()` only moves the index of the first token.
+
+     Tokens are returned as @ref token objects, which are views into the buffer; they're valid until the token_list is
+     modified (e.g. with `parse()`, `push_back()`, or `erase()`), or destroyed.  A token converts implicitly to `std::string` when a copy is needed.
+
+     The interface follows that of the standard containers (`size()`, `front()`, `pop_front()`, iteration, etc.).
+     `push_front()`, `at()`, and `erase()` are kept from when this was a `std::deque< std::string >`; they rebuild the buffer, 
+     so they're slower than the other functions.  Iterators are read-only.
     */
-    class DRIPLINE_API routing_key : public std::deque< std::string >
+    class DRIPLINE_API token_list
     {
         public:
+            /// View of a single token; converts to `std::string`
+            struct token : public std::string_view
+            {
+                token() = default;
+                token( std::string_view a_view ) : std::string_view( a_view ) {}
+                operator std::string() const { return std::string( data(), size() ); }
+            };
+
+            class const_iterator
+            {
+                public:
+                    typedef std::forward_iterator_tag iterator_category;
+                    typedef token value_type;
+                    typedef std::ptrdiff_t difference_type;
+                    typedef const token* pointer;
+                    typedef token reference;
+
+                    const_iterator( const token_list* a_list, unsigned a_index ) : f_list( a_list ), f_index( a_index ) {}
+                    token operator*() const { return f_list->at_index( f_index ); }
+                    const_iterator& operator++() { ++f_index; return *this; }
+                    const_iterator operator++( int ) { const_iterator t_copy( *this ); ++f_index; return t_copy; }
+                    bool operator==( const const_iterator& a_rhs ) const { return f_index == a_rhs.f_index; }
+                    bool operator!=( const const_iterator& a_rhs ) const { return f_index != a_rhs.f_index; }
+
+                private:
+                    friend class token_list;
+                    const token_list* f_list;
+                    unsigned f_index;
+            };
+            typedef const_iterator iterator;
+            /// Container that the tokens can be copied into (see `to_container()`)
             typedef std::deque< std::string > container_type;
 
+            static const unsigned n_inline_tokens = 8;
+            static const char f_node_separator = '.';
+
+        public:
+            token_list( const std::string& a_string = "" );
+            token_list( const token_list& ) = default;
+            token_list( token_list&& ) = default;
+            virtual ~token_list() = default;
+
+            token_list& operator=( const token_list& ) = default;
+            token_list& operator=( token_list&& ) = default;
+
+            /// Number of tokens remaining
+            unsigned size() const;
+            bool empty() const;
+
+            /// First remaining token; returns an empty token if there are none
+            token front() const;
+            /// Last token; returns an empty token if there are none
+            token back() const;
+            /// Token at position a_index counted from the first remaining token; no bounds checking
+            token operator[]( unsigned a_index ) const;
+            /// Token at position a_index counted from the first remaining token; throws std::out_of_range if there's no such token
+            token at( unsigned a_index ) const;
+
+            /// Removes the first remaining token
+            void pop_front();
+            /// Adds a token to the end
+            void push_back( std::string_view a_token );
+            /// Adds a token to the beginning; tokens removed with `pop_front()` are discarded
+            void push_front( std::string_view a_token );
+            /// Removes the token at a_position; tokens removed with `pop_front()` are discarded.  Returns an iterator to the token after the one removed.
+            const_iterator erase( const_iterator a_position );
+            /// Removes the tokens in [a_first, a_last); tokens removed with `pop_front()` are discarded.  Returns an iterator to the token after the ones removed.
+            const_iterator erase( const_iterator a_first, const_iterator a_last );
+            /// Removes all tokens and clears the buffer
+            void clear();
+
+            const_iterator begin() const;
+            const_iterator end() const;
+
+            /// Joins the remaining tokens into a single string
+            std::string to_string() const;
+            /// Copies the remaining tokens into a container
+            container_type to_container() const;
+
+            bool operator==( const token_list& a_rhs ) const;
+            bool operator!=( const token_list& a_rhs ) const;
+
+        protected:
+            /// Splits the buffer into tokens
+            void tokenize();
+            /// Adds a token located in the buffer
+            void add_span( std::size_t a_begin, std::size_t a_length );
+
+            token at_index( unsigned a_index ) const;
+            /// Replaces the contents with a_tokens
+            void assign( const container_type& a_tokens );
+
+            struct span
+            {
+                uint32_t f_begin;
+                uint32_t f_length;
+            };
+
+            std::string f_buffer;
+            std::array< span, n_inline_tokens > f_inline_spans;
+            std::vector< span > f_overflow_spans;
+            /// Total number of tokens, including any that have been popped
+            unsigned f_n_tokens;
+            /// Index of the first remaining token
+            unsigned f_first;
+    };
+
+    /*!
+     @class routing_key
+     @author N.S. Oblath
+
+     @brief Parses routing keys and stores the tokenized information
+    */
+    class DRIPLINE_API routing_key : public token_list
+    {
         public:
             routing_key( const std::string& a_rk = "" );
             routing_key( const routing_key& ) = default;
@@ -38,17 +166,8 @@ namespace dripline
             routing_key& operator=( const routing_key& ) = default;
             routing_key& operator=( routing_key&& ) = default;
 
-            /// Parses a routing key
+            /// Parses a routing key; an empty routing key gives no tokens, as with the constructor
             void parse( const std::string& a_rk );
-            /// Converts the routing-key tokens into a single string
-            std::string to_string() const;
-
-        private:
-            void add_next( const std::string& a_addr );
-
-        public:
-            static const char f_node_separator = '.';
-
     };
 
     /*!
@@ -57,44 +176,97 @@ namespace dripline
 
      @brief Parses specifiers and stores the tokenized information
     */
-    class DRIPLINE_API specifier : public std::deque< std::string >
+    class DRIPLINE_API specifier : public token_list
     {
-        public:
-            typedef std::deque< std::string > container_type;
-
         public:
             specifier( const std::string& a_unparsed = "" );
-            specifier( const specifier& a_orig );
-            specifier( specifier&& a_orig );
-            virtual ~specifier();
+            specifier( const specifier& a_orig ) = default;
+            specifier( specifier&& a_orig ) = default;
+            virtual ~specifier() = default;
 
-            const specifier& operator=( const specifier& a_orig );
-            const specifier& operator=( specifier&& a_orig );
+            specifier& operator=( const specifier& a_orig ) = default;
+            specifier& operator=( specifier&& a_orig ) = default;
 
             /// Parse a new specifier
             void parse( const std::string& a_unparsed );
-            /// Parses the contents of `f_unparsed`.
+            /// Parses the contents of `unparsed()` again, which restores any tokens removed with `pop_front()`
             void reparse();
-            /// Converts specifier tokens into a single string
-            std::string to_string() const;
 
-            /// Unparsed specifier string; if modified, `reparse()` should be called.
-            mv_referrable( std::string, unparsed );
+            /// Unparsed specifier string.
+            /// Tokens added with `push_back()` are appended to the unparsed string.
+            const std::string& unparsed() const;
+            /// Replaces the unparsed specifier string and parses it (the same as `parse()`)
+            void set_unparsed( const std::string& a_unparsed );
+    };
 
-        private:
-            void add_next( const std::string& a_addr );
+    inline unsigned token_list::size() const
+    {
+        return f_n_tokens - f_first;
+    }
 
-        public:
-            static const char f_node_separator = '.';
+    inline bool token_list::empty() const
+    {
+        return f_first == f_n_tokens;
+    }
 
-    };
+    inline token_list::token token_list::front() const
+    {
+        return empty() ? token() : at_index( f_first );
+    }
+
+    inline token_list::token token_list::back() const
+    {
+        return empty() ? token() : at_index( f_n_tokens - 1 );
+    }
+
+    inline token_list::token token_list::operator[]( unsigned a_index ) const
+    {
+        return at_index( f_first + a_index );
+    }
+
+    inline void token_list::pop_front()
+    {
+        if( f_first < f_n_tokens ) ++f_first;
+        return;
+    }
+
+    inline token_list::const_iterator token_list::begin() const
+    {
+        return const_iterator( this, f_first );
+    }
+
+    inline token_list::const_iterator token_list::end() const
+    {
+        return const_iterator( this, f_n_tokens );
+    }
+
+    inline bool token_list::operator!=( const token_list& a_rhs ) const
+    {
+        return ! operator==( a_rhs );
+    }
+
+    inline token_list::token token_list::at_index( unsigned a_index ) const
+    {
+        const span& t_span = a_index < n_inline_tokens ? f_inline_spans[a_index] : f_overflow_spans[a_index - n_inline_tokens];
+        return token( std::string_view( f_buffer.data() + t_span.f_begin, t_span.f_length ) );
+    }
 
     inline void specifier::reparse()
     {
-        parse( f_unparsed );
+        tokenize();
         return;
     }
 
+    inline const std::string& specifier::unparsed() const
+    {
+        return f_buffer;
+    }
+
+    inline void specifier::set_unparsed( const std::string& a_unparsed )
+    {
+        parse( a_unparsed );
+        return;
+    }
 
 } /* namespace dripline */
 
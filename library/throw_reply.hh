@@ -30,6 +30,8 @@ namespace dripline
      The throw_reply is intended to be thrown during message processing. 
      It's caught in endpoint::on_request_message() to translate the information into a reply message.
 
+     Handlers that report errors often should consider returning a @ref reply_result instead, which avoids the cost of the exception.
+
      Three pieces of information can be transmitted:
         1. (required) The return code is provided by an object derived from return_code. 
           It's passed to the throw_reply in the constructor.
@@ -65,6 +67,8 @@ namespace dripline
             scarab::param& payload();
             void set_payload( scarab::param_ptr_t a_payload );
             const scarab::param_ptr_t& get_payload_ptr() const noexcept;
+            /// Moves the payload out of the throw_reply, leaving an empty param in its place
+            scarab::param_ptr_t take_payload();
 
 #ifdef DL_PYTHON
             mv_referrable_static( std::string, py_throw_reply_keyword );
@@ -140,6 +144,13 @@ namespace dripline
         return f_payload;
     }
 
+    inline scarab::param_ptr_t throw_reply::take_payload()
+    {
+        scarab::param_ptr_t t_payload( new scarab::param() );
+        f_payload.swap( t_payload );
+        return t_payload;
+    }
+
 }
 
 #endif /* DRIPLINE_THROW_REPLY_HH_ */
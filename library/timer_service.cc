@@ -0,0 +1,74 @@
+/*
+ * timer_service.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "timer_service.hh"
+
+#include "logger.hh"
+
+namespace dripline
+{
+    LOGGER( dlog, "timer_service" );
+
+    timer_service::timer_service() :
+            scarab::cancelable(),
+            scheduler< pool_executor, std::chrono::steady_clock >()
+    {
+        f_exe_buffer = std::chrono::milliseconds(1);
+        // the thread is woken when a new first timer is added or when it's canceled, so it doesn't need to cycle while it's idle
+        f_cycle_time = std::chrono::hours(1);
+
+        LDEBUG( dlog, "Starting the timer thread" );
+        f_scheduler_thread = std::thread( &timer_service::execute, this );
+    }
+
+    timer_service::~timer_service()
+    {
+        cancel();
+        if( f_scheduler_thread.joinable() ) f_scheduler_thread.join();
+        f_the_executor.stop();
+    }
+
+    int timer_service::schedule_after( executable_t an_executable, duration_t a_delay )
+    {
+        return schedule( std::move(an_executable), clock_t::now() + a_delay );
+    }
+
+    void timer_service::cancel_timer( int an_id )
+    {
+        unschedule( an_id );
+        wait_for_timer( an_id );
+        return;
+    }
+
+    void timer_service::wait_for_timer( int an_id )
+    {
+        if( in_timer() ) return;
+        // timers are handed to the executor while the executor mutex is locked, so once it's been locked, 
+        // a timer that has gone off is known to the executor
+        {
+            std::unique_lock< std::mutex > t_exe_lock( f_executor_mutex );
+        }
+        f_the_executor.wait_until_inactive( an_id );
+        return;
+    }
+
+    bool timer_service::in_timer() const
+    {
+        return f_the_executor.in_event();
+    }
+
+    void timer_service::do_cancellation( int )
+    {
+        LDEBUG( dlog, "Stopping the timer thread" );
+        std::unique_lock< std::recursive_mutex > t_lock( f_scheduler_mutex );
+        f_cv.notify_all();
+        return;
+    }
+
+} /* namespace dripline */
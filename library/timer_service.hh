@@ -0,0 +1,78 @@
+/*
+ * timer_service.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_TIMER_SERVICE_HH_
+#define DRIPLINE_TIMER_SERVICE_HH_
+
+#include "pool_executor.hh"
+#include "scheduler.hh"
+
+#include "singleton.hh"
+
+#include <chrono>
+#include <thread>
+
+namespace dripline
+{
+
+    /*!
+     @class timer_service
+     @author N.S. Oblath
+
+     @brief Process-wide timer thread, shared by everything that needs to do something at a particular time
+
+     @details
+     Heartbeats (@ref heartbeater), a service's scheduled events (@ref service), and the deadlines for reassembling
+     multi-chunk messages (@ref receiver) are all registered with this one timer, so a process has one timer thread
+     and one timer data structure (an @ref event_queue) no matter how many of those it has.  The thread sleeps until
+     the next timer is due, so it doesn't wake up when there's nothing to do.
+
+     The timer thread only keeps time: when a timer goes off, it's handed to a @ref pool_executor, and runs on one of
+     its worker threads (4 by default).  A timer that takes a while (e.g. sending a heartbeat) doesn't delay the timers
+     after it.  Runs of the same repeating timer never overlap.
+
+     The timer_service is a @ref scheduler on `std::chrono::steady_clock`, so timers are not affected by changes to
+     the system clock.  Timers are added and removed with the usual scheduler functions, plus `schedule_after()` for
+     one-off timers; the execution buffer is 1 ms.
+
+     `cancel_timer()` waits for a run of the timer that's in progress (or about to start), so once it returns, whatever the
+     timer refers to can be destroyed.  When it's called from a timer, it doesn't wait, since two timers canceling each
+     other would otherwise wait for each other.
+
+     The thread is started when the instance is first accessed with `get_instance()`, and is stopped when the
+     instance is destroyed at the end of the program.
+    */
+    class DRIPLINE_API timer_service :
+            public scarab::singleton< timer_service >,
+            public scheduler< pool_executor, std::chrono::steady_clock >
+    {
+        protected:
+            friend class scarab::singleton< timer_service >;
+            friend class scarab::destroyer< timer_service >;
+            timer_service();
+            virtual ~timer_service();
+
+        public:
+            /// Schedules a one-off timer to go off after a_delay; returns its ID
+            int schedule_after( executable_t an_executable, duration_t a_delay );
+
+            /// Unschedules a timer, and waits for it to finish if it's executing (unless this is called from a timer)
+            void cancel_timer( int an_id );
+
+            /// Waits for the runs of a timer that have gone off to finish; does nothing if called from a timer
+            void wait_for_timer( int an_id );
+
+            /// True if called from a timer
+            bool in_timer() const;
+
+        private:
+            virtual void do_cancellation( int a_code );
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_TIMER_SERVICE_HH_ */
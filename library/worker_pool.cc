@@ -0,0 +1,152 @@
+/*
+ * worker_pool.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#define DRIPLINE_API_EXPORTS
+
+#include "worker_pool.hh"
+
+#include "logger.hh"
+
+namespace dripline
+{
+    LOGGER( dlog, "worker_pool" );
+
+    worker_pool::worker_pool() :
+            f_mutex(),
+            f_condition(),
+            f_idle_condition(),
+            f_strands(),
+            f_ready(),
+            f_stopping( false ),
+            f_threads()
+    {}
+
+    worker_pool::~worker_pool()
+    {
+        stop();
+    }
+
+    void worker_pool::start( unsigned a_n_threads )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        f_stopping = false;
+        for( unsigned i_thread = 0; i_thread < a_n_threads; ++i_thread )
+        {
+            f_threads.emplace_back( &worker_pool::execute, this );
+        }
+        return;
+    }
+
+    void worker_pool::stop()
+    {
+        std::vector< std::thread > t_threads;
+        {
+            std::unique_lock< std::mutex > t_lock( f_mutex );
+            f_stopping = true;
+            t_threads.swap( f_threads );
+        }
+        f_condition.notify_all();
+
+        for( std::thread& t_thread : t_threads )
+        {
+            if( t_thread.joinable() ) t_thread.join();
+        }
+
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        if( ! f_ready.empty() )
+        {
+            LDEBUG( dlog, "Dropping " << f_ready.size() << " strand(s) with tasks that were not run" );
+        }
+        f_strands.clear();
+        f_ready.clear();
+        return;
+    }
+
+    bool worker_pool::drain( unsigned a_timeout_ms )
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        if( f_threads.empty() ) return f_strands.empty();
+        return f_idle_condition.wait_for( t_lock, std::chrono::milliseconds( a_timeout_ms ), [this](){ return f_strands.empty(); } );
+    }
+
+    void worker_pool::submit( const std::string& a_strand, task_t a_task, bool a_front )
+    {
+        {
+            std::unique_lock< std::mutex > t_lock( f_mutex );
+            strand& t_strand = f_strands[a_strand];
+            if( a_front ) t_strand.f_front_tasks.push_back( std::move(a_task) );
+            else t_strand.f_tasks.push_back( std::move(a_task) );
+
+            if( t_strand.f_scheduled ) return;
+            t_strand.f_scheduled = true;
+            f_ready.push_back( a_strand );
+        }
+        f_condition.notify_one();
+        return;
+    }
+
+    unsigned worker_pool::size() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        unsigned t_size = 0;
+        for( const auto& t_strand : f_strands )
+        {
+            t_size += t_strand.second.f_front_tasks.size() + t_strand.second.f_tasks.size();
+        }
+        return t_size;
+    }
+
+    unsigned worker_pool::n_threads() const
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        return f_threads.size();
+    }
+
+    void worker_pool::execute()
+    {
+        std::unique_lock< std::mutex > t_lock( f_mutex );
+        while( true )
+        {
+            f_condition.wait( t_lock, [this](){ return f_stopping || ! f_ready.empty(); } );
+            if( f_stopping ) return;
+
+            // take one task from the next strand; the strand stays scheduled so that no other thread runs its tasks meanwhile
+            std::string t_strand_name = std::move( f_ready.front() );
+            f_ready.pop_front();
+            strand& t_strand = f_strands[t_strand_name];
+            std::deque< task_t >& t_tasks = t_strand.f_front_tasks.empty() ? t_strand.f_tasks : t_strand.f_front_tasks;
+            task_t t_task = std::move( t_tasks.front() );
+            t_tasks.pop_front();
+
+            t_lock.unlock();
+            try
+            {
+                t_task();
+            }
+            catch( std::exception& e )
+            {
+                LERROR( dlog, "Exception escaped from a task in strand <" << t_strand_name << ">: " << e.what() );
+            }
+            t_lock.lock();
+
+            // the strand goes to the back of the line if it has more tasks
+            auto t_ran_strand_it = f_strands.find( t_strand_name );
+            if( t_ran_strand_it->second.f_front_tasks.empty() && t_ran_strand_it->second.f_tasks.empty() )
+            {
+                // an idle strand is the same as one that doesn't exist, so it's removed to keep short-lived strands from accumulating
+                f_strands.erase( t_ran_strand_it );
+                if( f_strands.empty() ) f_idle_condition.notify_all();
+            }
+            else
+            {
+                f_ready.push_back( t_strand_name );
+                f_condition.notify_one();
+            }
+        }
+    }
+
+} /* namespace dripline */
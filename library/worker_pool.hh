@@ -0,0 +1,99 @@
+/*
+ * worker_pool.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_WORKER_POOL_HH_
+#define DRIPLINE_WORKER_POOL_HH_
+
+#include "dripline_api.hh"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dripline
+{
+
+    /*!
+     @class worker_pool
+     @author N.S. Oblath
+
+     @brief A fixed set of threads that run tasks, with tasks in the same strand run one at a time in order
+
+     @details
+     Tasks are submitted with a strand name.  Tasks in the same strand are run in the order they were submitted 
+     (except that tasks submitted to the front of the strand run before the others, in the order they were submitted), 
+     and never at the same time.  Tasks in different strands 
+     can run at the same time on different threads.  Strands take turns, so a busy strand does not hold up the others 
+     for longer than one task at a time.
+
+     @ref service uses a worker_pool to run the handlers of its asynchronous children when `async_children_mode` is `pool`, 
+     with one strand per child.  That keeps each child's requests in order, as they are with a dedicated receiver 
+     thread, without needing a thread for each child.
+
+     Tasks should handle their own exceptions; an exception that escapes a task is logged and dropped.
+    */
+    class DRIPLINE_API worker_pool
+    {
+        public:
+            typedef std::function< void () > task_t;
+
+        public:
+            worker_pool();
+            worker_pool( const worker_pool& ) = delete;
+            worker_pool( worker_pool&& ) = delete;
+            virtual ~worker_pool();
+
+            worker_pool& operator=( const worker_pool& ) = delete;
+            worker_pool& operator=( worker_pool&& ) = delete;
+
+            /// Starts the worker threads
+            void start( unsigned a_n_threads );
+            /// Stops the worker threads after their current tasks; tasks that have not started are dropped
+            void stop();
+            /// Waits until all of the submitted tasks have run, for up to a_timeout_ms; returns true if they have
+            bool drain( unsigned a_timeout_ms );
+
+            /// Adds a task to the back of a strand; if a_front is true, it goes after the other front tasks but ahead of the rest
+            void submit( const std::string& a_strand, task_t a_task, bool a_front = false );
+
+            /// Number of tasks waiting to be run
+            unsigned size() const;
+
+            /// Number of worker threads
+            unsigned n_threads() const;
+
+        protected:
+            void execute();
+
+            struct strand
+            {
+                std::deque< task_t > f_tasks;
+                /// Tasks submitted to the front of the strand; these are run before f_tasks
+                std::deque< task_t > f_front_tasks;
+                /// true while the strand is waiting in the ready list or one of its tasks is running
+                bool f_scheduled = false;
+            };
+
+            mutable std::mutex f_mutex;
+            std::condition_variable f_condition;
+            /// Notified when the last strand becomes idle
+            std::condition_variable f_idle_condition;
+            std::map< std::string, strand > f_strands;
+            /// Strands with tasks ready to run, in turn order
+            std::deque< std::string > f_ready;
+            bool f_stopping;
+            std::vector< std::thread > f_threads;
+    };
+
+} /* namespace dripline */
+
+#endif /* DRIPLINE_WORKER_POOL_HH_ */
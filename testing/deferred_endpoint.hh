@@ -0,0 +1,48 @@
+/*
+ * deferred_endpoint.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_TESTING_DEFERRED_ENDPOINT_HH_
+#define DRIPLINE_TESTING_DEFERRED_ENDPOINT_HH_
+
+#include "endpoint.hh"
+#include "reply_future.hh"
+#include "return_codes.hh"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dripline_test
+{
+    // handles get requests asynchronously, and completes them when release() is called
+    class deferred_endpoint : public dripline::endpoint
+    {
+        public:
+            deferred_endpoint( const std::string& a_name = "deferred" ) : dripline::endpoint( a_name ), f_count( 0 ), f_promises() {}
+
+            virtual dripline::reply_future do_get_request_async( const dripline::request_ptr_t a_request )
+            {
+                ++f_count;
+                f_promises.emplace_back( a_request, dripline::reply_promise() );
+                return f_promises.back().second.get_future();
+            }
+
+            void release()
+            {
+                for( auto& t_pending : f_promises )
+                {
+                    t_pending.second.set_reply( t_pending.first->reply( dripline::dl_success(), "done" ) );
+                }
+                f_promises.clear();
+            }
+
+            unsigned f_count;
+            std::vector< std::pair< dripline::request_ptr_t, dripline::reply_promise > > f_promises;
+    };
+}
+
+#endif /* DRIPLINE_TESTING_DEFERRED_ENDPOINT_HH_ */
@@ -0,0 +1,31 @@
+/*
+ * scope_guard.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#ifndef DRIPLINE_TESTING_SCOPE_GUARD_HH_
+#define DRIPLINE_TESTING_SCOPE_GUARD_HH_
+
+#include <functional>
+
+namespace dripline_test
+{
+    // calls a function when it goes out of scope, including when a failed REQUIRE ends the test early;
+    // used to undo registrations with singletons (e.g. local_delivery) that would otherwise be left pointing to destroyed objects
+    class scope_guard
+    {
+        public:
+            scope_guard( std::function< void () > a_on_exit ) : f_on_exit( std::move(a_on_exit) ) {}
+            scope_guard( const scope_guard& ) = delete;
+            ~scope_guard() { if( f_on_exit ) f_on_exit(); }
+
+            scope_guard& operator=( const scope_guard& ) = delete;
+
+        private:
+            std::function< void () > f_on_exit;
+    };
+}
+
+#endif /* DRIPLINE_TESTING_SCOPE_GUARD_HH_ */
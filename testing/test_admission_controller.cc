@@ -0,0 +1,108 @@
+/*
+ * test_admission_controller.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "admission_controller.hh"
+#include "deferred_endpoint.hh"
+#include "endpoint.hh"
+
+#include "param.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+TEST_CASE( "admission_controller", "[endpoint]" )
+{
+    std::string t_reason;
+
+    SECTION( "concurrency" )
+    {
+        dripline::admission_controller t_controller( 2 );
+        {
+            dripline::admission_controller::permit t_first = t_controller.try_admit( t_reason );
+            dripline::admission_controller::permit t_second = t_controller.try_admit( t_reason );
+            REQUIRE( t_first );
+            REQUIRE( t_second );
+            REQUIRE( t_controller.in_flight() == 2 );
+
+            REQUIRE_FALSE( t_controller.try_admit( t_reason ) );
+            REQUIRE_FALSE( t_reason.empty() );
+            REQUIRE( t_controller.n_rejected() == 1 );
+
+            // moving a permit keeps its slot
+            dripline::admission_controller::permit t_moved( std::move(t_first) );
+            REQUIRE( t_controller.in_flight() == 2 );
+        }
+        REQUIRE( t_controller.in_flight() == 0 );
+        REQUIRE( t_controller.try_admit( t_reason ) );
+    }
+
+    SECTION( "rate" )
+    {
+        scarab::param_node t_config;
+        t_config.add( "rate_limit", 0.001 );
+        t_config.add( "burst", 2 );
+        dripline::admission_controller t_controller( t_config );
+        REQUIRE( t_controller.get_max_concurrent() == 0 );
+        REQUIRE( t_controller.get_burst() == 2. );
+
+        // the bucket starts full; at this rate it won't refill during the test
+        REQUIRE( t_controller.try_admit( t_reason ) );
+        REQUIRE( t_controller.try_admit( t_reason ) );
+        REQUIRE_FALSE( t_controller.try_admit( t_reason ) );
+        REQUIRE( t_controller.n_rejected() == 1 );
+    }
+
+    SECTION( "outlives_controller" )
+    {
+        // a permit can be released after its controller is gone
+        dripline::admission_controller::permit t_permit;
+        {
+            dripline::admission_controller t_controller( 1 );
+            t_permit = t_controller.try_admit( t_reason );
+            REQUIRE( t_permit );
+        }
+        t_permit = dripline::admission_controller::permit();
+        REQUIRE_FALSE( t_permit );
+    }
+}
+
+TEST_CASE( "admission_endpoint", "[endpoint]" )
+{
+    dripline_test::deferred_endpoint t_endpoint( "slow" );
+    auto t_controller = std::make_shared< dripline::admission_controller >( 1 );
+    t_endpoint.set_admission_controller( t_controller );
+
+    auto t_make_request = []( dripline::op_t a_op, const std::string& a_specifier ){
+        return dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), a_op, "slow", a_specifier, "" );
+    };
+
+    // the first request is admitted, and holds its permit until it's finished
+    REQUIRE_FALSE( t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "value" ) ) );
+    REQUIRE( t_controller->in_flight() == 1 );
+
+    // so the next one is turned away without reaching the handler
+    dripline::reply_ptr_t t_rejected = t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "value" ) );
+    REQUIRE( t_rejected );
+    REQUIRE( t_rejected->get_return_code() == dripline::dl_service_error_overloaded::s_value );
+    REQUIRE( t_endpoint.f_count == 1 );
+
+    // control requests are always admitted
+    dripline::reply_ptr_t t_ping = t_endpoint.submit_request_message( t_make_request( dripline::op_t::cmd, "ping" ) );
+    REQUIRE( t_ping );
+    REQUIRE( t_ping->get_return_code() == dripline::dl_success::s_value );
+
+    t_endpoint.release();
+    REQUIRE( t_controller->in_flight() == 0 );
+
+    REQUIRE_FALSE( t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "value" ) ) );
+    REQUIRE( t_endpoint.f_count == 2 );
+
+    // replacing the controller while a request is in progress leaves its permit valid
+    t_endpoint.set_admission_controller( std::make_shared< dripline::admission_controller >( 1 ) );
+    t_controller.reset();
+    t_endpoint.release();
+    REQUIRE( t_endpoint.get_admission_controller()->in_flight() == 0 );
+}
@@ -9,7 +9,10 @@
 #include "core.hh"
 #include "dripline_config.hh"
 #include "dripline_exceptions.hh"
+#include "local_delivery.hh"
+#include "receiver.hh"
 #include "return_codes.hh"
+#include "scope_guard.hh"
 
 #include "authentication.hh"
 #include "param_codec.hh"
@@ -18,6 +21,10 @@
 
 #include <boost/filesystem.hpp>
 
+#include <chrono>
+#include <future>
+#include <thread>
+
 
 TEST_CASE( "configuration", "[core]" )
 {
@@ -73,6 +80,167 @@ TEST_CASE( "send_offline", "[core]" )
     dripline::reply_ptr_t t_reply_ptr = dripline::msg_reply::create( dripline::dl_success(), "reply", param_ptr_t( new param() ), "routing.key" );
 
     REQUIRE_THROWS_AS( t_core.send( t_reply_ptr ), dripline::reply_ptr_t );
+
+    std::vector< dripline::request_ptr_t > t_requests{ t_request_ptr };
+    REQUIRE_THROWS_AS( t_core.send_requests( t_requests ), dripline::request_ptr_t );
+}
+
+TEST_CASE( "wait_for_many_unsent", "[core]" )
+{
+    // packages from requests that were not sent don't have channels, so there's nothing to wait for
+    std::vector< dripline::sent_msg_pkg_ptr > t_pkgs{ std::make_shared< dripline::sent_msg_pkg >(), std::make_shared< dripline::sent_msg_pkg >() };
+
+    dripline::receiver t_receiver;
+
+    unsigned t_index = 0;
+    REQUIRE_FALSE( t_receiver.wait_for_any( t_pkgs, t_index, 100 ) );
+    REQUIRE( t_index == t_pkgs.size() );
+
+    std::vector< dripline::reply_ptr_t > t_replies = t_receiver.wait_for_all( t_pkgs, 100 );
+    REQUIRE( t_replies.size() == t_pkgs.size() );
+    REQUIRE_FALSE( t_replies[0] );
+    REQUIRE_FALSE( t_replies[1] );
+
+    REQUIRE( t_receiver.gather_replies( t_pkgs[0], 100, 50 ).empty() );
+}
+
+namespace dripline_test
+{
+    // gives the test access to the reassembly of reply chunks
+    class chunk_receiver : public dripline::receiver
+    {
+        public:
+            using dripline::receiver::handle_reply_chunk;
+    };
+}
+
+TEST_CASE( "reply_reassembly", "[core]" )
+{
+    using scarab::param_ptr_t;
+
+    // the payload is too big for one chunk, so the reply is split
+    std::string t_payload_string( 300, 'a' );
+    dripline::request_ptr_t t_request_ptr = dripline::msg_request::create( param_ptr_t( new scarab::param() ), dripline::op_t::get, "routing.key", "", "" );
+    dripline::reply_ptr_t t_reply_ptr = t_request_ptr->reply( dripline::dl_success(), "chunked", param_ptr_t( new scarab::param_value( t_payload_string ) ) );
+    dripline::amqp_split_message_ptrs t_chunks = t_reply_ptr->create_amqp_messages( 100 );
+    REQUIRE( t_chunks.size() > 2 );
+
+    auto t_envelope = [&]( unsigned a_chunk ){
+        return AmqpClient::Envelope::Create( t_chunks[a_chunk], "", 0, "", false, "reply.key", 1 );
+    };
+
+    dripline_test::chunk_receiver t_receiver;
+    dripline::reply_ptr_t t_reassembled;
+
+    // the chunks can arrive in any order, and duplicates are ignored
+    REQUIRE_FALSE( t_receiver.handle_reply_chunk( t_envelope( t_chunks.size() - 1 ), t_reassembled ) );
+    REQUIRE( t_receiver.n_incoming_messages() == 1 );
+    REQUIRE_FALSE( t_receiver.handle_reply_chunk( t_envelope( t_chunks.size() - 1 ), t_reassembled ) );
+    for( unsigned i_chunk = 0; i_chunk < t_chunks.size() - 2; ++i_chunk )
+    {
+        REQUIRE_FALSE( t_receiver.handle_reply_chunk( t_envelope( i_chunk ), t_reassembled ) );
+    }
+    REQUIRE_FALSE( t_reassembled );
+
+    // the last chunk completes the reply
+    REQUIRE( t_receiver.handle_reply_chunk( t_envelope( t_chunks.size() - 2 ), t_reassembled ) );
+    REQUIRE( t_reassembled );
+    REQUIRE( t_receiver.n_incoming_messages() == 0 );
+    REQUIRE( t_reassembled->get_return_code() == dripline::dl_success::s_value );
+    REQUIRE( t_reassembled->return_message() == "chunked" );
+    REQUIRE( t_reassembled->correlation_id() == t_request_ptr->correlation_id() );
+    REQUIRE( t_reassembled->payload().as_value().as_string() == t_payload_string );
+}
+
+namespace dripline_test
+{
+    // queues the requests it's given, and does nothing with them
+    class idle_receiver : public dripline::concurrent_receiver
+    {
+        protected:
+            virtual void submit_message( dripline::message_ptr_t ) {}
+    };
+}
+
+TEST_CASE( "gather_replies", "[core]" )
+{
+    using scarab::param_ptr_t;
+    typedef std::chrono::steady_clock clock_t;
+
+    // requests delivered in-process are answered without a broker, so the replies can be sent by hand
+    dripline::local_delivery* t_registry = dripline::local_delivery::get_instance();
+    dripline_test::idle_receiver t_target;
+    REQUIRE( t_registry->add_target( "gather_target", &t_target ) );
+    dripline_test::scope_guard t_remove_target( [&](){ t_registry->remove_target( "gather_target", &t_target ); } );
+
+    dripline::request_ptr_t t_request_ptr = dripline::msg_request::create( param_ptr_t( new scarab::param() ), dripline::op_t::cmd, "gather_target", "", "" );
+    dripline::sent_msg_pkg_ptr t_sent_pkg = t_registry->deliver_request( t_request_ptr );
+    REQUIRE( t_sent_pkg );
+    REQUIRE( t_target.message_queue().size() == 1 );
+
+    // the target is given a copy of the request, which has the reply-to key
+    dripline::message_ptr_t t_delivered;
+    REQUIRE( t_target.message_queue().try_pop( t_delivered ) );
+    dripline::request_ptr_t t_delivered_ptr = std::static_pointer_cast< dripline::msg_request >( t_delivered );
+
+    // Catch2 assertions can't be made from other threads, so this only reports whether the reply was delivered
+    auto t_send_reply = [&]( const std::string& a_sender ) -> bool {
+        dripline::reply_ptr_t t_reply_ptr = t_delivered_ptr->reply( dripline::dl_success(), "" );
+        t_reply_ptr->sender_service_name() = a_sender;
+        return t_registry->deliver_reply( t_reply_ptr );
+    };
+
+    dripline::receiver t_receiver;
+
+    SECTION( "expected" )
+    {
+        REQUIRE( t_send_reply( "service_a" ) );
+        REQUIRE( t_send_reply( "service_b" ) );
+        REQUIRE( t_send_reply( "service_c" ) );
+
+        // stops as soon as the expected number of replies is in, well before the timeout or the quiet period
+        clock_t::time_point t_start = clock_t::now();
+        auto t_replies = t_receiver.gather_replies( t_sent_pkg, 5000, 5000, 2 );
+        REQUIRE( clock_t::now() - t_start < std::chrono::seconds(1) );
+        REQUIRE( t_replies.size() == 2 );
+        REQUIRE( t_replies.count( "service_a" ) == 1 );
+        REQUIRE( t_replies.count( "service_b" ) == 1 );
+    }
+
+    SECTION( "quiet_period" )
+    {
+        // a reply that arrives during the quiet period restarts it
+        auto t_sender = std::async( std::launch::async, [&]() -> bool {
+            bool t_all_delivered = t_send_reply( "service_a" );
+            std::this_thread::sleep_for( std::chrono::milliseconds(100) );
+            t_all_delivered = t_send_reply( "service_b" ) && t_all_delivered;
+            // a second reply from the same service replaces the first
+            t_all_delivered = t_send_reply( "service_b" ) && t_all_delivered;
+            return t_all_delivered;
+        } );
+
+        clock_t::time_point t_start = clock_t::now();
+        auto t_replies = t_receiver.gather_replies( t_sent_pkg, 5000, 300 );
+        clock_t::duration t_elapsed = clock_t::now() - t_start;
+        REQUIRE( t_sender.get() );
+        REQUIRE( t_replies.size() == 2 );
+        REQUIRE( t_replies.count( "service_a" ) == 1 );
+        REQUIRE( t_replies.count( "service_b" ) == 1 );
+        // it ends one quiet period after the last reply
+        REQUIRE( t_elapsed >= std::chrono::milliseconds(400) );
+        REQUIRE( t_elapsed < std::chrono::seconds(4) );
+    }
+
+    SECTION( "timeout" )
+    {
+        // the overall timeout ends the wait even though the quiet period is longer
+        clock_t::time_point t_start = clock_t::now();
+        auto t_replies = t_receiver.gather_replies( t_sent_pkg, 200, 5000 );
+        clock_t::duration t_elapsed = clock_t::now() - t_start;
+        REQUIRE( t_replies.empty() );
+        REQUIRE( t_elapsed >= std::chrono::milliseconds(200) );
+        REQUIRE( t_elapsed < std::chrono::seconds(4) );
+    }
 }
 
 TEST_CASE( "config_retcode", "[core]" )
@@ -0,0 +1,105 @@
+/*
+ * test_dedup_cache.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "dedup_cache.hh"
+#include "endpoint.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace dripline_test
+{
+    // counts the cmd requests it handles
+    class counting_endpoint : public dripline::endpoint
+    {
+        public:
+            counting_endpoint() : dripline::endpoint( "counter" ), f_count( 0 ) {}
+
+            virtual dripline::reply_ptr_t do_cmd_request( const dripline::request_ptr_t a_request )
+            {
+                ++f_count;
+                return a_request->reply( dripline::dl_success(), "counted" );
+            }
+
+            unsigned f_count;
+    };
+}
+
+TEST_CASE( "dedup_cache", "[endpoint]" )
+{
+    dripline::dedup_cache t_cache( 100, 2 );
+
+    dripline::request_ptr_t t_request_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::cmd, "routing.key", "", "" );
+    dripline::reply_ptr_t t_reply_ptr = t_request_ptr->reply( dripline::dl_success(), "stored" );
+
+    REQUIRE_FALSE( t_cache.find( "id1" ) );
+
+    t_cache.store( "id1", t_reply_ptr );
+    REQUIRE( t_cache.find( "id1" ) == t_reply_ptr );
+    REQUIRE( t_cache.size() == 1 );
+
+    SECTION( "size limit" )
+    {
+        t_cache.store( "id2", t_reply_ptr );
+        t_cache.store( "id3", t_reply_ptr );
+        REQUIRE( t_cache.size() == 2 );
+        // the oldest entry is removed first
+        REQUIRE_FALSE( t_cache.find( "id1" ) );
+        REQUIRE( t_cache.find( "id3" ) );
+    }
+
+    SECTION( "time window" )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds(150) );
+        REQUIRE_FALSE( t_cache.find( "id1" ) );
+    }
+
+    SECTION( "stored again" )
+    {
+        // an expired entry that's stored again is as new as any other entry
+        std::this_thread::sleep_for( std::chrono::milliseconds(60) );
+        t_cache.store( "id2", t_reply_ptr );
+        std::this_thread::sleep_for( std::chrono::milliseconds(60) );
+        REQUIRE_FALSE( t_cache.find( "id1" ) );
+        t_cache.store( "id1", t_reply_ptr );
+        t_cache.store( "id3", t_reply_ptr );
+        REQUIRE( t_cache.size() == 2 );
+        REQUIRE_FALSE( t_cache.find( "id2" ) );
+        REQUIRE( t_cache.find( "id1" ) );
+        REQUIRE( t_cache.find( "id3" ) );
+    }
+}
+
+TEST_CASE( "dedup_endpoint", "[endpoint]" )
+{
+    dripline_test::counting_endpoint t_endpoint;
+    t_endpoint.set_dedup_cache( std::make_shared< dripline::dedup_cache >() );
+
+    auto t_make_request = [](){ return dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::cmd, "counter", "", "" ); };
+
+    dripline::request_ptr_t t_request_ptr = t_make_request();
+    t_request_ptr->message_id() = "first";
+    dripline::reply_ptr_t t_reply_ptr = t_endpoint.submit_request_message( t_request_ptr );
+    REQUIRE( t_endpoint.f_count == 1 );
+
+    // a redelivered request is not handled again, but gets the same reply
+    dripline::request_ptr_t t_duplicate_ptr = t_make_request();
+    t_duplicate_ptr->message_id() = "first";
+    dripline::reply_ptr_t t_dup_reply_ptr = t_endpoint.submit_request_message( t_duplicate_ptr );
+    REQUIRE( t_endpoint.f_count == 1 );
+    REQUIRE( t_dup_reply_ptr->get_return_code() == t_reply_ptr->get_return_code() );
+    REQUIRE( t_dup_reply_ptr->return_message() == t_reply_ptr->return_message() );
+    REQUIRE( t_dup_reply_ptr->correlation_id() == t_duplicate_ptr->correlation_id() );
+
+    // a different request is handled
+    dripline::request_ptr_t t_other_ptr = t_make_request();
+    t_other_ptr->message_id() = "second";
+    t_endpoint.submit_request_message( t_other_ptr );
+    REQUIRE( t_endpoint.f_count == 2 );
+}
@@ -0,0 +1,49 @@
+/*
+ * test_dispatch_table.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "dispatch_table.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <string_view>
+
+TEST_CASE( "dispatch_table", "[service]" )
+{
+    dripline::dispatch_table< int > t_table;
+    REQUIRE( t_table.empty() );
+    REQUIRE( t_table.find( "anything" ) == nullptr );
+
+    REQUIRE( t_table.insert_or_assign( "value", 1 ) );
+    REQUIRE( t_table.insert_or_assign( "calibrate", 2 ) );
+    REQUIRE( t_table.insert_or_assign( "status", 3 ) );
+    REQUIRE( t_table.size() == 3 );
+
+    // entries are kept in key order
+    REQUIRE( t_table.begin()->first == "calibrate" );
+
+    // lookup by a view into a larger string
+    std::string t_specifier( "status.detail" );
+    std::string_view t_token = std::string_view( t_specifier ).substr( 0, 6 );
+    REQUIRE( t_table.find( t_token ) != nullptr );
+    REQUIRE( *t_table.find( t_token ) == 3 );
+
+    REQUIRE( t_table.find( "stat" ) == nullptr );
+    REQUIRE( t_table.find( "" ) == nullptr );
+
+    // replacing a value doesn't add an entry
+    REQUIRE_FALSE( t_table.insert_or_assign( "value", 10 ) );
+    REQUIRE( t_table.size() == 3 );
+    REQUIRE( *t_table.find( "value" ) == 10 );
+
+    REQUIRE( t_table.erase( "calibrate" ) );
+    REQUIRE_FALSE( t_table.erase( "calibrate" ) );
+    REQUIRE( t_table.find( "calibrate" ) == nullptr );
+    REQUIRE( t_table.size() == 2 );
+
+    t_table.clear();
+    REQUIRE( t_table.empty() );
+}
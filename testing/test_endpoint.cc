@@ -8,6 +8,8 @@
 #include "dripline_exceptions.hh"
 #include "endpoint.hh"
 
+#include "param_node.hh"
+
 #include "catch2/catch_test_macros.hpp"
 
 TEST_CASE( "submit_msg", "[endpoint]" )
@@ -35,3 +37,50 @@ TEST_CASE( "submit_msg", "[endpoint]" )
 
 
 
+
+TEST_CASE( "expired_request", "[endpoint]" )
+{
+    dripline::endpoint t_endpoint( "test_endpoint" );
+
+    auto t_make_ping = [](){ return dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::cmd, "routing.key", "ping", "" ); };
+
+    // no deadline: the request is handled
+    dripline::request_ptr_t t_request_ptr = t_make_ping();
+    dripline::reply_ptr_t t_reply_ptr = t_endpoint.submit_request_message( t_request_ptr );
+    REQUIRE( t_reply_ptr->get_return_code() == dripline::dl_success::s_value );
+    REQUIRE( t_endpoint.get_expired_request_count() == 0 );
+
+    // a deadline in the past: the request is dropped
+    t_request_ptr = t_make_ping();
+    t_request_ptr->set_deadline_ms( 1 );
+    REQUIRE( t_request_ptr->is_expired() );
+    t_reply_ptr = t_endpoint.submit_request_message( t_request_ptr );
+    REQUIRE( t_reply_ptr->get_return_code() == dripline::dl_service_error_timeout::s_value );
+    REQUIRE( t_endpoint.get_expired_request_count() == 1 );
+
+    // a TTL converted to a deadline in the future: the request is handled
+    t_request_ptr = t_make_ping();
+    t_request_ptr->set_ttl_ms( 60000 );
+    t_request_ptr->stamp_deadline();
+    REQUIRE( t_request_ptr->get_deadline_ms() > 0 );
+    REQUIRE_FALSE( t_request_ptr->is_expired() );
+    t_reply_ptr = t_endpoint.submit_request_message( t_request_ptr );
+    REQUIRE( t_reply_ptr->get_return_code() == dripline::dl_success::s_value );
+    REQUIRE( t_endpoint.get_expired_request_count() == 1 );
+}
+
+TEST_CASE( "invalid_request", "[endpoint]" )
+{
+    dripline::endpoint t_endpoint( "test_endpoint" );
+
+    // a request that couldn't be decoded carries the decoding error in its payload, which is passed back in the reply
+    scarab::param_ptr_t t_payload( new scarab::param_node() );
+    t_payload->as_node().add( "error", "unexpected end of input" );
+    dripline::request_ptr_t t_request_ptr = dripline::msg_request::create( std::move(t_payload), dripline::op_t::get, "routing.key", "specifier", "" );
+    t_request_ptr->set_is_valid( false );
+
+    dripline::reply_ptr_t t_reply_ptr = t_endpoint.submit_request_message( t_request_ptr );
+    REQUIRE( t_reply_ptr );
+    REQUIRE( t_reply_ptr->get_return_code() == dripline::dl_service_error_decoding_fail::s_value );
+    REQUIRE( t_reply_ptr->return_message() == "Request message was not valid; unexpected end of input" );
+}
@@ -0,0 +1,167 @@
+/*
+ * test_get_cache.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "endpoint.hh"
+#include "get_cache.hh"
+#include "reply_future.hh"
+
+#include "param.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace dripline_test
+{
+    // counts the get requests that reach the "hardware"
+    class counting_get_endpoint : public dripline::endpoint
+    {
+        public:
+            counting_get_endpoint() : dripline::endpoint( "reader" ), f_count( 0 ) {}
+
+            virtual dripline::reply_ptr_t do_get_request( const dripline::request_ptr_t a_request )
+            {
+                ++f_count;
+                return a_request->reply( dripline::dl_success(), "read " + std::to_string(f_count) );
+            }
+
+            virtual dripline::reply_ptr_t do_set_request( const dripline::request_ptr_t a_request )
+            {
+                return a_request->reply( dripline::dl_success(), "set" );
+            }
+
+            virtual dripline::reply_ptr_t do_cmd_request( const dripline::request_ptr_t a_request )
+            {
+                return a_request->reply( dripline::dl_success(), "done" );
+            }
+
+            unsigned f_count;
+    };
+
+    // its set requests are completed later, by the test
+    class slow_set_endpoint : public counting_get_endpoint
+    {
+        public:
+            virtual dripline::reply_future do_set_request_async( const dripline::request_ptr_t a_request )
+            {
+                f_set_request = a_request;
+                return f_set_promise.get_future();
+            }
+
+            dripline::request_ptr_t f_set_request;
+            dripline::reply_promise f_set_promise;
+    };
+}
+
+TEST_CASE( "get_cache_config", "[endpoint]" )
+{
+    scarab::param_node t_ttls;
+    t_ttls.add( "fast", 10 );
+    scarab::param_node t_config;
+    t_config.add( "default_ttl_ms", 500 );
+    t_config.add( "ttl_ms", t_ttls );
+
+    dripline::get_cache t_cache( t_config );
+    REQUIRE( t_cache.get_default_ttl_ms() == 500 );
+    REQUIRE( t_cache.get_ttl_ms( "fast" ) == 10 );
+    REQUIRE( t_cache.get_ttl_ms( "other" ) == 500 );
+
+    // a copy for another endpoint has the same TTLs but none of the stored replies
+    dripline::request_ptr_t t_request = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "reader", "other", "" );
+    t_cache.store( "other", t_request->reply( dripline::dl_success(), "stored" ) );
+    REQUIRE( t_cache.find( "other" ) );
+    std::shared_ptr< dripline::get_cache > t_copy = t_cache.create_empty_copy();
+    REQUIRE( t_copy->get_default_ttl_ms() == 500 );
+    REQUIRE( t_copy->get_ttl_ms( "fast" ) == 10 );
+    REQUIRE_FALSE( t_copy->find( "other" ) );
+}
+
+TEST_CASE( "get_cache", "[endpoint]" )
+{
+    dripline_test::counting_get_endpoint t_endpoint;
+    std::shared_ptr< dripline::get_cache > t_cache = std::make_shared< dripline::get_cache >( 60000 );
+    t_cache->set_ttl_ms( "uncached", 0 );
+    t_cache->set_ttl_ms( "short", 50 );
+    t_endpoint.set_get_cache( t_cache );
+
+    auto t_make_request = []( dripline::op_t a_op, const std::string& a_specifier ){ return dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), a_op, "reader", a_specifier, "" ); };
+
+    dripline::reply_ptr_t t_reply = t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "value" ) );
+    REQUIRE( t_endpoint.f_count == 1 );
+
+    // served from the cache
+    dripline::reply_ptr_t t_cached_reply = t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "value" ) );
+    REQUIRE( t_endpoint.f_count == 1 );
+    REQUIRE( t_cached_reply->return_message() == t_reply->return_message() );
+
+    SECTION( "ttl" )
+    {
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "uncached" ) );
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "uncached" ) );
+        REQUIRE( t_endpoint.f_count == 3 );
+
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "short" ) );
+        REQUIRE( t_endpoint.f_count == 4 );
+        std::this_thread::sleep_for( std::chrono::milliseconds(100) );
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "short" ) );
+        REQUIRE( t_endpoint.f_count == 5 );
+    }
+
+    SECTION( "invalidation" )
+    {
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::set, "value" ) );
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "value" ) );
+        REQUIRE( t_endpoint.f_count == 2 );
+
+        // control requests don't change what's read
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::cmd, "ping" ) );
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "value" ) );
+        REQUIRE( t_endpoint.f_count == 2 );
+
+        // other cmds might
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::cmd, "reset" ) );
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::get, "value" ) );
+        REQUIRE( t_endpoint.f_count == 3 );
+    }
+}
+
+TEST_CASE( "get_cache_generation", "[endpoint]" )
+{
+    dripline::get_cache t_cache( 60000 );
+    dripline::request_ptr_t t_request = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "reader", "value", "" );
+    dripline::reply_ptr_t t_reply = t_request->reply( dripline::dl_success(), "read" );
+
+    // a reply read before an invalidation isn't stored
+    uint64_t t_generation = t_cache.generation();
+    t_cache.invalidate();
+    REQUIRE( t_cache.generation() != t_generation );
+    t_cache.store( "value", t_reply, t_generation );
+    REQUIRE_FALSE( t_cache.find( "value" ) );
+
+    t_cache.store( "value", t_reply, t_cache.generation() );
+    REQUIRE( t_cache.find( "value" ) );
+}
+
+TEST_CASE( "get_cache_slow_set", "[endpoint]" )
+{
+    dripline_test::slow_set_endpoint t_endpoint;
+    t_endpoint.set_get_cache( std::make_shared< dripline::get_cache >( 60000 ) );
+
+    auto t_make_request = []( dripline::op_t a_op ){ return dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), a_op, "reader", "value", "" ); };
+
+    // the set is still being handled when the get reads the old value
+    REQUIRE_FALSE( t_endpoint.submit_request_message( t_make_request( dripline::op_t::set ) ) );
+    t_endpoint.submit_request_message( t_make_request( dripline::op_t::get ) );
+    t_endpoint.submit_request_message( t_make_request( dripline::op_t::get ) );
+    REQUIRE( t_endpoint.f_count == 1 );
+
+    // once the set is done, the value read while it was running is no longer used
+    t_endpoint.f_set_promise.set_reply( t_endpoint.f_set_request->reply( dripline::dl_success(), "set" ) );
+    t_endpoint.submit_request_message( t_make_request( dripline::op_t::get ) );
+    REQUIRE( t_endpoint.f_count == 2 );
+}
@@ -0,0 +1,195 @@
+/*
+ * test_get_coalescer.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "endpoint.hh"
+#include "get_coalescer.hh"
+#include "reply_future.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dripline_test
+{
+    // slow "hardware" that counts its reads, and records the replies it sends
+    class slow_get_endpoint : public dripline::endpoint
+    {
+        public:
+            slow_get_endpoint() : dripline::endpoint( "slow" ), f_count( 0 ), f_mutex(), f_sent() {}
+
+            virtual dripline::reply_ptr_t do_get_request( const dripline::request_ptr_t a_request )
+            {
+                ++f_count;
+                std::this_thread::sleep_for( std::chrono::milliseconds(200) );
+                return a_request->reply( dripline::dl_success(), "read" );
+            }
+
+            virtual dripline::reply_ptr_t do_set_request( const dripline::request_ptr_t a_request )
+            {
+                return a_request->reply( dripline::dl_success(), "set" );
+            }
+
+            std::vector< dripline::reply_ptr_t > sent() const
+            {
+                std::unique_lock< std::mutex > t_lock( f_mutex );
+                return f_sent;
+            }
+
+            std::atomic< unsigned > f_count;
+
+        protected:
+            virtual void send_reply( dripline::reply_ptr_t a_reply ) const
+            {
+                std::unique_lock< std::mutex > t_lock( f_mutex );
+                f_sent.push_back( a_reply );
+            }
+
+            mutable std::mutex f_mutex;
+            mutable std::vector< dripline::reply_ptr_t > f_sent;
+    };
+
+    // its set requests are completed later, by the test
+    class slow_set_endpoint : public slow_get_endpoint
+    {
+        public:
+            virtual dripline::reply_future do_set_request_async( const dripline::request_ptr_t a_request )
+            {
+                f_set_request = a_request;
+                return f_set_promise.get_future();
+            }
+
+            dripline::request_ptr_t f_set_request;
+            dripline::reply_promise f_set_promise;
+    };
+}
+
+TEST_CASE( "get_coalescer", "[endpoint]" )
+{
+    dripline_test::slow_get_endpoint t_endpoint;
+    t_endpoint.set_get_coalescer( std::make_shared< dripline::get_coalescer >() );
+
+    // the requests have a reply-to, so that the replies are sent (and recorded)
+    auto t_make_request = []( dripline::op_t a_op ){ return dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), a_op, "slow", "value", "reply_key" ); };
+
+    SECTION( "concurrent" )
+    {
+        std::vector< dripline::request_ptr_t > t_requests{ t_make_request( dripline::op_t::get ), t_make_request( dripline::op_t::get ), t_make_request( dripline::op_t::get ) };
+        std::vector< std::future< dripline::reply_ptr_t > > t_futures;
+        for( auto& t_request : t_requests )
+        {
+            t_futures.push_back( std::async( std::launch::async, [&t_endpoint, t_request](){ return t_endpoint.submit_request_message( t_request ); } ) );
+        }
+
+        // the request that started the read waits for it; the others share it without waiting, and are replied to when it finishes
+        unsigned t_n_waited = 0;
+        for( auto& t_future : t_futures )
+        {
+            if( t_future.get() ) ++t_n_waited;
+        }
+        REQUIRE( t_n_waited >= 1 );
+
+        auto t_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while( t_endpoint.sent().size() < t_requests.size() && std::chrono::steady_clock::now() < t_deadline )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+        }
+        std::vector< dripline::reply_ptr_t > t_sent = t_endpoint.sent();
+        REQUIRE( t_sent.size() == t_requests.size() );
+
+        std::set< std::string > t_sent_ids, t_request_ids;
+        for( unsigned i_request = 0; i_request < t_requests.size(); ++i_request )
+        {
+            REQUIRE( t_sent[i_request]->get_return_code() == dripline::dl_success::s_value );
+            t_sent_ids.insert( t_sent[i_request]->correlation_id() );
+            t_request_ids.insert( t_requests[i_request]->correlation_id() );
+        }
+        REQUIRE( t_sent_ids == t_request_ids );
+        REQUIRE( t_endpoint.f_count == 1 );
+    }
+
+    SECTION( "queued" )
+    {
+        // both requests were received before the first read started, so the second can use the first's result
+        dripline::request_ptr_t t_first = t_make_request( dripline::op_t::get );
+        dripline::request_ptr_t t_second = t_make_request( dripline::op_t::get );
+        t_endpoint.submit_request_message( t_first );
+        dripline::reply_ptr_t t_reply = t_endpoint.submit_request_message( t_second );
+        REQUIRE( t_endpoint.f_count == 1 );
+        REQUIRE( t_reply->correlation_id() == t_second->correlation_id() );
+
+        // received after the read started: needs a new read
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::get ) );
+        REQUIRE( t_endpoint.f_count == 2 );
+
+        // a set invalidates the previous result
+        dripline::request_ptr_t t_third = t_make_request( dripline::op_t::get );
+        t_endpoint.submit_request_message( t_make_request( dripline::op_t::set ) );
+        t_endpoint.submit_request_message( t_third );
+        REQUIRE( t_endpoint.f_count == 3 );
+    }
+}
+
+TEST_CASE( "get_coalescer_slow_set", "[endpoint]" )
+{
+    dripline_test::slow_set_endpoint t_endpoint;
+    t_endpoint.set_get_coalescer( std::make_shared< dripline::get_coalescer >() );
+
+    auto t_make_request = []( dripline::op_t a_op ){ return dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), a_op, "slow", "value", "" ); };
+
+    // a read starts while the set is still being handled
+    REQUIRE_FALSE( t_endpoint.submit_request_message( t_make_request( dripline::op_t::set ) ) );
+    dripline::request_ptr_t t_early = t_make_request( dripline::op_t::get );
+    auto t_early_future = std::async( std::launch::async, [&t_endpoint, t_early](){ return t_endpoint.submit_request_message( t_early ); } );
+    std::this_thread::sleep_for( std::chrono::milliseconds(50) );
+    REQUIRE( t_endpoint.f_count == 1 );
+
+    // a request that arrives after the set is done doesn't share that read
+    t_endpoint.f_set_promise.set_reply( t_endpoint.f_set_request->reply( dripline::dl_success(), "set" ) );
+    t_endpoint.submit_request_message( t_make_request( dripline::op_t::get ) );
+    REQUIRE( t_endpoint.f_count == 2 );
+
+    REQUIRE( t_early_future.get()->correlation_id() == t_early->correlation_id() );
+}
+
+TEST_CASE( "get_coalescer_bounded", "[endpoint]" )
+{
+    typedef dripline::get_coalescer::clock_t clock_t;
+    dripline::get_coalescer t_coalescer;
+    bool t_shared = false;
+
+    // a flight that's still running is kept
+    dripline::reply_promise t_running;
+    t_coalescer.execute( "running", clock_t::now(), [&t_running](){ return t_running.get_future(); }, t_shared );
+    REQUIRE_FALSE( t_shared );
+
+    // each new flight forgets the completed flights that started before its request was received
+    for( unsigned i_key = 0; i_key < 20; ++i_key )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+        dripline::reply_future t_flight = t_coalescer.execute( "key_" + std::to_string( i_key ), clock_t::now(), [](){ return dripline::reply_future::make_ready( dripline::reply_ptr_t() ); }, t_shared );
+        REQUIRE_FALSE( t_shared );
+        REQUIRE( t_flight.is_ready() );
+        REQUIRE( t_coalescer.size() == 2 );
+    }
+
+    // a request for the running flight shares it without waiting
+    dripline::reply_future t_joined = t_coalescer.execute( "running", clock_t::now(), [](){ return dripline::reply_future(); }, t_shared );
+    REQUIRE( t_shared );
+    REQUIRE_FALSE( t_joined.is_ready() );
+    t_running.set_reply( dripline::reply_ptr_t() );
+    REQUIRE( t_joined.is_ready() );
+
+    t_coalescer.invalidate();
+    REQUIRE( t_coalescer.size() == 0 );
+}
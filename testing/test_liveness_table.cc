@@ -0,0 +1,95 @@
+/*
+ * test_liveness_table.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "liveness_table.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+
+TEST_CASE( "liveness_table", "[monitor]" )
+{
+    typedef dripline::liveness_table lt;
+    using std::chrono::seconds;
+
+    // time is passed in explicitly, so the table runs on a synthetic clock
+    lt::clock_t::time_point t_start = lt::clock_t::now();
+    lt t_table( seconds(60), 3 );
+    lt::change t_change;
+
+    scarab::param_node t_stats;
+    t_stats.add( "requests", 5 );
+
+    // first heartbeat: joined, with the default interval
+    REQUIRE( t_table.record( "id-a", "service_a", t_stats, t_change, t_start ) );
+    REQUIRE( t_change.f_event == lt::event::joined );
+    REQUIRE( t_change.f_name == "service_a" );
+    REQUIRE( t_table.size() == 1 );
+
+    // the interval is learned from the second heartbeat
+    REQUIRE_FALSE( t_table.record( "id-a", "service_a", t_stats, t_change, t_start + seconds(10) ) );
+    lt::entry t_entry;
+    REQUIRE( t_table.get_entry( "id-a", t_entry ) );
+    REQUIRE( t_entry.f_interval == seconds(10) );
+    REQUIRE( t_entry.f_n_beats == 2 );
+    REQUIRE( t_entry.f_state == lt::state::alive );
+    REQUIRE_FALSE( t_table.get_entry( "id-b", t_entry ) );
+
+    SECTION( "missed_and_down" )
+    {
+        // within one and a half intervals of the last heartbeat, nothing is missed
+        REQUIRE( t_table.check( t_start + seconds(24) ).empty() );
+
+        auto t_changes = t_table.check( t_start + seconds(26) );
+        REQUIRE( t_changes.size() == 1 );
+        REQUIRE( t_changes[0].f_event == lt::event::missed );
+        REQUIRE( t_changes[0].f_n_missed == 1 );
+        REQUIRE( t_changes[0].f_since_last_seen == seconds(16) );
+        REQUIRE( t_table.count( lt::state::late ) == 1 );
+
+        // each miss is only reported once
+        REQUIRE( t_table.check( t_start + seconds(30) ).empty() );
+
+        // a long gap between checks reports each missed heartbeat, and then down
+        t_changes = t_table.check( t_start + seconds(100) );
+        REQUIRE( t_changes.size() == 2 );
+        REQUIRE( t_changes[0].f_event == lt::event::missed );
+        REQUIRE( t_changes[0].f_n_missed == 2 );
+        REQUIRE( t_changes[1].f_event == lt::event::down );
+        REQUIRE( t_changes[1].f_n_missed == 3 );
+        REQUIRE( t_table.count( lt::state::down ) == 1 );
+        REQUIRE( t_table.check( t_start + seconds(1000) ).empty() );
+
+        // a heartbeat brings it back, without changing the interval
+        REQUIRE( t_table.record( "id-a", "service_a", t_stats, t_change, t_start + seconds(1010) ) );
+        REQUIRE( t_change.f_event == lt::event::recovered );
+        REQUIRE( t_change.f_n_missed == 3 );
+        REQUIRE( t_table.get_entry( "id-a", t_entry ) );
+        REQUIRE( t_entry.f_state == lt::state::alive );
+        REQUIRE( t_entry.f_n_missed == 0 );
+        REQUIRE( t_entry.f_interval == seconds(10) );
+    }
+
+    SECTION( "snapshot" )
+    {
+        REQUIRE( t_table.record( "id-b", "service_b", scarab::param_node(), t_change, t_start + seconds(10) ) );
+
+        scarab::param_node t_snapshot = t_table.snapshot( t_start + seconds(12) );
+        REQUIRE( t_snapshot.size() == 2 );
+        REQUIRE( t_snapshot["id-a"]["name"]().as_string() == "service_a" );
+        REQUIRE( t_snapshot["id-a"]["state"]().as_string() == "alive" );
+        REQUIRE( t_snapshot["id-a"]["last_seen_s"]().as_double() == 2. );
+        REQUIRE( t_snapshot["id-a"]["up_s"]().as_double() == 12. );
+        REQUIRE( t_snapshot["id-a"]["heartbeats"]().as_uint() == 2 );
+        REQUIRE( t_snapshot["id-a"]["interval_s"]().as_double() == 10. );
+        REQUIRE( t_snapshot["id-a"]["stats"]["requests"]().as_int() == 5 );
+        REQUIRE_FALSE( t_snapshot["id-b"].as_node().has( "stats" ) );
+
+        t_table.clear();
+        REQUIRE( t_table.size() == 0 );
+    }
+}
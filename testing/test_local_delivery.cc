@@ -0,0 +1,112 @@
+/*
+ * test_local_delivery.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "local_delivery.hh"
+#include "return_codes.hh"
+#include "scope_guard.hh"
+#include "service.hh"
+
+#include "authentication.hh"
+#include "param_node.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <future>
+
+TEST_CASE( "local_delivery_topic_matches", "[core]" )
+{
+    typedef dripline::local_delivery ld;
+
+    REQUIRE( ld::topic_matches( "sensor.temp", "sensor.temp" ) );
+    REQUIRE_FALSE( ld::topic_matches( "sensor.temp", "sensor.pressure" ) );
+
+    // '*' is exactly one word
+    REQUIRE( ld::topic_matches( "sensor.*", "sensor.temp" ) );
+    REQUIRE_FALSE( ld::topic_matches( "sensor.*", "sensor" ) );
+    REQUIRE_FALSE( ld::topic_matches( "sensor.*", "sensor.temp.high" ) );
+
+    // '#' is zero or more words
+    REQUIRE( ld::topic_matches( "sensor.#", "sensor" ) );
+    REQUIRE( ld::topic_matches( "sensor.#", "sensor.temp.high" ) );
+    REQUIRE( ld::topic_matches( "#.high", "sensor.temp.high" ) );
+    REQUIRE( ld::topic_matches( "#", "anything.at.all" ) );
+    REQUIRE_FALSE( ld::topic_matches( "sensor.#.low", "sensor.temp.high" ) );
+
+    REQUIRE( ld::is_local_reply_key( ld::s_reply_prefix + "1" ) );
+    REQUIRE_FALSE( ld::is_local_reply_key( "amq.gen-abc" ) );
+}
+
+TEST_CASE( "local_delivery", "[core]" )
+{
+    dripline::local_delivery* t_registry = dripline::local_delivery::get_instance();
+
+    // neither the service nor the client connects to a broker
+    scarab::param_node t_service_config;
+    t_service_config.add( "name", "local_target" );
+    t_service_config.add( "local_delivery", true );
+    dripline::service t_service( t_service_config, scarab::authentication(), false );
+    REQUIRE( t_service.start() );
+    REQUIRE( t_registry->has_target( "local_target" ) );
+
+    scarab::param_node t_client_config;
+    t_client_config.add( "local_delivery", true );
+    dripline::core t_client( t_client_config, scarab::authentication(), false );
+
+    SECTION( "request_reply" )
+    {
+        auto t_exe_future = std::async( std::launch::async, [&](){ t_service.concurrent_receiver::execute(); } );
+
+        dripline::request_ptr_t t_request = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::cmd, "local_target", "ping", "" );
+        dripline::sent_msg_pkg_ptr t_sent_pkg = t_client.send( t_request );
+        REQUIRE( t_sent_pkg->f_successful_send );
+        REQUIRE( t_sent_pkg->f_local_replies );
+        REQUIRE_FALSE( t_sent_pkg->f_channel );
+
+        dripline::receiver t_receiver;
+        dripline::reply_ptr_t t_reply = t_receiver.wait_for_reply( t_sent_pkg, 1000 );
+        REQUIRE( t_reply );
+        REQUIRE( t_reply->get_return_code() == dripline::dl_success().rc_value() );
+
+        // the service handled a copy, so the client's request is unchanged and can be sent again
+        REQUIRE( t_request->reply_to().empty() );
+        REQUIRE( t_request->parsed_specifier().unparsed() == "ping" );
+        REQUIRE( t_request->parsed_specifier().size() == 1 );
+
+        t_service.cancel();
+        t_exe_future.wait();
+    }
+
+    SECTION( "alerts" )
+    {
+        t_registry->add_alert_subscriber( "sensor.*", &t_service );
+        dripline_test::scope_guard t_unsubscribe( [&](){ t_registry->remove_alert_subscriber( "sensor.*", &t_service ); } );
+
+        // the alert is delivered locally, and then the client (offline) would send it to the broker
+        dripline::alert_ptr_t t_alert = dripline::msg_alert::create( scarab::param_ptr_t( new scarab::param() ), "sensor.temp" );
+        REQUIRE_THROWS_AS( t_client.send( t_alert ), dripline::alert_ptr_t );
+        REQUIRE( t_service.message_queue().size() == 1 );
+        REQUIRE( t_alert->local_origin() == t_registry->process_id() );
+
+        // the copy that comes back through the broker is dropped by the subscriber, which already has it, but not by anything else
+        t_service.decode_message( dripline::undecoded_message{ t_alert->create_amqp_messages(), t_alert->routing_key() } );
+        REQUIRE( t_service.message_queue().size() == 1 );
+        scarab::param_node t_other_config;
+        t_other_config.add( "name", "other_receiver" );
+        dripline::service t_other( t_other_config, scarab::authentication(), false );
+        t_other.decode_message( dripline::undecoded_message{ t_alert->create_amqp_messages(), t_alert->routing_key() } );
+        REQUIRE( t_other.message_queue().size() == 1 );
+
+        t_alert = dripline::msg_alert::create( scarab::param_ptr_t( new scarab::param() ), "other.temp" );
+        REQUIRE_THROWS_AS( t_client.send( t_alert ), dripline::alert_ptr_t );
+        REQUIRE( t_service.message_queue().size() == 1 );
+        REQUIRE( t_alert->local_origin().empty() );
+    }
+
+    // stopping the service removes it, so requests go to the broker again
+    REQUIRE( t_service.stop() );
+    REQUIRE_FALSE( t_registry->has_target( "local_target" ) );
+}
@@ -111,6 +111,33 @@ TEST_CASE( "message-conversion", "[message]" )
         REQUIRE( *t_req_ptr == *t_conv_req_ptr );
     }
 
+    SECTION( "request with priority and TTL" )
+    {
+        dripline::request_ptr_t t_req_ptr = dripline::msg_request::create(
+                scarab::param_ptr_t( new scarab::param_node() ),
+                dripline::op_t::cmd,
+                "test.rk" );
+        t_req_ptr->set_priority( 5 );
+        t_req_ptr->set_ttl_ms( 2000 );
+        t_req_ptr->stamp_deadline();
+
+        dripline::amqp_split_message_ptrs t_amqp_msg_ptrs = t_req_ptr->create_amqp_messages();
+
+        REQUIRE( t_amqp_msg_ptrs[0] );
+        REQUIRE( t_amqp_msg_ptrs[0]->Priority() == 5 );
+
+        dripline::message_ptr_t t_conv_msg_ptr = dripline::message::process_message( t_amqp_msg_ptrs, "test.rk" );
+
+        REQUIRE( t_conv_msg_ptr->is_request() );
+
+        dripline::request_ptr_t t_conv_req_ptr = std::static_pointer_cast< dripline::msg_request >(t_conv_msg_ptr);
+
+        REQUIRE( t_conv_req_ptr->get_priority() == 5 );
+        REQUIRE( t_conv_req_ptr->get_ttl_ms() == 2000 );
+        REQUIRE( t_conv_req_ptr->get_deadline_ms() == t_req_ptr->get_deadline_ms() );
+        REQUIRE( *t_req_ptr == *t_conv_req_ptr );
+    }
+
     SECTION( "reply" )
     {
         dripline::reply_ptr_t t_rep_ptr = dripline::msg_reply::create(
@@ -0,0 +1,146 @@
+/*
+ * test_pool_executor.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "pool_executor.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    // waits up to a second for a condition
+    template< typename predicate >
+    bool wait_for( predicate a_predicate )
+    {
+        for( unsigned i_try = 0; i_try < 100; ++i_try )
+        {
+            if( a_predicate() ) return true;
+            std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+        }
+        return a_predicate();
+    }
+}
+
+TEST_CASE( "pool_executor", "[utility]" )
+{
+    using overlap_policy = dripline::pool_executor::overlap_policy;
+
+    std::atomic< bool > t_release( false );
+    std::atomic< int > t_running( 0 );
+    std::atomic< int > t_max_running( 0 );
+    std::atomic< int > t_done( 0 );
+    auto t_blocking_event = [&](){
+        int t_now_running = ++t_running;
+        if( t_now_running > t_max_running ) t_max_running = t_now_running;
+        while( ! t_release ) std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+        --t_running;
+        ++t_done;
+    };
+
+    SECTION( "serialize" )
+    {
+        dripline::pool_executor t_executor( 4, overlap_policy::serialize );
+        t_executor( t_blocking_event, 1 );
+        t_executor( t_blocking_event, 1 );
+        t_executor( t_blocking_event, 1 );
+        REQUIRE( wait_for( [&](){ return t_running == 1; } ) );
+
+        // a different event isn't held up
+        std::atomic< bool > t_other_ran( false );
+        t_executor( [&](){ t_other_ran = true; }, 2 );
+        REQUIRE( wait_for( [&](){ return t_other_ran.load(); } ) );
+
+        t_release = true;
+        REQUIRE( wait_for( [&](){ return t_done == 3; } ) );
+        REQUIRE( t_max_running == 1 );
+    }
+
+    SECTION( "skip" )
+    {
+        dripline::pool_executor t_executor( 4, overlap_policy::skip );
+        t_executor( t_blocking_event, 1 );
+        REQUIRE( wait_for( [&](){ return t_running == 1; } ) );
+        REQUIRE( t_executor.is_active( 1 ) );
+        t_executor( t_blocking_event, 1 );
+        REQUIRE( t_executor.n_skipped() == 1 );
+
+        // the run only counts as finished once the executor has cleared it, which is just after the event returns
+        t_release = true;
+        REQUIRE( wait_for( [&](){ return ! t_executor.is_active( 1 ); } ) );
+        REQUIRE( t_done == 1 );
+
+        // once the previous run has finished, the event runs again
+        t_executor( [&](){ ++t_done; }, 1 );
+        REQUIRE( wait_for( [&](){ return t_done == 2; } ) );
+        REQUIRE( t_executor.n_skipped() == 1 );
+    }
+
+    SECTION( "allow" )
+    {
+        dripline::pool_executor t_executor( 4, overlap_policy::allow );
+        t_executor( t_blocking_event, 1 );
+        t_executor( t_blocking_event, 1 );
+        REQUIRE( wait_for( [&](){ return t_running == 2; } ) );
+        t_release = true;
+        REQUIRE( wait_for( [&](){ return t_done == 2; } ) );
+    }
+
+    SECTION( "wait_until_inactive" )
+    {
+        dripline::pool_executor t_executor( 4, overlap_policy::serialize );
+        REQUIRE_FALSE( t_executor.in_event() );
+        std::atomic< bool > t_in_event( false );
+        t_executor( [&](){ t_in_event = t_executor.in_event(); }, 2 );
+        t_executor.wait_until_inactive( 2 );
+        REQUIRE( t_in_event );
+
+        t_executor( t_blocking_event, 1 );
+        t_executor( t_blocking_event, 1 );
+        REQUIRE( wait_for( [&](){ return t_running == 1; } ) );
+        std::thread t_releaser( [&](){
+            std::this_thread::sleep_for( std::chrono::milliseconds(50) );
+            t_release = true;
+        } );
+        // both runs, the running one and the waiting one, finish before this returns
+        t_executor.wait_until_inactive( 1 );
+        REQUIRE( t_done == 2 );
+        REQUIRE_FALSE( t_executor.is_active( 1 ) );
+        t_releaser.join();
+
+        // waiting for an event from that event's own run returns right away
+        std::atomic< bool > t_waited( false );
+        t_executor( [&](){ t_executor.wait_until_inactive( 3 ); t_waited = true; }, 3 );
+        REQUIRE( wait_for( [&](){ return t_waited.load(); } ) );
+    }
+
+    SECTION( "scheduler" )
+    {
+        using clock_t = typename dripline::scheduler< dripline::pool_executor >::clock_t;
+
+        dripline::scheduler< dripline::pool_executor > t_scheduler;
+        std::thread t_sched_thread( &dripline::scheduler< dripline::pool_executor >::execute, &t_scheduler );
+
+        // a slow event doesn't delay the event scheduled after it
+        std::atomic< bool > t_fast_ran( false );
+        t_scheduler.schedule( t_blocking_event, clock_t::now() );
+        t_scheduler.schedule( [&](){ t_fast_ran = true; }, clock_t::now() + std::chrono::milliseconds(100) );
+        REQUIRE( wait_for( [&](){ return t_fast_ran.load(); } ) );
+        REQUIRE( t_running == 1 );
+
+        t_release = true;
+        REQUIRE( wait_for( [&](){ return t_done == 1; } ) );
+
+        t_scheduler.cancel( 0 );
+        t_sched_thread.join();
+    }
+
+    // let any blocked events finish before the executors are destroyed
+    t_release = true;
+}
@@ -0,0 +1,101 @@
+/*
+ * test_reply_future.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "reply_future.hh"
+#include "deferred_endpoint.hh"
+#include "dripline_exceptions.hh"
+#include "endpoint.hh"
+#include "get_cache.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <thread>
+
+TEST_CASE( "reply_future", "[endpoint]" )
+{
+    dripline::request_ptr_t t_request = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "a_service", "value", "" );
+
+    SECTION( "ready" )
+    {
+        REQUIRE_FALSE( dripline::reply_future().valid() );
+
+        dripline::reply_future t_future = dripline::reply_future::make_ready( t_request->reply( dripline::dl_success(), "ready" ) );
+        REQUIRE( t_future.valid() );
+        REQUIRE( t_future.is_ready() );
+        REQUIRE( t_future.get()->return_message() == "ready" );
+    }
+
+    SECTION( "complete_from_another_thread" )
+    {
+        dripline::reply_promise t_promise;
+        dripline::reply_future t_future = t_promise.get_future();
+        REQUIRE_FALSE( t_future.is_ready() );
+        REQUIRE_FALSE( t_future.wait_for( 1 ) );
+
+        std::thread t_thread( [&t_promise, &t_request](){ t_promise.set_reply( t_request->reply( dripline::dl_success(), "later" ) ); } );
+        REQUIRE( t_future.get()->return_message() == "later" );
+        t_thread.join();
+        REQUIRE( t_promise.is_set() );
+
+        // only the first completion counts
+        t_promise.set_reply( t_request->reply( dripline::dl_success(), "again" ) );
+        REQUIRE( t_future.get()->return_message() == "later" );
+    }
+
+    SECTION( "then" )
+    {
+        dripline::reply_promise t_promise;
+        dripline::reply_future t_next = t_promise.get_future().then( [&t_request]( dripline::reply_future& a_done ){
+            return t_request->reply( dripline::dl_success(), a_done.get()->return_message() + " and then" );
+        } );
+        REQUIRE_FALSE( t_next.is_ready() );
+
+        t_promise.set_reply( t_request->reply( dripline::dl_success(), "first" ) );
+        REQUIRE( t_next.is_ready() );
+        REQUIRE( t_next.get()->return_message() == "first and then" );
+
+        // attached after completion: runs right away
+        dripline::reply_future t_after = t_promise.get_future().then( []( dripline::reply_future& a_done ){ return a_done.get(); } );
+        REQUIRE( t_after.is_ready() );
+    }
+
+    SECTION( "exception" )
+    {
+        dripline::reply_promise t_promise;
+        dripline::reply_future t_next = t_promise.get_future().then( []( dripline::reply_future& a_done ){ return a_done.get(); } );
+        t_promise.set_exception( std::make_exception_ptr( dripline::dripline_error() << "failed" ) );
+        REQUIRE_THROWS_AS( t_promise.get_future().get(), dripline::dripline_error );
+        REQUIRE_THROWS_AS( t_next.get(), dripline::dripline_error );
+    }
+}
+
+TEST_CASE( "async_request", "[endpoint]" )
+{
+    dripline_test::deferred_endpoint t_endpoint;
+    // the cache shows when the deferred reply has been processed by the endpoint
+    t_endpoint.set_get_cache( std::make_shared< dripline::get_cache >( 60000 ) );
+
+    auto t_make_request = [](){ return dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "deferred", "value", "" ); };
+
+    // the handler hasn't finished, so there's no reply yet
+    REQUIRE_FALSE( t_endpoint.submit_request_message( t_make_request() ) );
+    REQUIRE_FALSE( t_endpoint.submit_request_message( t_make_request() ) );
+    REQUIRE( t_endpoint.f_count == 2 );
+
+    t_endpoint.release();
+
+    // the completed reply was cached
+    dripline::reply_ptr_t t_reply = t_endpoint.submit_request_message( t_make_request() );
+    REQUIRE( t_reply );
+    REQUIRE( t_reply->return_message() == "done" );
+    REQUIRE( t_endpoint.f_count == 2 );
+
+    // built-in requests are still handled synchronously
+    dripline::reply_ptr_t t_ping_reply = t_endpoint.submit_request_message( dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::cmd, "deferred", "ping", "" ) );
+    REQUIRE( t_ping_reply );
+    REQUIRE( t_ping_reply->get_return_code() == dripline::dl_success::s_value );
+}
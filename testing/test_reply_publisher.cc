@@ -0,0 +1,106 @@
+/*
+ * test_reply_publisher.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "reply_publisher.hh"
+
+#include "core.hh"
+#include "message.hh"
+
+#include "authentication.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace dripline_test
+{
+    // records replies instead of publishing them to a broker; replies with the message "fail" fail
+    class recording_publisher : public dripline::reply_publisher
+    {
+        public:
+            recording_publisher( const dripline::core& a_core ) :
+                    dripline::reply_publisher( a_core, 4 ),
+                    f_published_mutex(),
+                    f_published()
+            {}
+
+            virtual ~recording_publisher()
+            {
+                stop();
+            }
+
+            std::vector< std::string > published()
+            {
+                std::unique_lock< std::mutex > t_lock( f_published_mutex );
+                return f_published;
+            }
+
+        protected:
+            virtual bool prepare_channel()
+            {
+                return true;
+            }
+
+            virtual bool publish( dripline::reply_ptr_t a_reply, std::string& a_error_message )
+            {
+                if( a_reply->return_message() == "fail" )
+                {
+                    a_error_message = "failed on purpose";
+                    return false;
+                }
+                std::unique_lock< std::mutex > t_lock( f_published_mutex );
+                f_published.push_back( a_reply->return_message() );
+                return true;
+            }
+
+            std::mutex f_published_mutex;
+            std::vector< std::string > f_published;
+    };
+}
+
+TEST_CASE( "reply_publisher", "[service]" )
+{
+    dripline::core t_core( scarab::param_node(), scarab::authentication(), false );
+    dripline_test::recording_publisher t_publisher( t_core );
+
+    dripline::request_ptr_t t_request = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "a_service", "", "reply_queue" );
+
+    // not running yet
+    REQUIRE_FALSE( t_publisher.submit( t_request->reply( dripline::dl_success(), "early" ) ) );
+
+    std::vector< std::string > t_failed;
+    t_publisher.failure_callback() = [&t_failed]( dripline::reply_ptr_t a_reply, const std::string& a_error ){
+        t_failed.push_back( a_reply->return_message() + ": " + a_error );
+    };
+
+    REQUIRE( t_publisher.start() );
+    REQUIRE( t_publisher.is_running() );
+
+    // more replies than one batch, in order, with one failure
+    const unsigned t_n_replies = 10;
+    for( unsigned i_reply = 0; i_reply < t_n_replies; ++i_reply )
+    {
+        REQUIRE( t_publisher.submit( t_request->reply( dripline::dl_success(), i_reply == 5 ? "fail" : std::to_string( i_reply ) ) ) );
+    }
+
+    // stopping publishes everything that was queued
+    t_publisher.stop();
+    REQUIRE_FALSE( t_publisher.is_running() );
+    REQUIRE( t_publisher.size() == 0 );
+
+    REQUIRE( t_publisher.n_published() == t_n_replies - 1 );
+    REQUIRE( t_publisher.n_failed() == 1 );
+    REQUIRE( t_failed.size() == 1 );
+    REQUIRE( t_failed[0] == "fail: failed on purpose" );
+
+    std::vector< std::string > t_published = t_publisher.published();
+    REQUIRE( t_published.size() == t_n_replies - 1 );
+    REQUIRE( t_published.front() == "0" );
+    REQUIRE( t_published[5] == "6" );
+    REQUIRE( t_published.back() == "9" );
+}
@@ -0,0 +1,52 @@
+/*
+ * test_reply_result.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "reply_result.hh"
+#include "message.hh"
+#include "throw_reply.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+TEST_CASE( "reply_result", "[message]" )
+{
+    dripline::request_ptr_t t_request = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "a_service", "value", "reply.to" );
+
+    SECTION( "error_result" )
+    {
+        dripline::reply_result t_result( dripline::dl_resource_error(), "Device is offline" );
+        REQUIRE_FALSE( t_result.is_success() );
+        REQUIRE( t_result.get_return_code() == dripline::dl_resource_error::s_value );
+        REQUIRE_FALSE( t_result.get_payload_ptr() );
+
+        dripline::reply_ptr_t t_reply = t_request->reply( std::move(t_result) );
+        REQUIRE( t_reply->get_return_code() == dripline::dl_resource_error::s_value );
+        REQUIRE( t_reply->return_message() == "Device is offline" );
+        REQUIRE( t_reply->correlation_id() == t_request->correlation_id() );
+        REQUIRE( t_reply->routing_key() == "reply.to" );
+        REQUIRE( t_reply->payload().is_null() );
+    }
+
+    SECTION( "payload_is_moved" )
+    {
+        scarab::param_ptr_t t_payload( new scarab::param_value( 5 ) );
+        const scarab::param* t_payload_address = t_payload.get();
+
+        dripline::reply_ptr_t t_reply = t_request->reply( dripline::reply_result::success( "done", std::move(t_payload) ) );
+        REQUIRE( t_reply->get_return_code() == dripline::dl_success::s_value );
+        REQUIRE( t_reply->return_message() == "done" );
+        REQUIRE( t_reply->get_payload_ptr().get() == t_payload_address );
+        REQUIRE( t_reply->payload()().as_int() == 5 );
+    }
+
+    SECTION( "throw_reply_take_payload" )
+    {
+        dripline::throw_reply t_throw_reply( dripline::dl_success(), scarab::param_ptr_t( new scarab::param_value( 5 ) ) );
+        scarab::param_ptr_t t_payload = t_throw_reply.take_payload();
+        REQUIRE( (*t_payload)().as_int() == 5 );
+        REQUIRE( t_throw_reply.payload().is_null() );
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * test_request_stats.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "endpoint.hh"
+#include "request_stats.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+
+TEST_CASE( "request_stats", "[endpoint]" )
+{
+    dripline::request_stats t_stats;
+
+    // bins are about 19% wide, and each latency is reported as the upper edge of its bin
+    REQUIRE( dripline::request_stats::bin( 0 ) == 0 );
+    REQUIRE( dripline::request_stats::bin_upper_edge_us( dripline::request_stats::bin( 1000 ) ) >= 1000. );
+    REQUIRE( dripline::request_stats::bin_upper_edge_us( dripline::request_stats::bin( 1000 ) ) < 1200. );
+    REQUIRE( dripline::request_stats::bin( uint64_t(1) << 40 ) == dripline::request_stats::s_n_bins - 1 );
+
+    SECTION( "percentiles" )
+    {
+        // 98 fast requests and 2 slow ones
+        for( unsigned i_req = 0; i_req < 98; ++i_req ) t_stats.record( std::chrono::milliseconds(2) );
+        t_stats.record( std::chrono::milliseconds(100) );
+        t_stats.record( std::chrono::milliseconds(100) );
+        REQUIRE( t_stats.n_total() == 100 );
+
+        dripline::request_stats::snapshot t_snapshot = t_stats.take_snapshot();
+        REQUIRE( t_snapshot.f_n_total == 100 );
+        REQUIRE( t_snapshot.f_n_requests == 100 );
+        REQUIRE( t_snapshot.f_interval_s > 0. );
+        REQUIRE( t_snapshot.f_rate > 0. );
+        REQUIRE( t_snapshot.f_p50_ms >= 2. );
+        REQUIRE( t_snapshot.f_p50_ms < 2.4 );
+        REQUIRE( t_snapshot.f_p99_ms >= 100. );
+        REQUIRE( t_snapshot.f_p99_ms < 120. );
+
+        // the next interval starts empty, but the total is kept
+        t_snapshot = t_stats.take_snapshot();
+        REQUIRE( t_snapshot.f_n_total == 100 );
+        REQUIRE( t_snapshot.f_n_requests == 0 );
+        REQUIRE( t_snapshot.f_p50_ms == 0. );
+    }
+
+    SECTION( "endpoint" )
+    {
+        auto t_shared_stats = std::make_shared< dripline::request_stats >();
+        dripline::endpoint t_endpoint( "stats" );
+        t_endpoint.set_request_stats( t_shared_stats );
+
+        // control requests are handled by the endpoint itself, and are counted like any other request
+        t_endpoint.submit_request_message( dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::cmd, "stats", "ping", "" ) );
+        t_endpoint.submit_request_message( dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "stats", "", "" ) );
+        REQUIRE( t_shared_stats->n_total() == 2 );
+    }
+}
@@ -12,9 +12,41 @@
 #include "catch2/catch_test_macros.hpp"
 
 #include <thread>
+#include <vector>
 
 LOGGER( testlog, "test_scheduler" );
 
+namespace dripline_test
+{
+    // clock that only moves when it's told to
+    struct virtual_clock
+    {
+        typedef std::chrono::microseconds duration;
+        typedef duration::rep rep;
+        typedef duration::period period;
+        typedef std::chrono::time_point< virtual_clock > time_point;
+        static const bool is_steady = true;
+
+        static time_point now() { return s_now; }
+        static void advance( duration a_step ) { s_now += a_step; }
+
+        inline static time_point s_now = time_point();
+    };
+
+    // executes events right away and records their IDs, and the address of the executable it was given
+    struct recording_executor
+    {
+        void operator()( const std::function< void() >& an_executable, int an_id )
+        {
+            f_ids.push_back( an_id );
+            f_last_executable = &an_executable;
+            an_executable();
+        }
+        std::vector< int > f_ids;
+        const std::function< void() >* f_last_executable = nullptr;
+    };
+}
+
 TEST_CASE( "scheduler", "[utility]" )
 {
     using clock_t = typename dripline::scheduler<>::clock_t;
@@ -69,3 +101,158 @@ TEST_CASE( "scheduler", "[utility]" )
 
 
 
+
+TEST_CASE( "scheduler_events", "[utility]" )
+{
+    using dripline_test::virtual_clock;
+    typedef dripline::scheduler< dripline_test::recording_executor, virtual_clock > scheduler_t;
+
+    scheduler_t t_scheduler;
+    const std::vector< int >& t_ids = t_scheduler.the_executor().f_ids;
+    unsigned t_count = 0;
+    auto t_event = [&t_count](){ ++t_count; };
+
+    virtual_clock::time_point t_start = virtual_clock::now();
+    int t_id_a = t_scheduler.schedule( t_event, t_start + std::chrono::milliseconds(1000) );
+    int t_id_b = t_scheduler.schedule( t_event, t_start + std::chrono::milliseconds(500) );
+    int t_id_c = t_scheduler.schedule( t_event, t_start + std::chrono::milliseconds(500) );
+    int t_id_d = t_scheduler.schedule( t_event, t_start + std::chrono::milliseconds(2000) );
+    REQUIRE( t_scheduler.events().size() == 4 );
+
+    // unscheduling an unknown or already-removed ID does nothing
+    t_scheduler.unschedule( t_id_d );
+    t_scheduler.unschedule( t_id_d );
+    t_scheduler.unschedule( t_id_d + 1000 );
+    REQUIRE( t_scheduler.events().size() == 3 );
+    REQUIRE_FALSE( t_scheduler.events().contains( t_id_d ) );
+
+    REQUIRE( t_scheduler.run_due_events() == 0 );
+
+    // events at the same time run in the order they were scheduled
+    virtual_clock::advance( std::chrono::milliseconds(500) );
+    REQUIRE( t_scheduler.run_due_events() == 2 );
+    virtual_clock::advance( std::chrono::milliseconds(500) );
+    REQUIRE( t_scheduler.run_due_events() == 1 );
+    REQUIRE( t_ids == std::vector< int >{ t_id_b, t_id_c, t_id_a } );
+    REQUIRE( t_scheduler.events().empty() );
+
+    // a repeating event is re-armed each time it runs
+    int t_id_r = t_scheduler.schedule( t_event, std::chrono::milliseconds(200) );
+    REQUIRE( t_scheduler.run_due_events() == 1 );
+    REQUIRE( t_scheduler.events().size() == 1 );
+    const std::function< void() >* t_first_executable = t_scheduler.the_executor().f_last_executable;
+    virtual_clock::advance( std::chrono::milliseconds(200) );
+    REQUIRE( t_scheduler.run_due_events() == 1 );
+    // each run is handed the event's own executable, not a copy
+    REQUIRE( t_scheduler.the_executor().f_last_executable == t_first_executable );
+    t_scheduler.unschedule( t_id_r );
+    REQUIRE( t_scheduler.events().empty() );
+    virtual_clock::advance( std::chrono::milliseconds(200) );
+    REQUIRE( t_scheduler.run_due_events() == 0 );
+
+    REQUIRE( t_count == 5 );
+}
+
+TEST_CASE( "scheduler_benchmark", "[.][benchmark]" )
+{
+    using dripline_test::virtual_clock;
+    typedef dripline::scheduler< dripline_test::recording_executor, virtual_clock > scheduler_t;
+    typedef std::chrono::steady_clock timer_t;
+    auto t_ms_since = []( timer_t::time_point a_start ){ return std::chrono::duration< double, std::milli >( timer_t::now() - a_start ).count(); };
+
+    const unsigned t_n_events = 1000000;
+
+    scheduler_t t_scheduler;
+    t_scheduler.the_executor().f_ids.reserve( t_n_events );
+    unsigned t_count = 0;
+    auto t_event = [&t_count](){ ++t_count; };
+
+    // events are spread over 1000 s of virtual time, in a scrambled order
+    virtual_clock::time_point t_start = virtual_clock::now();
+    std::vector< int > t_ids;
+    t_ids.reserve( t_n_events );
+    timer_t::time_point t_timer = timer_t::now();
+    for( unsigned i_event = 0; i_event < t_n_events; ++i_event )
+    {
+        t_ids.push_back( t_scheduler.schedule( t_event, t_start + std::chrono::milliseconds( (i_event * 7919ULL) % t_n_events ) ) );
+    }
+    LINFO( testlog, "Scheduled " << t_n_events << " events in " << t_ms_since( t_timer ) << " ms" );
+
+    // cancel every other event, as with timeouts that are cleared before they fire
+    t_timer = timer_t::now();
+    for( unsigned i_event = 0; i_event < t_n_events; i_event += 2 )
+    {
+        t_scheduler.unschedule( t_ids[i_event] );
+    }
+    LINFO( testlog, "Unscheduled " << t_n_events / 2 << " events in " << t_ms_since( t_timer ) << " ms" );
+    REQUIRE( t_scheduler.events().size() == t_n_events / 2 );
+
+    t_timer = timer_t::now();
+    virtual_clock::advance( std::chrono::seconds(1001) );
+    REQUIRE( t_scheduler.run_due_events() == t_n_events / 2 );
+    LINFO( testlog, "Executed " << t_n_events / 2 << " events in " << t_ms_since( t_timer ) << " ms" );
+    REQUIRE( t_count == t_n_events / 2 );
+    REQUIRE( t_scheduler.events().empty() );
+}
+
+TEST_CASE( "scheduler_missed_ticks", "[utility]" )
+{
+    using dripline_test::virtual_clock;
+    typedef dripline::scheduler< dripline_test::recording_executor, virtual_clock > scheduler_t;
+
+    scheduler_t t_scheduler;
+    t_scheduler.set_exe_buffer( std::chrono::milliseconds(10) );
+    const std::vector< int >& t_ids = t_scheduler.the_executor().f_ids;
+    auto t_event = [](){};
+
+    // intervals down to twice the execution buffer are allowed
+    REQUIRE_THROWS_AS( t_scheduler.schedule( t_event, std::chrono::milliseconds(15) ), dripline::dripline_error );
+
+    scheduler_t::event_stats t_stats;
+    REQUIRE_FALSE( t_scheduler.get_event_stats( -1, t_stats ) );
+
+    // ticks at 0, 100, 200, ... ms; the scheduler is then held up until 350 ms, when the 100, 200, and 300 ms ticks are due
+    auto t_run_late = [&]( dripline::missed_tick_policy a_policy ){
+        int t_id = t_scheduler.schedule( t_event, std::chrono::milliseconds(100), virtual_clock::now(), a_policy );
+        REQUIRE( t_scheduler.run_due_events() == 1 );
+        virtual_clock::advance( std::chrono::milliseconds(350) );
+        return t_id;
+    };
+
+    SECTION( "catch_up" )
+    {
+        int t_id = t_run_late( dripline::missed_tick_policy::catch_up );
+        REQUIRE( t_scheduler.run_due_events() == 3 );
+        REQUIRE( t_scheduler.get_event_stats( t_id, t_stats ) );
+        REQUIRE( t_stats.f_n_executed == 4 );
+        REQUIRE( t_stats.f_n_missed == 0 );
+        REQUIRE( t_stats.f_max_lateness == std::chrono::milliseconds(250) );
+        REQUIRE( t_stats.f_last_lateness == std::chrono::milliseconds(50) );
+    }
+
+    SECTION( "coalesce" )
+    {
+        int t_id = t_run_late( dripline::missed_tick_policy::coalesce );
+        REQUIRE( t_scheduler.run_due_events() == 1 );
+        REQUIRE( t_scheduler.get_event_stats( t_id, t_stats ) );
+        REQUIRE( t_stats.f_n_executed == 2 );
+        REQUIRE( t_stats.f_n_missed == 2 );
+        REQUIRE( t_stats.f_last_lateness == std::chrono::milliseconds(250) );
+    }
+
+    SECTION( "skip" )
+    {
+        int t_id = t_run_late( dripline::missed_tick_policy::skip );
+        REQUIRE( t_scheduler.run_due_events() == 0 );
+        REQUIRE( t_scheduler.get_event_stats( t_id, t_stats ) );
+        REQUIRE( t_stats.f_n_executed == 1 );
+        REQUIRE( t_stats.f_n_missed == 3 );
+    }
+
+    // in every case, the next tick is still aligned at 400 ms, and is on time
+    REQUIRE( t_scheduler.run_due_events() == 0 );
+    virtual_clock::advance( std::chrono::milliseconds(50) );
+    REQUIRE( t_scheduler.run_due_events() == 1 );
+    REQUIRE( t_scheduler.get_event_stats( t_ids.back(), t_stats ) );
+    REQUIRE( t_stats.f_last_lateness == std::chrono::milliseconds(0) );
+}
@@ -6,6 +6,7 @@
  */
 
 #include "dripline_exceptions.hh"
+#include "request_stats.hh"
 #include "service.hh"
 
 #include "authentication.hh"
@@ -13,9 +14,45 @@
 
 #include "catch2/catch_test_macros.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
 #include <thread>
+#include <vector>
+
+namespace dripline_test
+{
+    // exposes run_setup_step() to the tests
+    class setup_step_service : public dripline::service
+    {
+        public:
+            setup_step_service( const scarab::param_node& a_config ) :
+                    scarab::cancelable(),
+                    dripline::service( a_config, scarab::authentication(), false )
+            {}
+
+            using dripline::service::run_setup_step;
+    };
+
+    // records the messages it handles, and cancels itself when it handles one from the priority lane
+    class cancel_on_priority_receiver : public dripline::concurrent_receiver
+    {
+        public:
+            std::vector< dripline::message_ptr_t > f_handled;
+
+        protected:
+            virtual void submit_message( dripline::message_ptr_t a_message )
+            {
+                f_handled.push_back( a_message );
+                if( is_priority_message( a_message ) ) cancel();
+            }
+    };
+}
 
 TEST_CASE( "process_message", "[service]" )
 {
@@ -41,6 +78,236 @@ TEST_CASE( "process_message", "[service]" )
 
 }
 
+TEST_CASE( "drain_on_cancel", "[service]" )
+{
+    // the request statistics count the requests that are handled
+    scarab::param_node t_config;
+    t_config.add( "heartbeat_stats", true );
+    dripline::service t_service( t_config, scarab::authentication(), false);
+    REQUIRE( t_service.get_request_stats() );
+
+    dripline::request_ptr_t t_request_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "dlcpp_service", "", "" );
+
+    // the service is canceled with a request still waiting, so execute() returns right away
+    t_service.cancel();
+    t_service.process_message( t_request_ptr );
+
+    SECTION( "dropped" )
+    {
+        t_service.concurrent_receiver::execute();
+        REQUIRE( t_service.message_queue().empty() );
+        REQUIRE( t_service.get_request_stats()->n_total() == 0 );
+    }
+
+    SECTION( "drained" )
+    {
+        t_service.set_drain_timeout_ms( 1000 );
+        t_service.concurrent_receiver::execute();
+        REQUIRE( t_service.message_queue().empty() );
+        REQUIRE( t_service.get_request_stats()->n_total() == 1 );
+    }
+}
+
+TEST_CASE( "drain_message_taken_at_cancel", "[service]" )
+{
+    dripline_test::cancel_on_priority_receiver t_receiver;
+    t_receiver.set_use_priority_lane( true );
+
+    dripline::request_ptr_t t_normal_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "dlcpp_service", "value", "" );
+    dripline::request_ptr_t t_urgent_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "dlcpp_service", "value", "" );
+    t_urgent_ptr->set_priority( 10 );
+
+    // execute() takes the normal request from the main queue, and then handles the priority request, which cancels the receiver;
+    // the normal request has already been taken from the queue at that point
+    t_receiver.process_message( t_normal_ptr );
+    t_receiver.process_message( t_urgent_ptr );
+
+    SECTION( "dropped" )
+    {
+        t_receiver.execute();
+        REQUIRE( t_receiver.f_handled.size() == 1 );
+        REQUIRE( t_receiver.f_handled[0] == t_urgent_ptr );
+    }
+
+    SECTION( "drained" )
+    {
+        t_receiver.set_drain_timeout_ms( 1000 );
+        t_receiver.execute();
+        REQUIRE( t_receiver.f_handled.size() == 2 );
+        REQUIRE( t_receiver.f_handled[0] == t_urgent_ptr );
+        REQUIRE( t_receiver.f_handled[1] == t_normal_ptr );
+    }
+}
+
+TEST_CASE( "decode_message", "[service]" )
+{
+    dripline::service t_service( scarab::param_node(), scarab::authentication(), false);
+    t_service.set_n_decoders( 2 );
+
+    dripline::request_ptr_t t_request_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "dlcpp_service", "", "" );
+    dripline::undecoded_message t_undecoded{ t_request_ptr->create_amqp_messages(), t_request_ptr->routing_key() };
+    REQUIRE( t_undecoded.f_chunks.size() == 1 );
+
+    // the decoder threads have not been started, so the message is decoded in this thread and queued immediately
+    t_service.decode_message( std::move(t_undecoded) );
+    REQUIRE( t_service.decode_queue().empty() );
+    REQUIRE( t_service.message_queue().size() == 1 );
+
+    dripline::message_ptr_t t_decoded;
+    REQUIRE( t_service.message_queue().try_pop( t_decoded ) );
+    REQUIRE( t_decoded->is_request() );
+    REQUIRE( t_decoded->message_id() == t_request_ptr->message_id() );
+}
+
+TEST_CASE( "decoder_threads", "[service]" )
+{
+    dripline::service t_service( scarab::param_node(), scarab::authentication(), false);
+    t_service.set_n_decoders( 2 );
+    t_service.start_decoders();
+    REQUIRE( t_service.decoder_threads().size() == 2 );
+
+    // the decoder threads decode the messages and queue them for handling
+    std::set< std::string > t_sent_ids;
+    for( unsigned i_message = 0; i_message < 5; ++i_message )
+    {
+        dripline::request_ptr_t t_request_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "dlcpp_service", "", "" );
+        t_sent_ids.insert( t_request_ptr->message_id() );
+        t_service.decode_message( dripline::undecoded_message{ t_request_ptr->create_amqp_messages(), t_request_ptr->routing_key() } );
+    }
+
+    auto t_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while( t_service.message_queue().size() < 5 && std::chrono::steady_clock::now() < t_deadline )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+    }
+    REQUIRE( t_service.message_queue().size() == 5 );
+    REQUIRE( t_service.decode_queue().empty() );
+
+    std::set< std::string > t_decoded_ids;
+    dripline::message_ptr_t t_decoded;
+    while( t_service.message_queue().try_pop( t_decoded ) )
+    {
+        REQUIRE( t_decoded->is_request() );
+        t_decoded_ids.insert( t_decoded->message_id() );
+    }
+    REQUIRE( t_decoded_ids == t_sent_ids );
+
+    // canceling wakes the decoder threads, so they can be joined right away
+    auto t_cancel_time = std::chrono::steady_clock::now();
+    t_service.cancel();
+    t_service.join_decoders();
+    REQUIRE( t_service.decoder_threads().empty() );
+    REQUIRE( std::chrono::steady_clock::now() - t_cancel_time < std::chrono::seconds(1) );
+}
+
+TEST_CASE( "priority_lane", "[service]" )
+{
+    dripline::service t_service( scarab::param_node(), scarab::authentication(), false);
+    // the priority lane is off unless it's requested
+    REQUIRE_FALSE( t_service.get_use_priority_lane() );
+    t_service.set_use_priority_lane( true );
+
+    dripline::request_ptr_t t_slow_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "dlcpp_service", "value", "" );
+    dripline::request_ptr_t t_ping_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::cmd, "dlcpp_service", "ping", "" );
+    dripline::request_ptr_t t_urgent_ptr = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, "dlcpp_service", "value", "" );
+    t_urgent_ptr->set_priority( 10 );
 
+    REQUIRE_FALSE( t_service.is_priority_message( t_slow_ptr ) );
+    REQUIRE( t_service.is_priority_message( t_ping_ptr ) );
+    REQUIRE( t_service.is_priority_message( t_urgent_ptr ) );
 
+    t_service.process_message( t_slow_ptr );
+    t_service.process_message( t_ping_ptr );
+    t_service.process_message( t_urgent_ptr );
 
+    // each priority message leaves an empty wake-up message in the main queue
+    REQUIRE( t_service.priority_queue().size() == 2 );
+    REQUIRE( t_service.message_queue().size() == 3 );
+
+    SECTION( "disabled" )
+    {
+        t_service.set_use_priority_lane( false );
+        REQUIRE_FALSE( t_service.is_priority_message( t_ping_ptr ) );
+        REQUIRE_FALSE( t_service.is_priority_message( t_urgent_ptr ) );
+    }
+
+    SECTION( "threshold" )
+    {
+        t_service.set_priority_threshold( 20 );
+        REQUIRE_FALSE( t_service.is_priority_message( t_urgent_ptr ) );
+        // control requests don't depend on the threshold
+        REQUIRE( t_service.is_priority_message( t_ping_ptr ) );
+    }
+}
+
+TEST_CASE( "run_setup_step", "[service]" )
+{
+    const unsigned t_n_children = 4;
+    auto t_make_service = [&]( const std::string& a_mode ){
+        scarab::param_node t_config;
+        t_config.add( "async_children_mode", a_mode );
+        t_config.add( "setup_threads", 2 );
+        auto t_service = std::make_shared< dripline_test::setup_step_service >( t_config );
+        for( unsigned i_child = 0; i_child < t_n_children; ++i_child )
+        {
+            REQUIRE( t_service->add_async_child( std::make_shared< dripline::endpoint >( "child_" + std::to_string( i_child ) ) ) );
+        }
+        return t_service;
+    };
+
+    // the child steps record the threads they run on and how many of them run at once
+    std::mutex t_mutex;
+    std::set< std::thread::id > t_child_threads;
+    std::set< std::string > t_children_done;
+    std::atomic< unsigned > t_running( 0 );
+    std::atomic< unsigned > t_max_running( 0 );
+    auto t_child_step = [&]( dripline::service::async_map_t::value_type& a_child ) -> bool {
+        unsigned t_now_running = ++t_running;
+        // raise the maximum without losing a larger value stored by another thread
+        unsigned t_prev_max = t_max_running.load();
+        while( t_now_running > t_prev_max && ! t_max_running.compare_exchange_weak( t_prev_max, t_now_running ) ) {}
+        std::this_thread::sleep_for( std::chrono::milliseconds(50) );
+        --t_running;
+        std::unique_lock< std::mutex > t_lock( t_mutex );
+        t_child_threads.insert( std::this_thread::get_id() );
+        t_children_done.insert( a_child.first );
+        return a_child.first != "child_1";
+    };
+    std::thread::id t_main_thread;
+    auto t_main_step = [&]() -> bool {
+        t_main_thread = std::this_thread::get_id();
+        return true;
+    };
+
+    SECTION( "threads" )
+    {
+        auto t_service = t_make_service( "threads" );
+
+        // every child's step runs, even after one fails, and the failure is reported
+        REQUIRE_FALSE( t_service->run_setup_step( t_main_step, t_child_step ) );
+        REQUIRE( t_children_done.size() == t_n_children );
+        REQUIRE( t_main_thread == std::this_thread::get_id() );
+
+        // the children are set up on setup_threads threads, at the same time, and not in this thread
+        REQUIRE( t_max_running == 2 );
+        REQUIRE( t_child_threads.size() == 2 );
+        REQUIRE( t_child_threads.count( std::this_thread::get_id() ) == 0 );
+
+        // a failure of the main step is reported too
+        REQUIRE_FALSE( t_service->run_setup_step( [](){ return false; }, []( dripline::service::async_map_t::value_type& ){ return true; } ) );
+        REQUIRE( t_service->run_setup_step( t_main_step, []( dripline::service::async_map_t::value_type& ){ return true; } ) );
+    }
+
+    SECTION( "pool" )
+    {
+        auto t_service = t_make_service( "pool" );
+
+        // the children share a channel, so their steps run one at a time, in one thread
+        REQUIRE_FALSE( t_service->run_setup_step( t_main_step, t_child_step ) );
+        REQUIRE( t_children_done.size() == t_n_children );
+        REQUIRE( t_max_running == 1 );
+        REQUIRE( t_child_threads.size() == 1 );
+
+        REQUIRE( t_service->run_setup_step( nullptr, []( dripline::service::async_map_t::value_type& ){ return true; } ) );
+    }
+}
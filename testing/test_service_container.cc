@@ -0,0 +1,152 @@
+/*
+ * test_service_container.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "endpoint.hh"
+#include "return_codes.hh"
+#include "service.hh"
+#include "service_container.hh"
+#include "worker_pool.hh"
+
+#include "authentication.hh"
+#include "param_node.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace dripline_test
+{
+    // exposes the container's message routing and the startup of its hosted services, neither of which needs a broker
+    class routing_container : public dripline::service_container
+    {
+        public:
+            routing_container() :
+                    scarab::cancelable(),
+                    dripline::service_container( scarab::param_node(), scarab::authentication(), false )
+            {}
+
+            using dripline::service_container::receiver_map_t;
+            using dripline::service_container::receivers_by_consumer_tag;
+            using dripline::service_container::route_message_chunk;
+            using dripline::service_container::start_hosted_services;
+            using dripline::service_container::stop_hosted_services;
+    };
+
+    // counts the get requests it handles
+    class counting_endpoint : public dripline::endpoint
+    {
+        public:
+            counting_endpoint( const std::string& a_name ) : dripline::endpoint( a_name ), f_count( 0 ) {}
+
+            virtual dripline::reply_ptr_t do_get_request( const dripline::request_ptr_t a_request )
+            {
+                ++f_count;
+                return a_request->reply( dripline::dl_success(), "counted" );
+            }
+
+            std::atomic< unsigned > f_count;
+    };
+}
+
+TEST_CASE( "service_container", "[service]" )
+{
+    scarab::param_node t_container_config;
+    t_container_config.add( "async_reply_publishing", true );
+    dripline::service_container t_container( t_container_config, scarab::authentication(), false );
+    REQUIRE( t_container.get_reply_publisher() );
+
+    scarab::param_node t_config_a;
+    t_config_a.add( "name", "service_a" );
+    t_config_a.add( "decode_threads", 2 );
+    auto t_service_a = std::make_shared< dripline::service >( t_config_a, scarab::authentication(), false );
+
+    scarab::param_node t_config_b;
+    t_config_b.add( "name", "service_b" );
+    auto t_service_b = std::make_shared< dripline::service >( t_config_b, scarab::authentication(), false );
+
+    // hosted services run their children in the shared pool, decode in the dispatcher, and share the reply publisher
+    REQUIRE( t_container.add_service( t_service_a ) );
+    REQUIRE( t_service_a->get_pool_async_children() );
+    REQUIRE( t_service_a->get_n_decoders() == 0 );
+    REQUIRE( t_service_a->get_reply_publisher() == t_container.get_reply_publisher() );
+
+    // names must be unique
+    REQUIRE_FALSE( t_container.add_service( std::make_shared< dripline::service >( t_config_a, scarab::authentication(), false ) ) );
+
+    REQUIRE( t_container.add_service( t_service_b ) );
+    REQUIRE( t_container.services().size() == 2 );
+    REQUIRE( t_container.services().at( "service_b" ) == t_service_b );
+
+    // without a broker, running the container does nothing
+    REQUIRE( t_container.start() );
+    REQUIRE( t_container.listen() );
+    REQUIRE( t_container.stop() );
+}
+
+TEST_CASE( "service_container_routing", "[service]" )
+{
+    dripline_test::routing_container t_container;
+
+    scarab::param_node t_config_a;
+    t_config_a.add( "name", "service_a" );
+    auto t_service_a = std::make_shared< dripline::service >( t_config_a, scarab::authentication(), false );
+    auto t_async_child = std::make_shared< dripline_test::counting_endpoint >( "child_a" );
+    REQUIRE( t_service_a->add_async_child( t_async_child ) );
+
+    scarab::param_node t_config_b;
+    t_config_b.add( "name", "service_b" );
+    auto t_service_b = std::make_shared< dripline::service >( t_config_b, scarab::authentication(), false );
+    auto t_sync_child = std::make_shared< dripline_test::counting_endpoint >( "child_b" );
+    REQUIRE( t_service_b->add_child( t_sync_child ) );
+
+    REQUIRE( t_container.add_service( t_service_a ) );
+    REQUIRE( t_container.add_service( t_service_b ) );
+
+    // the consumer tags would be assigned by the broker when the services start consuming
+    t_service_a->consumer_tag() = "tag_a";
+    t_service_a->async_children().at( "child_a" )->consumer_tag() = "tag_child_a";
+    t_service_b->consumer_tag() = "tag_b";
+
+    dripline_test::routing_container::receiver_map_t t_receivers = t_container.receivers_by_consumer_tag();
+    REQUIRE( t_receivers.size() == 3 );
+    REQUIRE( t_receivers.at( "tag_a" ) == t_service_a );
+    REQUIRE( t_receivers.at( "tag_child_a" ) == t_service_a->async_children().at( "child_a" ) );
+    REQUIRE( t_receivers.at( "tag_b" ) == t_service_b );
+
+    // the hosted services and their asynchronous children hand their messages to the container's pool, each in its own strand
+    t_container.pool()->start( 2 );
+    t_container.start_hosted_services();
+    REQUIRE_FALSE( t_service_a->wait_until_not_listening( 0 ) );
+    REQUIRE( t_service_a->get_worker_pool() == t_container.pool() );
+    REQUIRE( t_service_a->strand() == "service_a" );
+    REQUIRE( t_service_a->async_children().at( "child_a" )->get_worker_pool() == t_container.pool() );
+    REQUIRE( t_service_a->async_children().at( "child_a" )->strand() == "child_a" );
+    REQUIRE( t_service_b->get_worker_pool() == t_container.pool() );
+    REQUIRE( t_service_b->strand() == "service_b" );
+
+    auto t_envelope = []( const std::string& a_routing_key, const std::string& a_consumer_tag ){
+        dripline::request_ptr_t t_request = dripline::msg_request::create( scarab::param_ptr_t( new scarab::param() ), dripline::op_t::get, a_routing_key, "", "" );
+        return AmqpClient::Envelope::Create( t_request->create_amqp_messages().front(), a_consumer_tag, 0, "requests", false, a_routing_key, 1 );
+    };
+
+    // messages go to the receiver for their consumer tag; the routing key only matters within a service
+    REQUIRE( t_container.route_message_chunk( t_receivers, t_envelope( "child_a", "tag_child_a" ) ) );
+    REQUIRE( t_container.route_message_chunk( t_receivers, t_envelope( "child_b", "tag_b" ) ) );
+    REQUIRE( t_container.route_message_chunk( t_receivers, t_envelope( "child_b", "tag_b" ) ) );
+    REQUIRE_FALSE( t_container.route_message_chunk( t_receivers, t_envelope( "child_a", "unknown_tag" ) ) );
+
+    REQUIRE( t_container.pool()->drain( 1000 ) );
+    REQUIRE( t_async_child->f_count == 1 );
+    REQUIRE( t_sync_child->f_count == 2 );
+
+    t_container.pool()->stop();
+    t_container.stop_hosted_services();
+    REQUIRE( t_service_a->wait_until_not_listening( 0 ) );
+    REQUIRE( t_service_b->wait_until_not_listening( 0 ) );
+}
@@ -9,6 +9,8 @@
 
 #include "catch2/catch_test_macros.hpp"
 
+#include <stdexcept>
+
 TEST_CASE( "specifier", "[message]" )
 {
     dripline::specifier t_spec( "path.to.target" );
@@ -27,8 +29,127 @@ TEST_CASE( "specifier", "[message]" )
     t_spec.reparse();
     REQUIRE( t_spec.size() == 3 );
     REQUIRE( t_spec.front() == "path" );
+
+    t_spec.set_unparsed( "other.target" );
+    REQUIRE( t_spec.unparsed() == "other.target" );
+    REQUIRE( t_spec.size() == 2 );
+    REQUIRE( t_spec.front() == "other" );
+    REQUIRE( t_spec.back() == "target" );
 }
 
 
 
 
+
+TEST_CASE( "specifier_tokens", "[message]" )
+{
+    SECTION( "many_tokens" )
+    {
+        // more tokens than are stored inline
+        dripline::specifier t_spec( "a.b.c.d.e.f.g.h.i.j" );
+        REQUIRE( t_spec.size() == 10 );
+        REQUIRE( t_spec[8] == "i" );
+        REQUIRE( t_spec.back() == "j" );
+
+        for( unsigned i_pop = 0; i_pop < 9; ++i_pop ) t_spec.pop_front();
+        REQUIRE( t_spec.size() == 1 );
+        REQUIRE( t_spec.front() == "j" );
+        REQUIRE( t_spec.unparsed() == "a.b.c.d.e.f.g.h.i.j" );
+    }
+
+    SECTION( "pop_and_to_string" )
+    {
+        dripline::specifier t_spec( "path.to.target" );
+        std::string_view t_first = t_spec.front();
+        t_spec.pop_front();
+        REQUIRE( t_first == "path" );
+        REQUIRE( t_spec.to_string() == "to.target" );
+
+        t_spec.pop_front();
+        t_spec.pop_front();
+        REQUIRE( t_spec.empty() );
+        REQUIRE( t_spec.front().empty() );
+        REQUIRE( t_spec.to_string().empty() );
+        t_spec.pop_front();
+        REQUIRE( t_spec.empty() );
+    }
+
+    SECTION( "copy_and_compare" )
+    {
+        dripline::specifier t_spec( "path.to.target" );
+        t_spec.pop_front();
+        dripline::specifier t_copy( t_spec );
+        REQUIRE( t_copy.size() == 2 );
+        REQUIRE( t_copy.front() == "to" );
+        REQUIRE( t_copy == t_spec );
+        REQUIRE( t_copy != dripline::specifier( "path.to.target" ) );
+
+        std::string t_front = t_copy.front();
+        REQUIRE( t_front == "to" );
+    }
+
+    SECTION( "empty_tokens" )
+    {
+        dripline::specifier t_spec( "a..b." );
+        REQUIRE( t_spec.size() == 4 );
+        REQUIRE( t_spec[1].empty() );
+        REQUIRE( t_spec.back().empty() );
+
+        REQUIRE( dripline::specifier( "" ).empty() );
+    }
+
+    SECTION( "routing_key" )
+    {
+        dripline::routing_key t_key;
+        REQUIRE( t_key.empty() );
+        t_key.push_back( "heartbeat" );
+        t_key.push_back( std::string( "my_service" ) );
+        REQUIRE( t_key.size() == 2 );
+        REQUIRE( t_key.to_string() == "heartbeat.my_service" );
+
+        unsigned t_count = 0;
+        for( auto t_token : t_key )
+        {
+            REQUIRE( ! t_token.empty() );
+            ++t_count;
+        }
+        REQUIRE( t_count == 2 );
+
+        t_key.parse( "x.y.z" );
+        REQUIRE( t_key.size() == 3 );
+        REQUIRE( t_key.front() == "x" );
+
+        // parsing an empty routing key gives no tokens, the same as constructing with one
+        t_key.parse( "" );
+        REQUIRE( t_key.size() == dripline::routing_key( "" ).size() );
+        REQUIRE( t_key.empty() );
+        REQUIRE( t_key.to_string().empty() );
+    }
+
+    SECTION( "deque_compatibility" )
+    {
+        dripline::specifier t_spec( "a.b.c" );
+        t_spec.pop_front();
+        t_spec.push_front( "z" );
+        REQUIRE( t_spec.size() == 3 );
+        REQUIRE( t_spec.to_string() == "z.b.c" );
+
+        REQUIRE( t_spec.at( 2 ) == "c" );
+        REQUIRE_THROWS_AS( t_spec.at( 3 ), std::out_of_range );
+
+        auto t_next = t_spec.erase( ++t_spec.begin() );
+        REQUIRE( *t_next == "c" );
+        REQUIRE( t_spec.to_string() == "z.c" );
+        t_spec.erase( t_spec.begin(), t_spec.end() );
+        REQUIRE( t_spec.empty() );
+
+        // an empty token is kept
+        t_spec.parse( "x..y" );
+        t_spec.erase( t_spec.begin() );
+        REQUIRE( t_spec.size() == 2 );
+        REQUIRE( t_spec.front().empty() );
+
+        dripline::specifier::container_type t_tokens = dripline::specifier( "p.q" ).to_container();
+        REQUIRE( t_tokens == dripline::specifier::container_type{ "p", "q" } );
+    }
+}
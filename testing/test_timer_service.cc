@@ -0,0 +1,85 @@
+/*
+ * test_timer_service.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "timer_service.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST_CASE( "timer_service", "[utility]" )
+{
+    dripline::timer_service* t_timers = dripline::timer_service::get_instance();
+    REQUIRE( t_timers == dripline::timer_service::get_instance() );
+    REQUIRE_FALSE( t_timers->in_timer() );
+
+    SECTION( "one_off" )
+    {
+        std::mutex t_mutex;
+        std::vector< int > t_order;
+        std::atomic< bool > t_in_timer( false );
+        auto t_record = [&]( int a_value ){
+            std::unique_lock< std::mutex > t_lock( t_mutex );
+            t_order.push_back( a_value );
+            t_in_timer = t_timers->in_timer();
+        };
+
+        // scheduled out of order; they go off in order
+        t_timers->schedule_after( [&](){ t_record( 2 ); }, std::chrono::milliseconds(60) );
+        t_timers->schedule_after( [&](){ t_record( 1 ); }, std::chrono::milliseconds(30) );
+        int t_canceled = t_timers->schedule_after( [&](){ t_record( 3 ); }, std::chrono::milliseconds(90) );
+        t_timers->cancel_timer( t_canceled );
+
+        std::this_thread::sleep_for( std::chrono::milliseconds(200) );
+        std::unique_lock< std::mutex > t_lock( t_mutex );
+        REQUIRE( t_order == std::vector< int >{ 1, 2 } );
+        REQUIRE( t_in_timer );
+    }
+
+    SECTION( "repeating" )
+    {
+        std::atomic< int > t_count( 0 );
+        int t_id = t_timers->schedule( [&](){ ++t_count; }, std::chrono::milliseconds(20) );
+        std::this_thread::sleep_for( std::chrono::milliseconds(110) );
+        t_timers->cancel_timer( t_id );
+
+        // cancel_timer() waited for a run in progress, so the count doesn't change after it returns
+        int t_final_count = t_count;
+        REQUIRE( t_final_count >= 4 );
+        std::this_thread::sleep_for( std::chrono::milliseconds(50) );
+        REQUIRE( t_count == t_final_count );
+    }
+
+    SECTION( "slow_timer" )
+    {
+        // a slow timer doesn't hold up the timers after it
+        std::atomic< bool > t_release( false );
+        std::atomic< bool > t_slow_done( false );
+        std::atomic< bool > t_fast_ran( false );
+        int t_slow_id = t_timers->schedule_after( [&](){
+                while( ! t_release ) std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+                t_slow_done = true;
+            }, std::chrono::milliseconds(10) );
+        t_timers->schedule_after( [&](){ t_fast_ran = true; }, std::chrono::milliseconds(30) );
+        std::this_thread::sleep_for( std::chrono::milliseconds(100) );
+        REQUIRE( t_fast_ran );
+        REQUIRE_FALSE( t_slow_done );
+
+        // canceling a timer that's running waits for it to finish
+        std::thread t_releaser( [&](){
+            std::this_thread::sleep_for( std::chrono::milliseconds(50) );
+            t_release = true;
+        } );
+        t_timers->cancel_timer( t_slow_id );
+        REQUIRE( t_slow_done );
+        t_releaser.join();
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * test_worker_pool.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: N.S. Oblath
+ */
+
+#include "worker_pool.hh"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST_CASE( "worker_pool", "[service]" )
+{
+    dripline::worker_pool t_pool;
+    t_pool.start( 4 );
+    REQUIRE( t_pool.n_threads() == 4 );
+
+    SECTION( "strand_order" )
+    {
+        // tasks in a strand run in order and never at the same time
+        const unsigned t_n_tasks = 100;
+        std::mutex t_mutex;
+        std::vector< unsigned > t_order_a, t_order_b;
+        std::atomic< int > t_running_a( 0 );
+        std::atomic< bool > t_overlap( false );
+        std::atomic< unsigned > t_done( 0 );
+
+        for( unsigned i_task = 0; i_task < t_n_tasks; ++i_task )
+        {
+            t_pool.submit( "a", [&, i_task](){
+                if( ++t_running_a > 1 ) t_overlap = true;
+                {
+                    std::unique_lock< std::mutex > t_lock( t_mutex );
+                    t_order_a.push_back( i_task );
+                }
+                --t_running_a;
+                ++t_done;
+            } );
+            t_pool.submit( "b", [&, i_task](){
+                {
+                    std::unique_lock< std::mutex > t_lock( t_mutex );
+                    t_order_b.push_back( i_task );
+                }
+                ++t_done;
+            } );
+        }
+
+        while( t_done.load() < 2 * t_n_tasks ) std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+
+        REQUIRE_FALSE( t_overlap.load() );
+        REQUIRE( t_order_a.size() == t_n_tasks );
+        REQUIRE( t_order_b.size() == t_n_tasks );
+        for( unsigned i_task = 0; i_task < t_n_tasks; ++i_task )
+        {
+            REQUIRE( t_order_a[i_task] == i_task );
+            REQUIRE( t_order_b[i_task] == i_task );
+        }
+    }
+
+    SECTION( "strands_run_concurrently" )
+    {
+        // a blocked strand does not hold up another strand
+        std::atomic< bool > t_release( false );
+        std::atomic< bool > t_other_done( false );
+        t_pool.submit( "slow", [&](){ while( ! t_release.load() ) std::this_thread::sleep_for( std::chrono::milliseconds(1) ); } );
+        t_pool.submit( "fast", [&](){ t_other_done = true; } );
+
+        for( unsigned i_wait = 0; i_wait < 1000 && ! t_other_done.load(); ++i_wait ) std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+        REQUIRE( t_other_done.load() );
+        t_release = true;
+    }
+
+    SECTION( "front_of_strand" )
+    {
+        // a task submitted to the front of a strand runs before the tasks already waiting in it
+        std::atomic< bool > t_release( false );
+        std::mutex t_mutex;
+        std::vector< unsigned > t_order;
+        std::atomic< unsigned > t_done( 0 );
+        t_pool.submit( "s", [&](){ while( ! t_release.load() ) std::this_thread::sleep_for( std::chrono::milliseconds(1) ); ++t_done; } );
+        t_pool.submit( "s", [&](){ std::unique_lock< std::mutex > t_lock( t_mutex ); t_order.push_back( 1 ); ++t_done; } );
+        t_pool.submit( "s", [&](){ std::unique_lock< std::mutex > t_lock( t_mutex ); t_order.push_back( 2 ); ++t_done; }, true );
+        t_release = true;
+
+        while( t_done.load() < 3 ) std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+        REQUIRE( t_order.size() == 2 );
+        REQUIRE( t_order[0] == 2 );
+        REQUIRE( t_order[1] == 1 );
+    }
+
+    SECTION( "front_tasks_in_order" )
+    {
+        // tasks submitted to the front of a strand run ahead of the others, but in the order they were submitted
+        std::atomic< bool > t_release( false );
+        std::mutex t_mutex;
+        std::vector< unsigned > t_order;
+        std::atomic< unsigned > t_done( 0 );
+        t_pool.submit( "s", [&](){ while( ! t_release.load() ) std::this_thread::sleep_for( std::chrono::milliseconds(1) ); ++t_done; } );
+        for( unsigned i_task = 0; i_task < 2; ++i_task )
+        {
+            t_pool.submit( "s", [&, i_task](){ std::unique_lock< std::mutex > t_lock( t_mutex ); t_order.push_back( 10 + i_task ); ++t_done; } );
+        }
+        for( unsigned i_task = 0; i_task < 3; ++i_task )
+        {
+            t_pool.submit( "s", [&, i_task](){ std::unique_lock< std::mutex > t_lock( t_mutex ); t_order.push_back( i_task ); ++t_done; }, true );
+        }
+        t_release = true;
+
+        while( t_done.load() < 6 ) std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+        REQUIRE( t_order == std::vector< unsigned >{ 0, 1, 2, 10, 11 } );
+    }
+
+    SECTION( "drain" )
+    {
+        // drain() returns once every submitted task has run
+        std::atomic< unsigned > t_done( 0 );
+        for( unsigned i_task = 0; i_task < 10; ++i_task )
+        {
+            t_pool.submit( "d", [&](){ std::this_thread::sleep_for( std::chrono::milliseconds(2) ); ++t_done; } );
+        }
+        REQUIRE( t_pool.drain( 5000 ) );
+        REQUIRE( t_done.load() == 10 );
+
+        // or when the timeout is reached
+        std::atomic< bool > t_release( false );
+        t_pool.submit( "d", [&](){ while( ! t_release.load() ) std::this_thread::sleep_for( std::chrono::milliseconds(1) ); } );
+        REQUIRE_FALSE( t_pool.drain( 20 ) );
+        t_release = true;
+        REQUIRE( t_pool.drain( 5000 ) );
+    }
+
+    t_pool.stop();
+    REQUIRE( t_pool.n_threads() == 0 );
+}